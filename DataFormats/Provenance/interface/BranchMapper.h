@@ -41,8 +41,10 @@ namespace edm {
     void mergeMappers(boost::shared_ptr<BranchMapper> other);
 
     void reset();
-  private:
+
+    ///reads the provenance now instead of on first use, e.g. before the mapper is used from several threads
     void readProvenance() const;
+  private:
 
     typedef std::set<ProductProvenance> eiSet;
 
@@ -41,6 +41,12 @@ namespace edm {
                       std::string const& modLabel,
                       ProcessConfiguration const* procConfig);
 
+    ModuleDescription(ParameterSetID const& pid,
+                      std::string const& modName,
+                      std::string const& modLabel,
+                      ProcessConfiguration const* procConfig,
+                      unsigned int modID);
+
     ~ModuleDescription();
 
     void write(std::ostream& os) const;
@@ -55,6 +61,13 @@ namespace edm {
     std::string const& passID() const;
     ParameterSetID const& mainParameterSetID() const;
 
+    ///unique within the job for modules made by the framework, which asks getUniqueID for it,
+    /// invalidID() otherwise. Meant for Services to index what they keep for each module.
+    unsigned int id() const {return id_;}
+
+    static unsigned int getUniqueID();
+    static unsigned int invalidID() {return static_cast<unsigned int>(-1);}
+
     // compiler-written copy c'tor, assignment, and d'tor are correct.
 
     bool operator<(ModuleDescription const& rh) const;
@@ -77,6 +90,9 @@ namespace edm {
 
     // The process configuration.
     ProcessConfiguration const* processConfigurationPtr_;
+
+    // Transient, see id()
+    unsigned int id_;
   };
 
   inline
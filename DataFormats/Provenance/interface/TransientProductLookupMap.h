@@ -21,6 +21,10 @@
  The 'bool' value 'isFirst' in ProductLookupIndex is set to 'true' if this is the first ProductLookupIndex with the value
  (TypeInBranchType, module label, product instance label).  That is it is the first one in the group where you ignore the 
  process name.
+
+ The ranges for a TypeInBranchType and for a (TypeInBranchType, module label, product instance label) are found
+ through open addressing hash tables filled by fillFrom, so a lookup does not depend on the number of branches.
+ Reordering for a new process history only sorts within a group, so the tables stay valid.
 */
 //
 // Original Author:  Chris Jones
@@ -28,7 +32,9 @@
 //
 
 // system include files
+#include <cstddef>
 #include <map>
+#include <string>
 #include <vector>
 
 // user include files
@@ -68,7 +74,8 @@ namespace edm {
       std::pair<const_iterator, const_iterator> equal_range(TypeInBranchType const&) const;
       
       ///returns a pair of iterators that define the range for items matching
-      ///the TypeInBranchType, the module label, and the product instance name
+      ///the TypeInBranchType, the module label, and the product instance name,
+      ///that is one group of items which only differ by process name
       std::pair<const_iterator, const_iterator> equal_range(TypeInBranchType const&,
 							    std::string const&,
 							    std::string const&) const;
@@ -89,8 +96,26 @@ namespace edm {
       int fillCount() const {return fillCount_;}
 
    private:
+      struct HashSlot {
+         std::size_t hash_;
+         //index into branchLookup_
+         unsigned int type_;
+         //range in productLookupIndexList_, end_ is 0 for an empty slot
+         unsigned int begin_;
+         unsigned int end_;
+      };
+      typedef std::vector<HashSlot> HashTable;
+
+      void fillHashTables();
+      void insert(HashTable& ioTable, HashSlot const& iSlot) const;
+      std::pair<const_iterator, const_iterator> range(HashSlot const& iSlot) const;
+
       // ---------- member data --------------------------------
       TypeInBranchTypeLookup branchLookup_;
+      //finds the range for a TypeInBranchType
+      HashTable typeTable_;
+      //finds the range for a TypeInBranchType, module label and product instance name
+      HashTable labelTable_;
       ProductLookupIndexList productLookupIndexList_;
       std::vector<ProcessHistoryID> historyIDsForBranchType_;
       std::vector<std::vector<std::string> > processNameOrderingForBranchType_;
@@ -1,5 +1,6 @@
 #include "DataFormats/Provenance/interface/BranchMapper.h"
 #include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 
 #include <cassert>
 #include <iostream>
@@ -29,6 +30,7 @@ namespace edm {
   void
   BranchMapper::readProvenance() const {
     if(delayedRead_ && provenanceReader_) {
+      boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
       provenanceReader_->readProvenance(*this);
       delayedRead_ = false; // only read once
     }
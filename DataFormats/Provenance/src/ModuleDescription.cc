@@ -1,5 +1,6 @@
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
 
+#include <atomic>
 #include <ostream>
 #include <sstream>
 
@@ -13,7 +14,8 @@ namespace edm {
     parameterSetID_(),
     moduleName_(),
     moduleLabel_(),
-    processConfigurationPtr_(0) {}
+    processConfigurationPtr_(0),
+    id_(invalidID()) {}
 
   ModuleDescription::ModuleDescription(
 		ParameterSetID const& pid,
@@ -22,7 +24,8 @@ namespace edm {
 			parameterSetID_(pid),
 			moduleName_(modName),
 			moduleLabel_(modLabel),
-			processConfigurationPtr_(0) {}
+			processConfigurationPtr_(0),
+			id_(invalidID()) {}
 
   ModuleDescription::ModuleDescription(
 		ParameterSetID const& pid,
@@ -32,7 +35,8 @@ namespace edm {
 			parameterSetID_(pid),
 			moduleName_(modName),
 			moduleLabel_(modLabel),
-			processConfigurationPtr_(procConfig) {}
+			processConfigurationPtr_(procConfig),
+			id_(invalidID()) {}
 
   ModuleDescription::ModuleDescription(
 		std::string const& modName,
@@ -40,7 +44,8 @@ namespace edm {
 			parameterSetID_(),
 			moduleName_(modName),
 			moduleLabel_(modLabel),
-			processConfigurationPtr_(0) {}
+			processConfigurationPtr_(0),
+			id_(invalidID()) {}
 
   ModuleDescription::ModuleDescription(
 		std::string const& modName,
@@ -49,7 +54,20 @@ namespace edm {
 			parameterSetID_(),
 			moduleName_(modName),
 			moduleLabel_(modLabel),
-			processConfigurationPtr_(procConfig) {}
+			processConfigurationPtr_(procConfig),
+			id_(invalidID()) {}
+
+  ModuleDescription::ModuleDescription(
+		ParameterSetID const& pid,
+		std::string const& modName,
+		std::string const& modLabel,
+		ProcessConfiguration const* procConfig,
+		unsigned int modID) :
+			parameterSetID_(pid),
+			moduleName_(modName),
+			moduleLabel_(modLabel),
+			processConfigurationPtr_(procConfig),
+			id_(modID) {}
 
   ModuleDescription::~ModuleDescription() {}
 
@@ -83,6 +101,12 @@ namespace edm {
     return processConfiguration().parameterSetID();
   }
 
+  unsigned int
+  ModuleDescription::getUniqueID() {
+    static std::atomic<unsigned int> s_id(0);
+    return s_id++;
+  }
+
   bool
   ModuleDescription::operator<(ModuleDescription const& rh) const {
     if (moduleLabel() < rh.moduleLabel()) return true;
@@ -4,7 +4,8 @@
 // Class  :     TransientProductLookupMap
 //
 // Implementation:
-//     <Notes on implementation>
+//     The hash tables use linear probing and are kept at most half full. A slot
+//     holds the full hash so most mismatches are rejected without comparing strings.
 //
 // Original Author:  Chris Jones
 //         Created:  Fri May  1 12:17:12 CDT 2009
@@ -12,6 +13,7 @@
 
 // system include files
 #include <algorithm>
+#include <functional>
 
 // user include files
 #include "DataFormats/Provenance/interface/TransientProductLookupMap.h"
@@ -59,6 +61,8 @@ namespace edm {
   //
   TransientProductLookupMap::TransientProductLookupMap() :
       branchLookup_(),
+      typeTable_(),
+      labelTable_(),
       productLookupIndexList_(),
       historyIDsForBranchType_(static_cast<unsigned int>(NumBranchTypes), ProcessHistoryID()),
       processNameOrderingForBranchType_(static_cast<unsigned int>(NumBranchTypes), std::vector<std::string>()),
@@ -75,6 +79,8 @@ namespace edm {
   void
   TransientProductLookupMap::reset() {
       branchLookup_.clear();
+      typeTable_.clear();
+      labelTable_.clear();
       productLookupIndexList_.clear();
       for (unsigned int i = 0; i < static_cast<unsigned int>(NumBranchTypes); ++i) {
         historyIDsForBranchType_[i].reset();
@@ -98,34 +104,31 @@ namespace edm {
   // member functions
   //
   namespace  {
+     std::size_t combineHash(std::size_t iSeed, std::size_t iValue) {
+        return iSeed ^ (iValue + 0x9e3779b9 + (iSeed << 6) + (iSeed >> 2));
+     }
 
-     struct CompareModuleLabelAndProductInstanceName {
-        typedef std::pair<std::string const*, std::string const*> StringPtrPair;
-        bool operator()(StringPtrPair const& iLHS, StringPtrPair const& iRHS) const {
-           int c = iLHS.first->compare(*iRHS.first);
-           if (c < 0) return true;
-           if (c > 0) return false;
-           return(*iLHS.second < *iRHS.second);
-        }
-        bool operator()(ProductLookupIndex const& iLHS, StringPtrPair const& iRHS) const {
-           int c = iLHS.branchDescription()->moduleLabel().compare(*iRHS.first);
-           if (c < 0) return true;
-           if (c > 0) return false;
-           return(iLHS.branchDescription()->productInstanceName() < *iRHS.second);
-        }
-        bool operator()(StringPtrPair const& iLHS, ProductLookupIndex const& iRHS) const {
-           int c = iLHS.first->compare(iRHS.branchDescription()->moduleLabel());
-           if (c < 0) return true;
-           if (c > 0) return false;
-           return(*iLHS.second < iRHS.branchDescription()->productInstanceName());
-        }
-        bool operator()(ProductLookupIndex const& iLHS, ProductLookupIndex const& iRHS) const {
-           int c = iLHS.branchDescription()->moduleLabel().compare(iRHS.branchDescription()->moduleLabel());
-           if (c < 0) return true;
-           if (c > 0) return false;
-           return(iLHS.branchDescription()->productInstanceName() < iRHS.branchDescription()->productInstanceName());
+     std::size_t hashType(TypeInBranchType const& iKey) {
+        return combineHash(iKey.typeID().typeInfo().hash_code(), static_cast<std::size_t>(iKey.branchType()));
+     }
+
+     std::size_t hashLabels(std::size_t iTypeHash, std::string const& iModuleLabel, std::string const& iProductInstanceName) {
+        std::hash<std::string> hasher;
+        return combineHash(combineHash(iTypeHash, hasher(iModuleLabel)), hasher(iProductInstanceName));
+     }
+
+     bool sameType(TypeInBranchType const& iLHS, TypeInBranchType const& iRHS) {
+        return iLHS.branchType() == iRHS.branchType() && iLHS.typeID() == iRHS.typeID();
+     }
+
+     //a power of 2 so at most half of the slots are used
+     std::size_t hashTableSize(std::size_t iNEntries) {
+        std::size_t size = 8;
+        while(size < 2 * iNEntries) {
+           size <<= 1;
         }
-     };
+        return size;
+     }
 
      struct BranchTypeOnlyCompare {
         bool operator()(std::pair<TypeInBranchType, BranchDescriptionIndex> const& iLHS, std::pair<TypeInBranchType, BranchDescriptionIndex> const& iRHS) const {
@@ -365,56 +368,98 @@ namespace edm {
 
      //Now that we know all the IDs time to set the values
      fillInProcessIndexes(productLookupIndexList_.begin(), productLookupIndexList_.end(), processNameOrderingForBranchType_.front());
+
+     fillHashTables();
+  }
+
+  void
+  TransientProductLookupMap::fillHashTables() {
+     unsigned int nGroups = 0;
+     for(ProductLookupIndexList::const_iterator it = productLookupIndexList_.begin(), itEnd = productLookupIndexList_.end();
+         it != itEnd;
+         ++it) {
+        if(it->isFirst()) {
+           ++nGroups;
+        }
+     }
+     typeTable_.assign(hashTableSize(branchLookup_.size()), HashSlot());
+     labelTable_.assign(hashTableSize(nGroups), HashSlot());
+
+     unsigned int const nTypes = branchLookup_.size();
+     for(unsigned int type = 0; type != nTypes; ++type) {
+        unsigned int const begin = branchLookup_[type].second;
+        unsigned int const end = (type + 1 != nTypes ? branchLookup_[type + 1].second : productLookupIndexList_.size());
+        std::size_t const typeHash = hashType(branchLookup_[type].first);
+        HashSlot const typeSlot = {typeHash, type, begin, end};
+        insert(typeTable_, typeSlot);
+
+        //each group of products only differing by process name gets its own slot
+        for(unsigned int groupBegin = begin; groupBegin != end;) {
+           unsigned int groupEnd = groupBegin + 1;
+           while(groupEnd != end && !productLookupIndexList_[groupEnd].isFirst()) {
+              ++groupEnd;
+           }
+           ConstBranchDescription const* branch = productLookupIndexList_[groupBegin].branchDescription();
+           HashSlot const labelSlot = {hashLabels(typeHash, branch->moduleLabel(), branch->productInstanceName()), type, groupBegin, groupEnd};
+           insert(labelTable_, labelSlot);
+           groupBegin = groupEnd;
+        }
+     }
+  }
+
+  void
+  TransientProductLookupMap::insert(HashTable& ioTable, HashSlot const& iSlot) const {
+     std::size_t const mask = ioTable.size() - 1;
+     std::size_t index = iSlot.hash_ & mask;
+     while(ioTable[index].end_ != 0) {
+        index = (index + 1) & mask;
+     }
+     ioTable[index] = iSlot;
   }
 
   //
   // const member functions
   //
-  namespace {
-     struct CompareFirst {
-        bool operator()(TransientProductLookupMap::TypeInBranchTypeLookup::value_type const& iLHS,
-                        TransientProductLookupMap::TypeInBranchTypeLookup::value_type const& iRHS) const {
-           return iLHS.first < iRHS.first;
-        }
-     };
+  std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator>
+  TransientProductLookupMap::range(HashSlot const& iSlot) const {
+     return std::make_pair(productLookupIndexList_.begin() + iSlot.begin_, productLookupIndexList_.begin() + iSlot.end_);
   }
 
   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator>
   TransientProductLookupMap::equal_range(TypeInBranchType const& iKey) const {
-     TypeInBranchTypeLookup::const_iterator itFind = std::lower_bound(branchLookup_.begin(),
-                                                                      branchLookup_.end(),
-                                                                      std::make_pair(iKey, BranchDescriptionIndex(0)),
-                                                                      CompareFirst());
-     if(itFind == branchLookup_.end() || iKey < itFind->first) {
+     if(typeTable_.empty()) {
         return std::make_pair(productLookupIndexList_.end(), productLookupIndexList_.end());
      }
-     const_iterator itStart = productLookupIndexList_.begin() + itFind->second;
-     const_iterator itEnd = productLookupIndexList_.end();
-     if(++itFind != branchLookup_.end()) {
-        itEnd = productLookupIndexList_.begin() + itFind->second;
+     std::size_t const hash = hashType(iKey);
+     std::size_t const mask = typeTable_.size() - 1;
+     for(std::size_t index = hash & mask; typeTable_[index].end_ != 0; index = (index + 1) & mask) {
+        HashSlot const& slot = typeTable_[index];
+        if(slot.hash_ == hash && sameType(branchLookup_[slot.type_].first, iKey)) {
+           return range(slot);
+        }
      }
-     return std::make_pair(itStart, itEnd);
+     return std::make_pair(productLookupIndexList_.end(), productLookupIndexList_.end());
   }
 
   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator>
   TransientProductLookupMap::equal_range(TypeInBranchType const& iKey,
          std::string const& moduleLabel,
          std::string const& productInstanceName) const {
-     std::pair<const_iterator, const_iterator> itPair = this->equal_range(iKey);
-
-     if (itPair.first == itPair.second) {
-        return itPair;
+     if(labelTable_.empty()) {
+        return std::make_pair(productLookupIndexList_.end(), productLookupIndexList_.end());
      }
-
-     // Advance lower bound only
-     itPair.first = std::lower_bound(itPair.first, itPair.second, std::make_pair(&moduleLabel, &productInstanceName), CompareModuleLabelAndProductInstanceName());
-     // Protect against no match
-     if (!(itPair.first < itPair.second) ||
-         itPair.first->branchDescription()->moduleLabel() != moduleLabel ||
-         itPair.first->branchDescription()->productInstanceName() != productInstanceName) {
-       itPair.second = itPair.first;
+     std::size_t const hash = hashLabels(hashType(iKey), moduleLabel, productInstanceName);
+     std::size_t const mask = labelTable_.size() - 1;
+     for(std::size_t index = hash & mask; labelTable_[index].end_ != 0; index = (index + 1) & mask) {
+        HashSlot const& slot = labelTable_[index];
+        if(slot.hash_ == hash && sameType(branchLookup_[slot.type_].first, iKey)) {
+           ConstBranchDescription const* branch = productLookupIndexList_[slot.begin_].branchDescription();
+           if(branch->moduleLabel() == moduleLabel && branch->productInstanceName() == productInstanceName) {
+              return range(slot);
+           }
+        }
      }
-     return itPair;
+     return std::make_pair(productLookupIndexList_.end(), productLookupIndexList_.end());
   }
 
   //
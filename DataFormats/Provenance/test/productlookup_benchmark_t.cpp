@@ -0,0 +1,232 @@
+// Compares the time to find the products for a type, module label and product instance name
+// in a TransientProductLookupMap with the time taken by the previous implementation, which
+// is kept here as BaselineLookupMap and is filled from the same branches. The registry is
+// about the size of the ones of RECO and AOD files.
+// $Id$
+
+#include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "DataFormats/Provenance/interface/ConstBranchDescription.h"
+#include "DataFormats/Provenance/interface/TransientProductLookupMap.h"
+#include "FWCore/Utilities/interface/TypeWithDict.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <random>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace {
+  template<int N> struct Product {};
+
+  template<int N>
+  struct FillTypes {
+    static void fill(std::vector<std::type_info const*>& oTypes) {
+      FillTypes<N - 1>::fill(oTypes);
+      oTypes.push_back(&typeid(Product<N - 1>));
+    }
+  };
+
+  template<>
+  struct FillTypes<0> {
+    static void fill(std::vector<std::type_info const*>&) {}
+  };
+
+  int const kNTypes = 250;
+  unsigned int const kNLabelsPerType = 20;
+  unsigned int const kNRepeats = 5;
+  unsigned int const kNPasses = 100;
+
+  struct Key {
+    edm::TypeInBranchType type_;
+    std::string const* label_;
+    std::string const* instance_;
+  };
+
+  //The lookup of TransientProductLookupMap before it was hashed, unchanged except for
+  //the parts of fillFrom which only deal with process names.
+  class BaselineLookupMap {
+  public:
+    typedef edm::TransientProductLookupMap::TypeInBranchTypeLookup TypeInBranchTypeLookup;
+    typedef edm::TransientProductLookupMap::ProductLookupIndexList ProductLookupIndexList;
+    typedef ProductLookupIndexList::const_iterator const_iterator;
+
+    void fillFrom(edm::TransientProductLookupMap::FillFromMap const& iMap) {
+      productLookupIndexList_.clear();
+      productLookupIndexList_.reserve(iMap.size());
+      branchLookup_.clear();
+      branchLookup_.reserve(iMap.size()); //this is an upperbound
+
+      edm::TypeInBranchType lastSeen(edm::TypeID(), edm::NumBranchTypes);
+
+      //since the actual strings are stored elsewhere, there is no reason to make a copy
+      static std::string const kEmpty;
+      std::string const* lastSeenModule = &kEmpty;
+      std::string const* lastSeenProductInstance = &kEmpty;
+      for(edm::TransientProductLookupMap::FillFromMap::const_iterator it = iMap.begin(), itEnd = iMap.end();
+          it != itEnd;
+          ++it) {
+        bool isFirst =  ((lastSeen < it->first.first) || (it->first.first < lastSeen));
+        if(isFirst) {
+          lastSeen = it->first.first;
+          branchLookup_.push_back(std::make_pair(lastSeen, edm::BranchDescriptionIndex(productLookupIndexList_.size())));
+        } else {
+          //see if this is the first of a group that only differ by ProcessName
+          isFirst = (*lastSeenModule != it->first.second->moduleLabel() ||
+                     *lastSeenProductInstance != it->first.second->productInstanceName());
+        }
+        productLookupIndexList_.push_back(edm::ProductLookupIndex(it->first.second,
+                                                                  it->second,
+                                                                  0,
+                                                                  isFirst)
+                                          );
+        if(isFirst) {
+          lastSeenModule = &(it->first.second->moduleLabel());
+          lastSeenProductInstance = &(it->first.second->productInstanceName());
+        }
+      }
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(edm::TypeInBranchType const& iKey) const {
+      TypeInBranchTypeLookup::const_iterator itFind = std::lower_bound(branchLookup_.begin(),
+                                                                       branchLookup_.end(),
+                                                                       std::make_pair(iKey, edm::BranchDescriptionIndex(0)),
+                                                                       CompareFirst());
+      if(itFind == branchLookup_.end() || iKey < itFind->first) {
+        return std::make_pair(productLookupIndexList_.end(), productLookupIndexList_.end());
+      }
+      const_iterator itStart = productLookupIndexList_.begin() + itFind->second;
+      const_iterator itEnd = productLookupIndexList_.end();
+      if(++itFind != branchLookup_.end()) {
+        itEnd = productLookupIndexList_.begin() + itFind->second;
+      }
+      return std::make_pair(itStart, itEnd);
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range(edm::TypeInBranchType const& iKey,
+                                                          std::string const& moduleLabel,
+                                                          std::string const& productInstanceName) const {
+      std::pair<const_iterator, const_iterator> itPair = this->equal_range(iKey);
+
+      if (itPair.first == itPair.second) {
+        return itPair;
+      }
+
+      // Advance lower bound only
+      itPair.first = std::lower_bound(itPair.first, itPair.second, std::make_pair(&moduleLabel, &productInstanceName), CompareModuleLabelAndProductInstanceName());
+      // Protect against no match
+      if (!(itPair.first < itPair.second) ||
+          itPair.first->branchDescription()->moduleLabel() != moduleLabel ||
+          itPair.first->branchDescription()->productInstanceName() != productInstanceName) {
+        itPair.second = itPair.first;
+      }
+      return itPair;
+    }
+
+  private:
+    struct CompareFirst {
+      bool operator()(TypeInBranchTypeLookup::value_type const& iLHS,
+                      TypeInBranchTypeLookup::value_type const& iRHS) const {
+        return iLHS.first < iRHS.first;
+      }
+    };
+
+    struct CompareModuleLabelAndProductInstanceName {
+      typedef std::pair<std::string const*, std::string const*> StringPtrPair;
+      bool operator()(edm::ProductLookupIndex const& iLHS, StringPtrPair const& iRHS) const {
+        int c = iLHS.branchDescription()->moduleLabel().compare(*iRHS.first);
+        if (c < 0) return true;
+        if (c > 0) return false;
+        return(iLHS.branchDescription()->productInstanceName() < *iRHS.second);
+      }
+    };
+
+    TypeInBranchTypeLookup branchLookup_;
+    ProductLookupIndexList productLookupIndexList_;
+  };
+
+  template<typename F>
+  double bestTime(std::vector<Key> const& iKeys, F iFind) {
+    double best = 0.;
+    for(unsigned int repeat = 0; repeat != kNRepeats; ++repeat) {
+      unsigned long long found = 0;
+      auto begin = std::chrono::steady_clock::now();
+      for(unsigned int pass = 0; pass != kNPasses; ++pass) {
+        for(auto const& key : iKeys) {
+          found += iFind(key);
+        }
+      }
+      std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+      assert(found == static_cast<unsigned long long>(kNPasses) * iKeys.size());
+      double time = elapsed.count() / (kNPasses * iKeys.size());
+      if(repeat == 0 || time < best) {
+        best = time;
+      }
+    }
+    return best;
+  }
+}
+
+int main() {
+  std::vector<std::type_info const*> types;
+  FillTypes<kNTypes>::fill(types);
+
+  std::vector<std::string> const processes = {"HLT", "RECO"};
+  std::string const emptyInstance;
+
+  edm::ParameterSetID id;
+  std::deque<edm::BranchDescription> branches;
+  std::deque<edm::ConstBranchDescription> constBranches;
+  edm::TransientProductLookupMap::FillFromMap fillFrom;
+  std::vector<Key> keys;
+  edm::ProductTransientIndex index = 0;
+  for(auto type : types) {
+    edm::TypeInBranchType typeInBranchType(edm::TypeID(*type), edm::InEvent);
+    for(unsigned int label = 0; label != kNLabelsPerType; ++label) {
+      //every fourth product was also made by an earlier process
+      unsigned int const nProcesses = (label % 4 == 0 ? 2 : 1);
+      for(unsigned int process = 2 - nProcesses; process != 2; ++process) {
+        branches.push_back(edm::BranchDescription(edm::InEvent, "module" + std::to_string(label), processes[process],
+                                                  "int", "int", "", "", id, edm::TypeWithDict(typeid(int))));
+        constBranches.push_back(edm::ConstBranchDescription(branches.back()));
+        fillFrom.insert(std::make_pair(std::make_pair(typeInBranchType, &constBranches.back()), index++));
+      }
+      Key key = {typeInBranchType, &constBranches.back().moduleLabel(), &emptyInstance};
+      keys.push_back(key);
+    }
+  }
+
+  edm::TransientProductLookupMap lookup;
+  lookup.fillFrom(fillFrom);
+  BaselineLookupMap baseline;
+  baseline.fillFrom(fillFrom);
+
+  //both must find the same products
+  for(auto const& key : keys) {
+    auto range = lookup.equal_range(key.type_, *key.label_, *key.instance_);
+    auto baselineRange = baseline.equal_range(key.type_, *key.label_, *key.instance_);
+    assert(range.first != range.second);
+    assert(range.first->index() == baselineRange.first->index());
+  }
+
+  //look up in a different order than the products are stored
+  std::mt19937 generator(1);
+  std::shuffle(keys.begin(), keys.end(), generator);
+
+  double oldTime = bestTime(keys, [&baseline](Key const& iKey) {
+    auto range = baseline.equal_range(iKey.type_, *iKey.label_, *iKey.instance_);
+    return range.first != range.second ? 1U : 0U;
+  });
+  double newTime = bestTime(keys, [&lookup](Key const& iKey) {
+    auto range = lookup.equal_range(iKey.type_, *iKey.label_, *iKey.instance_);
+    return range.first != range.second ? 1U : 0U;
+  });
+
+  std::cout << "lookup by label in a registry with " << fillFrom.size() << " branches:\n"
+            << "  baseline      " << oldTime << " ns\n"
+            << "  hash table    " << newTime << " ns" << std::endl;
+  return 0;
+}
@@ -0,0 +1,184 @@
+/*
+ *  transientproductlookupmap_t.cc
+ *  CMSSW
+ *
+ */
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "DataFormats/Provenance/interface/BranchDescription.h"
+#include "DataFormats/Provenance/interface/ConstBranchDescription.h"
+#include "DataFormats/Provenance/interface/ProcessConfiguration.h"
+#include "DataFormats/Provenance/interface/ProcessHistory.h"
+#include "DataFormats/Provenance/interface/TransientProductLookupMap.h"
+#include "FWCore/Utilities/interface/TypeWithDict.h"
+
+#include <deque>
+#include <string>
+#include <typeinfo>
+
+using namespace edm;
+
+class testTransientProductLookupMap: public CppUnit::TestFixture
+{
+   CPPUNIT_TEST_SUITE(testTransientProductLookupMap);
+
+   CPPUNIT_TEST(typeTest);
+   CPPUNIT_TEST(labelTest);
+   CPPUNIT_TEST(missTest);
+   CPPUNIT_TEST(processesTest);
+   CPPUNIT_TEST(reorderTest);
+
+   CPPUNIT_TEST_SUITE_END();
+public:
+   void setUp();
+   void tearDown(){}
+
+   void typeTest();
+   void labelTest();
+   void missTest();
+   void processesTest();
+   void reorderTest();
+
+private:
+   void add(std::type_info const& iType, std::string const& iLabel, std::string const& iInstance, std::string const& iProcess);
+
+   std::deque<BranchDescription> branches_;
+   std::deque<ConstBranchDescription> constBranches_;
+   TransientProductLookupMap::FillFromMap fillFrom_;
+   TransientProductLookupMap lookup_;
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testTransientProductLookupMap);
+
+namespace {
+   TypeInBranchType eventType(std::type_info const& iType) {
+      return TypeInBranchType(TypeID(iType), InEvent);
+   }
+}
+
+void testTransientProductLookupMap::add(std::type_info const& iType, std::string const& iLabel, std::string const& iInstance, std::string const& iProcess)
+{
+   branches_.push_back(BranchDescription(InEvent, iLabel, iProcess, "int", "int", iInstance, "", ParameterSetID(), TypeWithDict(typeid(int))));
+   constBranches_.push_back(ConstBranchDescription(branches_.back()));
+   ProductTransientIndex index = fillFrom_.size();
+   fillFrom_.insert(std::make_pair(std::make_pair(eventType(iType), &constBranches_.back()), index));
+}
+
+void testTransientProductLookupMap::setUp()
+{
+   // "b" of int is made by two processes
+   add(typeid(int), "a", "", "HLT");
+   add(typeid(int), "b", "", "HLT");
+   add(typeid(int), "b", "", "RECO");
+   add(typeid(int), "b", "i", "RECO");
+   add(typeid(int), "c", "", "RECO");
+   add(typeid(double), "a", "", "RECO");
+   add(typeid(double), "d", "", "HLT");
+   lookup_.fillFrom(fillFrom_);
+}
+
+void testTransientProductLookupMap::typeTest()
+{
+   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator> range = lookup_.equal_range(eventType(typeid(int)));
+   CPPUNIT_ASSERT(range.second - range.first == 5);
+   CPPUNIT_ASSERT(range.first->isFirst());
+   CPPUNIT_ASSERT(range.first->branchDescription()->moduleLabel() == "a");
+
+   range = lookup_.equal_range(eventType(typeid(double)));
+   CPPUNIT_ASSERT(range.second - range.first == 2);
+   CPPUNIT_ASSERT(range.first->isFirst());
+}
+
+void testTransientProductLookupMap::labelTest()
+{
+   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator> range = lookup_.equal_range(eventType(typeid(int)), "c", "");
+   CPPUNIT_ASSERT(range.second - range.first == 1);
+   CPPUNIT_ASSERT(range.first->branchDescription()->moduleLabel() == "c");
+
+   // the same labels for another type
+   range = lookup_.equal_range(eventType(typeid(double)), "a", "");
+   CPPUNIT_ASSERT(range.second - range.first == 1);
+   CPPUNIT_ASSERT(range.first->branchDescription()->processName() == "RECO");
+
+   range = lookup_.equal_range(eventType(typeid(int)), "b", "i");
+   CPPUNIT_ASSERT(range.second - range.first == 1);
+   CPPUNIT_ASSERT(range.first->branchDescription()->productInstanceName() == "i");
+}
+
+void testTransientProductLookupMap::missTest()
+{
+   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator> range = lookup_.equal_range(eventType(typeid(float)));
+   CPPUNIT_ASSERT(range.first == range.second);
+
+   range = lookup_.equal_range(eventType(typeid(float)), "a", "");
+   CPPUNIT_ASSERT(range.first == range.second);
+
+   // label only used by another type
+   range = lookup_.equal_range(eventType(typeid(int)), "d", "");
+   CPPUNIT_ASSERT(range.first == range.second);
+
+   // instance name not used with that label
+   range = lookup_.equal_range(eventType(typeid(int)), "a", "i");
+   CPPUNIT_ASSERT(range.first == range.second);
+
+   range = lookup_.equal_range(eventType(typeid(int)), "z", "");
+   CPPUNIT_ASSERT(range.first == range.second);
+
+   // same type but another BranchType
+   range = lookup_.equal_range(TypeInBranchType(TypeID(typeid(int)), InRun), "a", "");
+   CPPUNIT_ASSERT(range.first == range.second);
+
+   TransientProductLookupMap empty;
+   range = empty.equal_range(eventType(typeid(int)));
+   CPPUNIT_ASSERT(range.first == empty.end() && range.second == empty.end());
+   range = empty.equal_range(eventType(typeid(int)), "a", "");
+   CPPUNIT_ASSERT(range.first == empty.end() && range.second == empty.end());
+}
+
+void testTransientProductLookupMap::processesTest()
+{
+   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator> range = lookup_.equal_range(eventType(typeid(int)), "b", "");
+   CPPUNIT_ASSERT(range.second - range.first == 2);
+   CPPUNIT_ASSERT(range.first->isFirst());
+   CPPUNIT_ASSERT(!(range.first + 1)->isFirst());
+   for(TransientProductLookupMap::const_iterator it = range.first; it != range.second; ++it) {
+      CPPUNIT_ASSERT(it->branchDescription()->moduleLabel() == "b");
+      CPPUNIT_ASSERT(it->branchDescription()->productInstanceName() == "");
+   }
+   CPPUNIT_ASSERT(range.first->processIndex() != (range.first + 1)->processIndex());
+}
+
+void testTransientProductLookupMap::reorderTest()
+{
+   ProcessHistory history;
+   history.push_back(ProcessConfiguration("HLT", ParameterSetID(), "CMSSW_X", ""));
+   history.push_back(ProcessConfiguration("RECO", ParameterSetID(), "CMSSW_X", ""));
+   int const fillCount = lookup_.fillCount();
+   lookup_.reorderIfNecessary(InEvent, history, "RECO");
+
+   // the newest process comes first in the group
+   std::pair<TransientProductLookupMap::const_iterator, TransientProductLookupMap::const_iterator> range = lookup_.equal_range(eventType(typeid(int)), "b", "");
+   CPPUNIT_ASSERT(lookup_.fillCount() == fillCount + 1);
+   CPPUNIT_ASSERT(range.second - range.first == 2);
+   CPPUNIT_ASSERT(range.first->isFirst());
+   CPPUNIT_ASSERT(range.first->branchDescription()->processName() == "RECO");
+   CPPUNIT_ASSERT(range.first->processIndex() == 0);
+   CPPUNIT_ASSERT(!(range.first + 1)->isFirst());
+   CPPUNIT_ASSERT((range.first + 1)->branchDescription()->processName() == "HLT");
+   CPPUNIT_ASSERT((range.first + 1)->processIndex() == 1);
+
+   // the other groups are where they were
+   range = lookup_.equal_range(eventType(typeid(int)), "a", "");
+   CPPUNIT_ASSERT(range.second - range.first == 1);
+   CPPUNIT_ASSERT(range.first->branchDescription()->moduleLabel() == "a");
+   range = lookup_.equal_range(eventType(typeid(int)), "c", "");
+   CPPUNIT_ASSERT(range.second - range.first == 1);
+   CPPUNIT_ASSERT(range.first->branchDescription()->moduleLabel() == "c");
+   range = lookup_.equal_range(eventType(typeid(double)), "d", "");
+   CPPUNIT_ASSERT(range.second - range.first == 1);
+   CPPUNIT_ASSERT(range.first->branchDescription()->moduleLabel() == "d");
+   range = lookup_.equal_range(eventType(typeid(int)));
+   CPPUNIT_ASSERT(range.second - range.first == 5);
+}
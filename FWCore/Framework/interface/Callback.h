@@ -20,9 +20,11 @@
 //
 
 // system include files
+#include <mutex>
 #include <vector>
 // user include files
 #include "FWCore/Framework/interface/produce_helpers.h"
+#include "FWCore/Framework/interface/CallbackInputs.h"
 
 // forward declarations
 namespace edm {
@@ -56,10 +58,20 @@ namespace edm {
             producer_(iProd), 
             method_(iMethod),
             wasCalledForThisRecord_(false),
-            decorator_(iDec) {}
+            decorator_(iDec),
+            reuseResults_(false),
+            haveResults_(false),
+            inputsFingerprint_(0) {}
          
          
          // ---------- const member functions ---------------------
+         bool reusesResults() const { return reuseResults_; }
+
+         ///identifies the data read by the method the last time it was called
+         unsigned long long inputsFingerprint() const { return inputsFingerprint_; }
+
+         ///true if the method read no EventSetup data the last time it was called, as an ESSource does
+         bool readNoInputs() const { return reuseResults_ && inputs_.empty(); }
          
          // ---------- static member functions --------------------
          
@@ -67,13 +79,37 @@ namespace edm {
          
          
          void operator()(const TRecord& iRecord) { 
+            //the Proxies for the different products of the method can be asked for their data at the same time
+            std::lock_guard<std::mutex> guard(mutex_);
             if(!wasCalledForThisRecord_) {
-               decorator_.pre(iRecord);
-               storeReturnedValues((producer_->*method_)(iRecord));                  
-               wasCalledForThisRecord_ = true;
-               decorator_.post(iRecord);
+               //the results of the last call are still held by the Proxies
+               if(haveResults_ && inputs_.unchanged()) {
+                  wasCalledForThisRecord_ = true;
+                  return;
+               }
+               haveResults_ = false;
+               inputs_.clear();
+               {
+                  CallbackInputs::Recorder recorder(reuseResults_ ? &inputs_ : 0);
+                  decorator_.pre(iRecord);
+                  storeReturnedValues((producer_->*method_)(iRecord));                  
+                  wasCalledForThisRecord_ = true;
+                  decorator_.post(iRecord);
+               }
+               //a method which read no EventSetup data may depend on the IOV itself
+               haveResults_ = reuseResults_ && !inputs_.empty();
+               inputsFingerprint_ = haveResults_ ? inputs_.fingerprint() : 0;
             }
          }
+
+         /**the method is only called again for a new IOV if some of the EventSetup data
+          it read changed. It must not use anything else which changes with the IOV.
+          A method which read no EventSetup data is always called again, its Proxies then
+          tell from the content of its results if they changed.
+          */
+         void setReuseResults(bool iReuse) {
+            reuseResults_ = iReuse;
+         }
          
          template<class DataT>
             void holdOntoPointer(DataT* iData) {
@@ -114,6 +150,11 @@ namespace edm {
          method_type method_;
          bool wasCalledForThisRecord_;
          TDecorator decorator_;
+         std::mutex mutex_;
+         bool reuseResults_;
+         bool haveResults_;
+         CallbackInputs inputs_;
+         unsigned long long inputsFingerprint_;
       };
    }
 }
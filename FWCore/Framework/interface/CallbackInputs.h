@@ -0,0 +1,93 @@
+#ifndef Framework_CallbackInputs_h
+#define Framework_CallbackInputs_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     CallbackInputs
+//
+/**\class CallbackInputs CallbackInputs.h FWCore/Framework/interface/CallbackInputs.h
+
+ Description: The EventSetup data an ESProducer method read the last time it was called
+
+ Usage:
+    A Callback which may reuse its results keeps a CallbackInputs. While the method is
+ called a Recorder is in scope and every DataProxy asked for its data on that thread
+ adds itself and the identifier of its data. When the IOV changes, unchanged() gets
+ the same data again and tells if the Proxies still deliver the same data, in which
+ case calling the method again would make the same results.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <typeinfo>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/DataKey.h"
+
+// forward declarations
+namespace edm {
+   namespace eventsetup {
+      class DataProxy;
+      class EventSetupRecord;
+
+      class CallbackInputs {
+
+      public:
+         CallbackInputs() : inputs_() {}
+
+         class Recorder {
+         public:
+            ///iInputs may be 0 to stop recording for a while
+            explicit Recorder(CallbackInputs* iInputs);
+            ~Recorder();
+         private:
+            Recorder(Recorder const&); // stop default
+            Recorder const& operator=(Recorder const&); // stop default
+            CallbackInputs* previous_;
+         };
+
+         // ---------- const member functions ---------------------
+         ///gets the data again and returns true if none of it changed since it was recorded
+         bool unchanged() const;
+
+         bool empty() const { return inputs_.empty(); }
+
+         ///combines the identifiers of the recorded data, never 0
+         unsigned long long fingerprint() const;
+
+         // ---------- static member functions --------------------
+         ///called by DataProxy::get, does nothing unless a Recorder is in scope on this thread
+         static void record(DataProxy const* iProxy, EventSetupRecord const& iRecord, DataKey const& iKey);
+
+         /**identifies data from their content, as written by ROOT. Gives 0 if the type
+          has no dictionary, so the data can not be told apart from other data.
+          */
+         static unsigned long long payloadFingerprint(std::type_info const& iType, void const* iPayload);
+
+         // ---------- member functions ---------------------------
+         void clear() { inputs_.clear(); }
+
+      private:
+         struct Input {
+            Input(DataProxy const* iProxy, EventSetupRecord const* iRecord, DataKey const& iKey,
+                  unsigned long long iProxiesIdentifier, unsigned long long iDataIdentifier) :
+               proxy_(iProxy), record_(iRecord), key_(iKey),
+               proxiesIdentifier_(iProxiesIdentifier), dataIdentifier_(iDataIdentifier) {}
+            DataProxy const* proxy_;
+            EventSetupRecord const* record_;
+            DataKey key_;
+            unsigned long long proxiesIdentifier_;
+            unsigned long long dataIdentifier_;
+         };
+
+         // ---------- member data --------------------------------
+         std::vector<Input> inputs_;
+      };
+   }
+}
+
+#endif
@@ -24,6 +24,7 @@
 #include <cassert>
 
 // user include files
+#include "FWCore/Framework/interface/CallbackInputs.h"
 #include "FWCore/Framework/interface/DataProxy.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
 
@@ -42,7 +43,8 @@ namespace edm {
          
          CallbackProxy(boost::shared_ptr<CallbackT>& iCallback) :
          data_(),
-         callback_(iCallback) { 
+         callback_(iCallback),
+         payloadFingerprint_(0) { 
             //The callback fills the data directly.  This is done so that the callback does not have to
             //  hold onto a temporary copy of the result of the callback since the callback is allowed
             //  to return multiple items where only one item is needed by this Proxy
@@ -59,13 +61,24 @@ namespace edm {
          const void* getImpl(const EventSetupRecord& iRecord, const DataKey&) {
             assert(iRecord.key() == RecordT::keyForClass());
             (*callback_)(static_cast<const record_type&>(iRecord));
-            return &(*data_);
+            value_type const* data = &(*data_);
+            //like an ESSource, the method may have issued the same payload for the new IOV
+            payloadFingerprint_ = callback_->readNoInputs() ? CallbackInputs::payloadFingerprint(typeid(value_type), data) : 0;
+            return data;
          }
          
          void invalidateCache() {
-            data_ = DataT();
+            //the callback may find that the data need not be made again
+            if(!callback_->reusesResults()) {
+               data_ = DataT();
+            }
             callback_->newRecordComing();
          }
+
+         unsigned long long dataFingerprint() const {
+            //the same inputs or the same payload make the same data, 0 unless the callback reuses its results
+            return callback_->readNoInputs() ? payloadFingerprint_ : callback_->inputsFingerprint();
+         }
       private:
          CallbackProxy(const CallbackProxy&); // stop default
          
@@ -74,6 +87,7 @@ namespace edm {
          // ---------- member data --------------------------------
          DataT data_;
          boost::shared_ptr<CallbackT> callback_;
+         unsigned long long payloadFingerprint_;
       };
       
    }
@@ -19,6 +19,7 @@
 //
 
 // system include files
+#include <cstddef>
 
 // user include files
 #include "FWCore/Framework/interface/DataKeyTags.h"
@@ -67,6 +68,8 @@ class DataKey
       
       bool operator==(const DataKey& iRHS) const;
       bool operator<(const DataKey& iRHS) const;
+      ///combines the type and the name, for use in hash tables
+      std::size_t hash() const;
       
       // ---------- static member functions --------------------
       template<class T>
@@ -93,6 +96,10 @@ class DataKey
       bool ownMemory_;
 };
 
+    struct DataKeyHash {
+      std::size_t operator()(DataKey const& iKey) const { return iKey.hash(); }
+    };
+
     // Free swap function
     inline
     void
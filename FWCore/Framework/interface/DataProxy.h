@@ -12,6 +12,9 @@
  Usage:
     This class defines the interface used to handle retrieving data from an
  EventSetup Record.
+    The data can be requested from several threads at once. Only one of them makes the
+ data, the others wait for it to be made. Each Proxy has its own mutex, so different data
+ of one DataProxyProvider can be made at the same time on different threads.
 
 */
 //
@@ -20,6 +23,8 @@
 //
 
 // system include files
+#include <atomic>
+#include <mutex>
 
 // user include files
 
@@ -42,6 +47,11 @@ namespace edm {
          void doGet(EventSetupRecord const& iRecord, DataKey const& iKey, bool iTransiently) const;
          void const* get(EventSetupRecord const&, DataKey const& iKey, bool iTransiently) const;
 
+         /**identifies the data the Proxy made last. Different data get different identifiers
+          except if the Proxy tells through dataFingerprint() that it made the same data again.
+          */
+         unsigned long long dataIdentifier() const { return dataIdentifier_; }
+
          ///returns the description of the DataProxyProvider which owns this Proxy
          ComponentDescription const* providerDescription() const {
             return description_;
@@ -80,6 +90,12 @@ namespace edm {
           */
          virtual void invalidateTransientCache();
 
+         /** called after getImpl. A Proxy which can tell that it delivers the same data as
+          it did before, e.g. from a checksum of the payload, returns the same non-zero value
+          both times. The default of 0 makes each call to getImpl deliver new data.
+          */
+         virtual unsigned long long dataFingerprint() const;
+
          void clearCacheIsValid();
       private:
          DataProxy(DataProxy const&); // stop default
@@ -89,8 +105,11 @@ namespace edm {
 
          // ---------- member data --------------------------------
          mutable void const* cache_;
-         mutable bool cacheIsValid_;
-         mutable bool nonTransientAccessRequested_;
+         mutable std::atomic<bool> cacheIsValid_;
+         mutable std::atomic<bool> nonTransientAccessRequested_;
+         mutable unsigned long long dataIdentifier_;
+         //held while getImpl is called
+         mutable std::mutex mutex_;
          ComponentDescription const* description_;
       };
    }
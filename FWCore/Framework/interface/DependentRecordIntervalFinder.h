@@ -45,6 +45,9 @@ class DependentRecordIntervalFinder : public EventSetupRecordIntervalFinder
         return !providers_.empty();
       }
 
+      ///the intersections are fixed if the intervals of all the Records we depend on are
+      virtual bool hasFixedIntervals() const;
+
       // ---------- static member functions --------------------
 
       // ---------- member functions ---------------------------
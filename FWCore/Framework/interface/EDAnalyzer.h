@@ -1,6 +1,7 @@
 #ifndef FWCore_Framework_EDAnalyzer_h
 #define FWCore_Framework_EDAnalyzer_h
 
+#include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
 #include "FWCore/ParameterSet/interface/ParameterSetfwd.h"
@@ -11,7 +12,7 @@
 
 namespace edm {
 
-  class EDAnalyzer {
+  class EDAnalyzer : public EDConsumerBase {
   public:
     template <typename T> friend class WorkerT;
     typedef EDAnalyzer ModuleType;
@@ -0,0 +1,80 @@
+#ifndef FWCore_Framework_EDConsumerBase_h
+#define FWCore_Framework_EDConsumerBase_h
+// -*- C++ -*-
+//
+// Package:     FWCore/Framework
+// Class  :     EDConsumerBase
+//
+/**\class EDConsumerBase EDConsumerBase.h "FWCore/Framework/interface/EDConsumerBase.h"
+
+ Description: Allows a module to say which event products it reads
+
+ Usage:
+    In its constructor a module calls 'consumes<T>' with the InputTag of a product it
+ reads and keeps the returned EDGetTokenT<T>. It then uses Event::getByToken instead of
+ Event::getByLabel. The first time a token is used the labels are looked up, as
+ getByLabel does, and the indexes of the matching products are kept. Later gets go
+ directly to those products. The lookup is only done again if the ProductRegistry
+ changes, e.g. when an input file with new products is opened.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <vector>
+
+// user include files
+#include "DataFormats/Common/interface/BasicHandle.h"
+#include "DataFormats/Provenance/interface/ProductTransientIndex.h"
+#include "FWCore/Utilities/interface/EDGetToken.h"
+#include "FWCore/Utilities/interface/InputTag.h"
+#include "FWCore/Utilities/interface/TypeID.h"
+
+// forward declarations
+namespace edm {
+  class Principal;
+  class ProductRegistry;
+
+  class EDConsumerBase
+  {
+
+  public:
+    EDConsumerBase();
+    virtual ~EDConsumerBase();
+
+    // ---------- const member functions ---------------------
+    ///the product iToken stands for, as getByLabel would find it
+    BasicHandle getByToken(EDGetToken iToken, TypeID const& iType, Principal const& iPrincipal) const;
+
+  protected:
+    // ---------- member functions ---------------------------
+    template <typename ProductType>
+    EDGetTokenT<ProductType> consumes(InputTag const& iTag) {
+      return EDGetTokenT<ProductType>(recordConsumes(TypeID(typeid(ProductType)), iTag));
+    }
+
+  private:
+    EDConsumerBase(EDConsumerBase const&); // stop default
+
+    EDConsumerBase const& operator=(EDConsumerBase const&); // stop default
+
+    unsigned int recordConsumes(TypeID const& iType, InputTag const& iTag);
+
+    struct ItemToGet {
+      ItemToGet(TypeID const& iType, InputTag const& iTag);
+      TypeID type_;
+      InputTag tag_;
+      //filled on first use, in the order getByLabel looks at the products
+      mutable std::vector<ProductTransientIndex> indexes_;
+      mutable ProductRegistry const* registry_;
+      mutable int fillCount_;
+    };
+
+    // ---------- member data --------------------------------
+    std::vector<ItemToGet> itemsToGet_;
+  };
+}
+
+#endif
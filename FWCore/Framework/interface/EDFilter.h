@@ -11,6 +11,7 @@ These products should be informational products about the filter decision.
 
 ----------------------------------------------------------------------*/
 
+#include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/ProducerBase.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "FWCore/ParameterSet/interface/ParameterSetfwd.h"
@@ -21,7 +22,7 @@ These products should be informational products about the filter decision.
 
 namespace edm {
 
-  class EDFilter : public ProducerBase {
+  class EDFilter : public ProducerBase, public EDConsumerBase {
   public:
     template <typename T> friend class WorkerT;
     typedef EDFilter ModuleType;
@@ -9,6 +9,7 @@ EDProducts into an Event.
 
 ----------------------------------------------------------------------*/
 
+#include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/ProducerBase.h"
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
@@ -18,7 +19,7 @@ EDProducts into an Event.
 #include <vector>
 
 namespace edm {
-  class EDProducer : public ProducerBase {
+  class EDProducer : public ProducerBase, public EDConsumerBase {
   public:
     template <typename T> friend class WorkerT;
     typedef EDProducer ModuleType;
@@ -0,0 +1,59 @@
+#ifndef FWCore_Framework_ESGetToken_h
+#define FWCore_Framework_ESGetToken_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ESGetToken
+//
+/**\class ESGetTokenT ESGetToken.h FWCore/Framework/interface/ESGetToken.h
+
+ Description: Remembers which Proxy of a Record delivers a data item
+
+ Usage:
+    A module keeps an ESGetTokenT<T> for the label of the data it reads and passes it
+ to the Record instead of the label
+ \code
+    edm::ESHandle<Geometry> geometry;
+    iSetup.get<GeometryRecord>().get(geometryToken_, geometry);
+ \endcode
+ The Proxy is looked up on the first get and again only if the Proxies of the Record
+ change. A token must not be used by several threads at the same time.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <string>
+
+// user include files
+
+// forward declarations
+namespace edm {
+   namespace eventsetup {
+      class DataProxy;
+      class EventSetupRecord;
+   }
+
+   template<typename T>
+   class ESGetTokenT {
+      friend class eventsetup::EventSetupRecord;
+
+   public:
+      ESGetTokenT() : label_(), proxiesIdentifier_(0), proxy_(0) {}
+      explicit ESGetTokenT(std::string const& iLabel) : label_(iLabel), proxiesIdentifier_(0), proxy_(0) {}
+
+      // ---------- const member functions ---------------------
+      std::string const& label() const { return label_; }
+
+   private:
+      // ---------- member data --------------------------------
+      std::string label_;
+      //0 is never used by a Record so the first get always looks the Proxy up
+      mutable unsigned long long proxiesIdentifier_;
+      mutable eventsetup::DataProxy const* proxy_;
+   };
+}
+
+#endif
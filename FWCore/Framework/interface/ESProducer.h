@@ -48,6 +48,14 @@ Example: one algorithm creating two objects
       2) add 'setWhatProduced(this, &<class name>::<method name>);' for each method in the class' constructor
    NOTE: the algorithms can put data into the same record or into different records
 
+  An ESProducer whose methods only depend on the EventSetup data they read can call
+  'reuseResultsIfInputsUnchanged();' before 'setWhatProduced'. The methods are then only called
+  again for a new IOV if some of the data they read changed, e.g. not for conditions which were
+  issued again with a new IOV but the same payload. The methods must not use anything else which
+  changes with the IOV, like the validityInterval() of the Record. A method which read no EventSetup
+  data, like the one of an ESSource, is called again for every IOV. If its results have a dictionary
+  and are written by ROOT to the same bytes as before, the methods reading them are not called again.
+
 Example: two algorithms each creating only one objects
 \code
    class FooBarProd : public edm::eventsetup::ESProducer {
@@ -107,6 +115,11 @@ class ESProducer : public ESProxyFactoryProducer
 
       // ---------- member functions ---------------------------
    protected:
+      ///applies to the methods registered afterwards with setWhatProduced
+      void reuseResultsIfInputsUnchanged(bool iReuse = true) {
+         reuseResults_ = iReuse;
+      }
+
       /** \param iThis the 'this' pointer to an inheriting class instance
          The method determines the Record argument and return value of the 'produce'
          method in order to do the registration with the EventSetup
@@ -165,6 +178,7 @@ class ESProducer : public ESProxyFactoryProducer
                                                                createDecoratorFrom(iThis, 
                                                                                     static_cast<const TRecord*>(0),
                                                                                     iDec)));
+            callback->setReuseResults(reuseResults_);
             registerProducts(callback,
                              static_cast<const typename eventsetup::produce::product_traits<TReturn>::type *>(0),
                              static_cast<const TRecord*>(0),
@@ -229,6 +243,7 @@ class ESProducer : public ESProxyFactoryProducer
       // ---------- member data --------------------------------
       // NOTE: the factories share ownership of the callback
       //std::vector<boost::shared_ptr<CallbackBase> > callbacks_;
+      bool reuseResults_;
       
 };
 }
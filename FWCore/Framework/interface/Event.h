@@ -112,6 +112,11 @@ namespace edm {
     bool
     getByLabel(std::string const& label, std::string const& productInstanceName, Handle<PROD>& result) const;
 
+    ///the token must come from the 'consumes' call of the module being run
+    template<typename PROD>
+    bool
+    getByToken(EDGetTokenT<PROD> token, Handle<PROD>& result) const;
+
     template<typename PROD>
     void
     getManyByType(std::vector<Handle<PROD> >& results) const;
@@ -173,6 +178,8 @@ namespace edm {
     ProductID
     makeProductID(ConstBranchDescription const& desc) const;
 
+    void setConsumer(EDConsumerBase const* iConsumer) {provRecorder_.setConsumer(iConsumer);}
+
     //override used by EventBase class
     virtual BasicHandle getByLabelImpl(std::type_info const& iWrapperType, std::type_info const& iProductType, InputTag const& iTag) const;
 
@@ -186,6 +193,7 @@ namespace edm {
     friend class RawInputSource;
     friend class EDFilter;
     friend class EDProducer;
+    friend class EDAnalyzer;
 
     void commit_(std::vector<BranchID>* previousParentage= 0, ParentageID* previousParentageId = 0);
     void commit_aux(ProductPtrVec& products, bool record_parents, std::vector<BranchID>* previousParentage = 0, ParentageID* previousParentageId = 0);
@@ -339,6 +347,16 @@ namespace edm {
     return ok;
   }
 
+  template<typename PROD>
+  bool
+  Event::getByToken(EDGetTokenT<PROD> token, Handle<PROD>& result) const {
+    bool ok = provRecorder_.getByToken(token, result);
+    if(ok) {
+      addToGotBranchIDs(*result.provenance());
+    }
+    return ok;
+  }
+
   template<typename PROD>
   bool
   Event::getByLabel(std::string const& label, Handle<PROD>& result) const {
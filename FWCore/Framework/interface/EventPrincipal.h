@@ -23,6 +23,7 @@ is the DataBlock.
 #include "boost/scoped_ptr.hpp"
 #include "boost/shared_ptr.hpp"
 
+#include <condition_variable>
 #include <map>
 #include <memory>
 #include <string>
@@ -61,6 +62,14 @@ namespace edm {
 
     void clearEventPrincipal();
 
+    // Read all the products and their provenance from the input now.
+    // Afterwards the EventPrincipal no longer depends on where the input
+    // is positioned so the input can go on to read the next event.
+    // Every product which was not dropped on input is read, whether or
+    // not a module asks for it, so jobs needing only some of the products
+    // should drop the others with the 'inputCommands' of the source.
+    void readImmediate();
+
     LuminosityBlockPrincipal const& luminosityBlockPrincipal() const {
       return *luminosityBlockPrincipal_;
     }
@@ -152,6 +161,12 @@ namespace edm {
 
     BranchID pidToBid(ProductID const& pid) const;
 
+    // Refills productIDToHolderIndex_ if the BranchIDLists or the ProductRegistry changed,
+    // which only happens when an input file is opened.
+    void updateProductIDToHolderIndex();
+
+    ProductTransientIndex productIDToHolderIndex(ProductID const& pid) const;
+
     virtual bool unscheduledFill(std::string const& moduleLabel) const;
 
     virtual void resolveProduct_(ProductHolderBase const& phb, bool fillOnDemand) const;
@@ -168,8 +183,6 @@ namespace edm {
     // Handler for unscheduled modules
     boost::shared_ptr<UnscheduledHandler> unscheduledHandler_;
 
-    mutable std::vector<std::string> moduleLabelsRunning_;
-
     boost::shared_ptr<EventSelectionIDVector> eventSelectionIDs_;
 
     boost::shared_ptr<BranchIDListHelper const> branchIDListHelper_;
@@ -178,6 +191,15 @@ namespace edm {
 
     std::map<BranchListIndex, ProcessIndex> branchListIndexToProcessIndex_;
 
+    // The index of the ProductHolder for each entry of the BranchIDLists. The entries
+    // of BranchIDList i start at branchIDListOffsets_[i].
+    std::vector<unsigned int> branchIDListOffsets_;
+    std::vector<ProductTransientIndex> productIDToHolderIndex_;
+    size_t nProductsInHolderIndex_;
+
+    // Signalled, under the product mutex, each time a product read from the input is put
+    // into its ProductHolder, or its read failed.
+    mutable std::condition_variable_any productRead_;
   };
 
   inline
@@ -6,6 +6,31 @@
 EventProcessor: This defines the 'framework application' object. It is
 configured in the user's main() function, and is set running.
 
+If the untracked uint32 'numberOfStreams' in the "options" PSet is
+greater than 1, up to that many events are processed at the same time,
+each on its own copy of the modules on the trigger paths. The modules
+on EndPaths exist only once and see one event at a time. Runs and
+luminosity blocks are only started or ended once all events in flight
+have finished.
+
+Otherwise, if the untracked uint32 'eventReadAhead' in the "options"
+PSet is greater than 0, the source reads up to that many events ahead
+of the event being processed. The events are processed one at a time
+in the order they were read, so reading and processing overlap while
+the modules see the same sequence of events as without read ahead.
+Runs and luminosity blocks are only started or ended once all events
+which were read have been processed.
+
+A process may have several SubProcesses, each reading the products of
+the process. If the untracked bool 'concurrentSubProcesses' in the
+"options" PSet is true, the SubProcesses of a process are run
+concurrently for an event once the process is done with it. They share
+the products of the parent event, which are read from the input at most
+once, instead of each reading its own copy. The ActivityRegistry signals
+for the events, paths and modules of the SubProcesses are then emitted
+from several threads at the same time, as with more than one event
+stream; see EventStreams.h for which services cope with that.
+
 ----------------------------------------------------------------------*/
 
 #include "DataFormats/Provenance/interface/ProcessHistoryID.h"
@@ -44,11 +69,15 @@ namespace edm {
   class ActionTable;
   class BranchIDListHelper;
   class EDLooperBase;
+  class EventStreams;
   class HistoryAppender;
   class ProcessDesc;
+  class SharedMemoryArena;
   class SubProcess;
   namespace eventsetup {
+    class DataKey;
     class EventSetupProvider;
+    class EventSetupRecord;
     class EventSetupsController;
   }
 
@@ -310,10 +339,33 @@ namespace edm {
     static void asyncRun(EventProcessor*);
 
     bool hasSubProcess() const {
-      return subProcess_.get() != 0;
+      return !subProcesses_.empty();
     }
 
     void possiblyContinueAfterForkChildFailure();
+
+    void prefetchEventSetup(EventSetup const& es, char const* iCategory);
+    void prefetchChangedEventSetupRecords(EventSetup const& es);
+    void fillDataKeysToPrefetch(eventsetup::EventSetupRecord const& iRecord,
+                                std::vector<eventsetup::DataKey>& oDataKeys,
+                                char const* iCategory) const;
+
+    void setupEventStreams(ParameterSet const& unreducedParameterSet,
+                           ParameterSet const* subProcessParameterSet,
+                           ProductRegistry::ProductList const& inputProducts);
+
+    void setupEventReadAhead(unsigned int iReadAhead);
+
+    bool hasEventStreams() const {
+      return eventStreams_.get() != 0;
+    }
+
+    Schedule& streamSchedule(unsigned int iStream) {
+      return (iStream == 0 || streamSchedules_.empty()) ? *schedule_ : *streamSchedules_[iStream-1];
+    }
+
+    void readAndProcessEventOnStream();
+    void startEventOnStream();
     //------------------------------------------------------------------
     //
     // Data members below.
@@ -333,7 +385,8 @@ namespace edm {
     boost::shared_ptr<ActionTable const>          act_table_;
     boost::shared_ptr<ProcessConfiguration>       processConfiguration_;
     std::auto_ptr<Schedule>                       schedule_;
-    std::auto_ptr<SubProcess>                     subProcess_;
+    std::vector<std::unique_ptr<SubProcess> >     subProcesses_;
+    bool                                          concurrentSubProcesses_;
     boost::scoped_ptr<HistoryAppender>            historyAppender_;
 
     volatile event_processor::State               state_;
@@ -367,12 +420,39 @@ namespace edm {
 
     int                                           numberOfForkedChildren_;
     unsigned int                                  numberOfSequentialEventsPerChild_;
+    // When set, the blocks of events given to the children shrink towards the end of the job
+    // and follow the speed of each child, numberOfSequentialEventsPerChild_ being the largest.
+    bool                                          adaptiveEventBlocks_;
+    // When set, the parent gives the free pages of its heap back to the system before forking.
+    // It only lowers the memory of the parent, it does not change what the children share.
+    bool                                          trimHeapBeforeFork_;
+    // When set, the parent merges the output files of the children once they all succeeded.
+    bool                                          mergeChildOutputs_;
     bool                                          setCpuAffinity_;
     bool                                          continueAfterChildFailure_;
     
     typedef std::set<std::pair<std::string, std::string> > ExcludedData;
     typedef std::map<std::string, ExcludedData> ExcludedDataMap;
     ExcludedDataMap                               eventSetupDataToExcludeFromPrefetching_;
+    // Size in MB of the memory in which the forked children share the EventSetup data
+    // made through makeForkSharedESData, 0 if they do not share it.
+    unsigned int                                  eventSetupSharedMemorySize_;
+    boost::scoped_ptr<SharedMemoryArena>          eventSetupSharedMemory_;
+
+    // When set, the data of the Records which got a new IOV are made concurrently
+    // as soon as the IOV changes instead of when a module first asks for them.
+    bool                                          prefetchEventSetupOnNewIOV_;
+    std::map<eventsetup::EventSetupRecord const*, unsigned long long> prefetchedCacheIdentifiers_;
+
+    // Only used when more than one event is processed concurrently or events are read ahead.
+    // Stream 0 uses schedule_, stream i uses streamSchedules_[i-1]. When events are read
+    // ahead there are no streamSchedules_ and every stream uses schedule_.
+    unsigned int                                  numberOfStreams_;
+    std::vector<boost::shared_ptr<Schedule> >     streamSchedules_;
+    std::vector<boost::shared_ptr<ProductRegistry> > streamRegistries_;
+    std::vector<boost::shared_ptr<BranchIDListHelper> > streamBranchIDListHelpers_;
+    boost::scoped_ptr<EventStreams>               eventStreams_;
+    boost::mutex                                  endPathMutex_;
     friend class event_processor::StateSentry;
   }; // class EventProcessor
 
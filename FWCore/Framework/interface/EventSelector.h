@@ -18,9 +18,11 @@
 #include "DataFormats/Common/interface/HLTPathStatus.h"
 #include "DataFormats/Common/interface/TriggerResults.h"
 #include "DataFormats/Provenance/interface/ParameterSetID.h"
+#include "FWCore/Utilities/interface/typedefs.h"
 
 #include "boost/shared_ptr.hpp"
 
+#include <map>
 #include <vector>
 #include <string>
 
@@ -87,6 +89,39 @@ namespace edm
 
     typedef std::vector<BitInfo> Bits;
 
+    // The selection compiled for the trigger results packed 2 bits per path,
+    // 32 paths per word, in the same order as the bytes given to acceptEvent.
+    // A word of a mask has the low bit of the field set for each path it selects.
+    typedef std::vector<cms_uint64_t> Mask;
+    struct CompiledSelection
+    {
+      CompiledSelection() : absolutePass_(), absoluteFail_(), conditionalPass_(),
+        conditionalFail_(), exception_(), mustFail_(), mustFailNoex_() { }
+
+      Mask absolutePass_;
+      Mask absoluteFail_;
+      Mask conditionalPass_;
+      Mask conditionalFail_;
+      Mask exception_;
+      std::vector<Mask> mustFail_;
+      std::vector<Mask> mustFailNoex_;
+    };
+
+    // What init makes for the trigger names of a previous process, kept
+    // for each ParameterSetID of those names
+    struct Criteria
+    {
+      bool accept_all_;
+      Bits absolute_acceptors_;
+      Bits conditional_acceptors_;
+      Bits exception_acceptors_;
+      std::vector<Bits> all_must_fail_;
+      std::vector<Bits> all_must_fail_noex_;
+      int nTriggerNames_;
+      bool notStarPresent_;
+      CompiledSelection compiled_;
+    };
+
     bool accept_all_;
     Bits absolute_acceptors_;					// change 3
     Bits conditional_acceptors_;				// change 3
@@ -103,17 +138,20 @@ namespace edm
     int nTriggerNames_;
     bool notStarPresent_;
 
-    bool acceptTriggerPath(HLTPathStatus const&, BitInfo const&) const;
+    CompiledSelection compiled_;
+    std::map<ParameterSetID, Criteria> criteriaCache_;
 
-    bool acceptOneBit (Bits const & b, 
-    		       HLTGlobalStatus const & tr, 
-    		       hlt::HLTState const & s = hlt::Ready) const;
-    bool acceptAllBits (Bits const & b, 
-    		        HLTGlobalStatus const & tr) const;
+    void compile();
+    void saveCriteria(Criteria& oCriteria) const;
+    void restoreCriteria(Criteria const& iCriteria);
+
+    bool acceptTriggerPath(HLTPathStatus const&, BitInfo const&) const;
 
     bool containsExceptions(HLTGlobalStatus const & tr) const;
     
     bool selectionDecision(HLTGlobalStatus const & tr) const;
+    bool selectionDecision(cms_uint64_t const* packedResults,
+                           unsigned int nWords) const;
     
     static std::string glob2reg(std::string const& s);
     static std::vector< Strings::const_iterator > 
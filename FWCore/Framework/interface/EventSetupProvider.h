@@ -63,11 +63,20 @@ class EventSetupProvider {
       // ---------- const member functions ---------------------
       std::set<ComponentDescription> proxyProviderDescriptions() const;
 
+      ///returns the Records the Record with key iKey depends on
+      std::set<EventSetupRecordKey> dependentRecords(EventSetupRecordKey const& iKey) const;
+
       // ---------- static member functions --------------------
 
       // ---------- member functions ---------------------------
       EventSetup const& eventSetupForInstance(IOVSyncValue const&);
 
+      /**returns true if the EventSetup from the last call to eventSetupForInstance is also
+       the one for iValue: every Record in it is valid for iValue and no missing Record has
+       become valid. Missing Records are looked up with their finders, which must therefore
+       not be used concurrently. */
+      bool presentRecordsAreValidFor(IOVSyncValue const& iValue);
+
       EventSetup const& eventSetup() const {return eventSetup_;}
 
       //called by specializations of EventSetupRecordProviders
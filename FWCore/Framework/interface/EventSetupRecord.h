@@ -50,12 +50,14 @@ using the 'setEventSetup' and 'clearEventSetup' functions.
 
 // user include files
 #include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/ESGetToken.h"
 #include "FWCore/Framework/interface/NoProxyException.h"
 #include "FWCore/Framework/interface/ValidityInterval.h"
 #include "FWCore/Utilities/interface/ESInputTag.h"
 
 // system include files
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 // forward declarations
@@ -116,6 +118,15 @@ namespace edm {
             iHolder = HolderT(value, desc);
          }
 
+         ///the Proxy for the token is only looked up again when the Proxies of the Record change
+         template<typename HolderT>
+         void get(ESGetTokenT<typename HolderT::value_type> const& iToken, HolderT& iHolder) const {
+            typename HolderT::value_type const* value = 0;
+            ComponentDescription const* desc = 0;
+            this->getImplementation(value, iToken, desc, iHolder.transientAccessOnly);
+            iHolder = HolderT(value, desc);
+         }
+
 
 
          ///returns false if no data available for key
@@ -148,6 +159,11 @@ namespace edm {
             return cacheIdentifier_;
          }
 
+         ///unique over all Records, changes whenever a Proxy is added to or removed from this Record
+         unsigned long long proxiesIdentifier() const {
+            return proxiesIdentifier_;
+         }
+
          ///clears the oToFill vector and then fills it with the keys for all registered data keys
          void fillRegisteredDataKeys(std::vector<DataKey>& oToFill) const;
          // ---------- static member functions --------------------
@@ -190,6 +206,10 @@ namespace edm {
          void const* getFromProxy(DataKey const& iKey ,
                                   ComponentDescription const*& iDesc,
                                   bool iTransientAccessOnly) const;
+         void const* getFromProxy(DataProxy const* iProxy,
+                                  DataKey const& iKey ,
+                                  ComponentDescription const*& iDesc,
+                                  bool iTransientAccessOnly) const;
 
          template <typename DataT>
          void getImplementation(DataT const*& iData ,
@@ -207,9 +227,34 @@ namespace edm {
             iData = reinterpret_cast<DataT const*> (pValue);
          }
 
+         template <typename DataT>
+         void getImplementation(DataT const*& iData ,
+                                ESGetTokenT<DataT> const& iToken,
+                                ComponentDescription const*& iDesc,
+                                bool iTransientAccessOnly) const {
+            DataKey dataKey(DataKey::makeTypeTag<DataT>(),
+                            iToken.label().c_str(),
+                            DataKey::kDoNotCopyMemory);
+            if(iToken.proxiesIdentifier_ != proxiesIdentifier_) {
+               iToken.proxy_ = this->find(dataKey);
+               iToken.proxiesIdentifier_ = proxiesIdentifier_;
+            }
+            void const* pValue = this->getFromProxy(iToken.proxy_, dataKey, iDesc, iTransientAccessOnly);
+            if(0 == pValue) {
+               throw NoProxyException<DataT>(this->key(), dataKey);
+            }
+            iData = reinterpret_cast<DataT const*> (pValue);
+         }
+
+         void setNewProxiesIdentifier();
+
          // ---------- member data --------------------------------
          ValidityInterval validity_;
          std::map<DataKey, DataProxy const*> proxies_ ;
+         //the same Proxies as proxies_, used to find them
+         std::unordered_map<DataKey, DataProxy const*, DataKeyHash> proxyIndex_;
+         //unique over all Records, changes whenever a Proxy is added or removed
+         unsigned long long proxiesIdentifier_;
          EventSetup const* eventSetup_;
          unsigned long long cacheIdentifier_;
          mutable bool transientAccessRequested_;
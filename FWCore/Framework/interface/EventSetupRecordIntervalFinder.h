@@ -25,6 +25,7 @@
 
 // user include files
 #include "FWCore/Framework/interface/ValidityInterval.h"
+#include "FWCore/Framework/interface/ValidityIntervalIndex.h"
 #include "FWCore/Framework/interface/EventSetupRecordKey.h"
 #include "FWCore/Framework/interface/ComponentDescription.h"
 
@@ -35,13 +36,19 @@ class EventSetupRecordIntervalFinder
 {
 
    public:
-      EventSetupRecordIntervalFinder() : intervals_() {}
+      EventSetupRecordIntervalFinder() : intervals_(), hasFixedIntervals_(false), indexes_() {}
       virtual ~EventSetupRecordIntervalFinder();
 
       // ---------- const member functions ---------------------
       std::set<eventsetup::EventSetupRecordKey> findingForRecords() const ;
    
       const eventsetup::ComponentDescription& descriptionForFinder() const { return description_;}
+
+      /**true if the Finder finds the same interval for an IOVSyncValue whenever it is asked.
+       The intervals it found are then kept and a later request for an IOVSyncValue within
+       one of them is answered with a binary search instead of a call to setIntervalFor.
+       */
+      virtual bool hasFixedIntervals() const;
       // ---------- static member functions --------------------
 
       // ---------- member functions ---------------------------
@@ -65,6 +72,9 @@ class EventSetupRecordIntervalFinder
          }
       
       void findingRecordWithKey(const eventsetup::EventSetupRecordKey&);
+
+      ///call if the intervals of the Finder do not change during the job, e.g. if they come from the configuration
+      void setHasFixedIntervals() { hasFixedIntervals_ = true; }
       
 private:
       EventSetupRecordIntervalFinder(const EventSetupRecordIntervalFinder&); // stop default
@@ -76,6 +86,9 @@ private:
       // ---------- member data --------------------------------
       typedef  std::map<eventsetup::EventSetupRecordKey,ValidityInterval> Intervals;
       Intervals intervals_;
+      bool hasFixedIntervals_;
+      typedef std::map<eventsetup::EventSetupRecordKey,ValidityIntervalIndex> Indexes;
+      Indexes indexes_;
 
       eventsetup::ComponentDescription description_;
 };
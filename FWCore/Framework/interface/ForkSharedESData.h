@@ -0,0 +1,70 @@
+#ifndef FWCore_Framework_ForkSharedESData_h
+#define FWCore_Framework_ForkSharedESData_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ForkSharedESData
+//
+/**\function makeForkSharedESData ForkSharedESData.h FWCore/Framework/interface/ForkSharedESData.h
+
+ Description: Lets the forked children of a job share the data an ESProducer makes
+
+ Usage:
+    An ESProducer whose data is plain old data can make it through
+ \code
+    boost::shared_ptr<Calibration> produce(CalibrationRecord const& iRecord) {
+       return edm::eventsetup::makeForkSharedESData<Calibration>(iRecord, "", [&](Calibration& oCalib) { ... });
+    }
+ \endcode
+ If the job forks and options.multiProcesses.eventSetupSharedMemorySize is set, the first
+ child to ask for the data of an IOV fills it in the shared memory and the other children
+ use that copy. Otherwise, or if the shared memory is full, the data is made as usual.
+    The producer must keep to the same IOV and label in every child, which is the case
+ as long as it only depends on the IOV of its Record.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <new>
+#include <string>
+#include <type_traits>
+#include "boost/shared_ptr.hpp"
+
+// user include files
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Utilities/interface/do_nothing_deleter.h"
+#include "FWCore/Utilities/interface/SharedMemoryArena.h"
+
+// forward declarations
+namespace edm {
+   namespace eventsetup {
+      class EventSetupRecord;
+
+      ///the key under which the data is shared, the same in all forked children
+      std::string forkSharedESDataKey(EventSetupRecord const& iRecord, DataKey const& iDataKey);
+
+      template<typename T, typename RecordT, typename F>
+      boost::shared_ptr<T> makeForkSharedESData(RecordT const& iRecord, char const* iLabel, F iFill) {
+         static_assert(std::is_pod<T>::value, "only plain old data can be shared between forked processes");
+         SharedMemoryArena* arena = SharedMemoryArena::forkShared();
+         if(arena != 0) {
+            DataKey dataKey(DataKey::makeTypeTag<T>(), iLabel, DataKey::kDoNotCopyMemory);
+            void const* data = arena->findOrMake(forkSharedESDataKey(iRecord, dataKey), sizeof(T), [&iFill](void* iBuffer) {
+               iFill(*(new(iBuffer) T()));
+            });
+            if(data != 0) {
+               //the Record only hands the data out as const
+               return boost::shared_ptr<T>(static_cast<T*>(const_cast<void*>(data)), do_nothing_deleter());
+            }
+         }
+         boost::shared_ptr<T> returnValue(new T());
+         iFill(*returnValue);
+         return returnValue;
+      }
+   }
+}
+
+#endif
@@ -67,6 +67,8 @@ namespace edm {
          int m_parentSocket;
          int m_parentPipe;
          int m_maxFd;
+         //seconds on the monotonic clock when the previous block was received
+         double m_blockReceivedTime;
          unsigned long m_startIndex;
          unsigned long m_numberOfConsecutiveIndices;
          unsigned long m_numberToSkip;
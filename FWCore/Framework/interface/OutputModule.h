@@ -174,6 +174,7 @@ namespace edm {
     void doRespondToCloseOutputFiles(FileBlock const& fb);
     void doPreForkReleaseResources();
     void doPostForkReacquireResources(unsigned int iChildIndex, unsigned int iNumberOfChildren);
+    void doMergeForkedChildrenOutputs(unsigned int iNumberOfChildren);
 
     std::string workerType() const {return "OutputWorker";}
 
@@ -210,6 +211,8 @@ namespace edm {
     virtual void respondToCloseOutputFiles(FileBlock const&) {}
     virtual void preForkReleaseResources() {}
     virtual void postForkReacquireResources(unsigned int /*iChildIndex*/, unsigned int /*iNumberOfChildren*/) {}
+    /// Called in the parent once all forked children ended successfully.
+    virtual void mergeForkedChildrenOutputs(unsigned int /*iNumberOfChildren*/) {}
 
     virtual bool isFileOpen() const { return true; }
 
@@ -37,6 +37,7 @@ pointer to a ProductHolder, when queried.
 
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 #include <vector>
@@ -102,6 +103,20 @@ namespace edm {
     void getManyByType(TypeID const& tid,
                  BasicHandleVec& results) const;
 
+    // Fills oIndexes with the indexes of the products getByLabel would
+    // look at, in the order it looks at them. The indexes stay valid as
+    // long as the fillCount of the product lookup map does not change.
+    void productIndexesByLabel(TypeID const& tid,
+                               std::string const& label,
+                               std::string const& productInstanceName,
+                               std::string const& processName,
+                               std::vector<ProductTransientIndex>& oIndexes) const;
+
+    // Same as getByLabel, for indexes filled by productIndexesByLabel.
+    BasicHandle getByIndexes(TypeID const& tid,
+                             std::vector<ProductTransientIndex> const& indexes,
+                             InputTag const& tag) const;
+
     // Return a BasicHandle to the product which:
     //   1. is a sequence,
     //   2. and has the nested type 'value_type'
@@ -179,6 +194,8 @@ namespace edm {
 
     void putOrMerge(WrapperOwningHolder const& prod, ProductProvenance& prov, ProductHolderBase* productHolder);
 
+    std::recursive_mutex& productMutex() const {return productMutex_;}
+
   private:
     virtual WrapperHolder getIt(ProductID const&) const;
 
@@ -206,6 +223,12 @@ namespace edm {
                       TypeLookup const& typeLookup,
                       BasicHandleVec& results) const;
 
+    ProductData const* findAvailableProduct(ProductTransientIndex index,
+                                            TypeID const& typeID,
+                                            std::string const& moduleLabel,
+                                            std::string const& productInstanceName,
+                                            std::string const& processName) const;
+
     // defaults to no-op unless overridden in derived class.
     virtual void resolveProduct_(ProductHolderBase const&, bool /*fillOnDemand*/) const {}
 
@@ -236,6 +259,11 @@ namespace edm {
     // The Principal does not own this object.
     HistoryAppender* historyAppender_;
 
+    // Guards the state of the ProductHolders, which the trigger paths of an event
+    // may read and change concurrently. It is never held while a module runs.
+    // It is recursive since a DelayedReader may itself look up products.
+    mutable std::recursive_mutex productMutex_;
+
     static const ProcessHistory emptyProcessHistory_;
   };
 
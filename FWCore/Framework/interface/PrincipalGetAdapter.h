@@ -99,9 +99,11 @@ edm::Ref<AppleCollection> ref(refApples, index);
 
 #include "DataFormats/Common/interface/Handle.h"
 
+#include "FWCore/Utilities/interface/EDGetToken.h"
 #include "FWCore/Utilities/interface/InputTag.h"
 
 namespace edm {
+  class EDConsumerBase;
 
   namespace principal_get_adapter_detail {
     struct deleter {
@@ -134,10 +136,18 @@ namespace edm {
     bool 	 
     getByLabel(InputTag const& tag, Handle<PROD>& result) const; 	 
 
+    /// same as above, but using a token from the 'consumes' call of the module
+    template <typename PROD>
+    bool
+    getByToken(EDGetTokenT<PROD> token, Handle<PROD>& result) const;
+
     template <typename PROD>
     void 
     getManyByType(std::vector<Handle<PROD> >& results) const;
 
+    /// the module whose tokens are used by getByToken
+    void setConsumer(EDConsumerBase const* iConsumer) {consumer_ = iConsumer;}
+
     ProcessHistory const&
     processHistory() const;
 
@@ -165,6 +175,9 @@ namespace edm {
     BasicHandle 
     getByLabel_(TypeID const& tid, InputTag const& tag) const;
 
+    BasicHandle
+    getByToken_(TypeID const& tid, EDGetToken token) const;
+
     void 
     getManyByType_(TypeID const& tid, 
 		   BasicHandleVec& results) const;
@@ -202,6 +215,9 @@ namespace edm {
     // "transaction" which the PrincipalGetAdapter represents.
     ModuleDescription const& md_;
 
+    // The module which made the tokens given to getByToken.
+    EDConsumerBase const* consumer_;
+
   };
 
   template <typename PROD>
@@ -299,6 +315,19 @@ namespace edm {
     return true;
   }
 
+  template <typename PROD>
+  inline
+  bool
+  PrincipalGetAdapter::getByToken(EDGetTokenT<PROD> token, Handle<PROD>& result) const {
+    result.clear();
+    BasicHandle bh = this->getByToken_(TypeID(typeid(PROD)), token);
+    convert_handle(bh, result);  // throws on conversion error
+    if (bh.failedToGet()) {
+      return false;
+    }
+    return true;
+  }
+
   template <typename PROD>
   inline
   bool
@@ -155,6 +155,11 @@ namespace edm {
 
     void swap(ProductHolderBase& rhs) {swap_(rhs);}
 
+    // The product is being read from the input by some thread.
+    // Only used while holding the product mutex of the Principal.
+    bool beingRead() const {return beingRead_;}
+    void setBeingRead(bool iBeingRead) const {beingRead_ = iBeingRead;}
+
   private:
     virtual ProductData const& getProductData() const = 0;
     virtual ProductData& getProductData() = 0;
@@ -172,6 +177,8 @@ namespace edm {
     virtual void setProductDeleted_() = 0;
     virtual ConstBranchDescription const& branchDescription_() const = 0;
     virtual void resetBranchDescription_(boost::shared_ptr<ConstBranchDescription> bd) = 0;
+
+    mutable bool beingRead_;
   };
 
   inline
@@ -21,10 +21,54 @@
   If the high-level pset contains an "options" pset, then the
   following optional parameter can be present:
   bool wantSummary = true/false   # default false
+  bool concurrentTriggerPaths = true/false   # default false
+  bool prefetchProducts = true/false   # default false
+  bool deleteEarlyAutomatically = true/false   # default false
 
   wantSummary indicates whether or not the pass/fail/error stats
   for modules and paths should be printed at the end-of-job.
 
+  concurrentTriggerPaths allows trigger paths which do not depend on
+  each other to be run concurrently for an event.  Paths which share
+  a module, or where a module on one path reads data produced by a
+  module on another path, are put into the same group and run serially
+  in configuration order.  What a module reads is taken from its
+  'mightGet' parameter; a module without 'mightGet' is assumed to read
+  everything produced by modules on any trigger path.  The groups are
+  run as tasks of the TaskScheduler service.  Run and luminosity block
+  transitions and endpaths are always run serially.  If a path throws,
+  the trigger bits and counters of the paths after it are put back as
+  they were, so they are the same as in a serial run, but the modules
+  on those paths may already have seen the event.
+
+  prefetchProducts has the products from the input which modules on
+  the trigger paths list in their 'mightGet' parameter read in the
+  background while the trigger paths run.  The products are read in
+  the order the modules are run, so while one module runs the
+  products for the modules after it are being read.  Reading is done
+  by a task of the TaskScheduler service, so this only helps when the
+  job has more than one thread.
+
+  When unscheduled production is allowed, a module which lists in its
+  'mightGet' parameter products made by unscheduled producers has those
+  producers run just before it is run.  Producers which do not read from
+  each other are run concurrently as tasks of the TaskScheduler service.
+  If every module, including the OutputModules through what they keep,
+  declares what it reads, unscheduled producers nobody reads from are
+  not run.
+
+  deleteEarlyAutomatically adds every event product made in this
+  process to the products which may be deleted early, as if they were
+  listed in 'canDeleteEarly'.  A product is then deleted as soon as all
+  the modules which list it in their 'mightGet' parameter have run, or
+  can no longer run for the event, unless an OutputModule keeps it.
+  This is only done if every module has a 'mightGet' parameter, as a
+  module without one may read anything.  Aliased products and the
+  TriggerResults are never deleted early.  Nor are products an
+  edm::Ref, RefProd, RefVector, Ptr, PtrVector or RefToBase held in
+  any event product could point to, since a module reading through
+  the Ref does not list the product it points to in 'mightGet'.
+
   A TriggerResults object will always be inserted into the event
   for any schedule.  The producer of the TriggerResults EDProduct
   is always the first module in the endpath.  The TriggerResultInserter
@@ -70,21 +114,29 @@
 #include "FWCore/Framework/src/Worker.h"
 #include "FWCore/Framework/src/WorkerRegistry.h"
 #include "FWCore/Framework/src/EarlyDeleteHelper.h"
+#include "FWCore/Framework/src/ProductPrefetcher.h"
+#include "FWCore/Framework/src/UnscheduledProducerGraph.h"
 #include "FWCore/MessageLogger/interface/ExceptionMessages.h"
 #include "FWCore/MessageLogger/interface/JobReport.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
 #include "FWCore/Utilities/interface/Algorithms.h"
 #include "FWCore/Utilities/interface/BranchType.h"
 #include "FWCore/Utilities/interface/ConvertException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 
+#include "boost/bind.hpp"
 #include "boost/shared_ptr.hpp"
 
+#include <condition_variable>
+#include <exception>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
+#include <thread>
 #include <vector>
 #include <sstream>
 
@@ -166,6 +218,9 @@ namespace edm {
     void preForkReleaseResources();
     void postForkReacquireResources(unsigned int iChildIndex, unsigned int iNumberOfChildren);
 
+    // Call mergeForkedChildrenOutputs() on all OutputModules
+    void mergeForkedChildrenOutputs(unsigned int iNumberOfChildren);
+
     std::pair<double, double> timeCpuReal() const {
       return std::pair<double, double>(stopwatch_->cpuTime(), stopwatch_->realTime());
     }
@@ -226,6 +281,24 @@ namespace edm {
     /// Returns true if successful.
     bool changeModule(std::string const& iLabel, ParameterSet const& iPSet);
 
+    /// Used when several Schedules process events concurrently. For events
+    /// processOneOccurrence will no longer run the end paths, they must be
+    /// run with processEndPaths. Returns false, and changes nothing, if a
+    /// module is on both a trigger path and an end path.
+    bool runEndPathsSeparately();
+
+    /// Run only the end paths for the event. Requires runEndPathsSeparately.
+    template <typename T>
+    void processEndPaths(typename T::MyPrincipal& principal,
+                         EventSetup const& eventSetup);
+
+    /// Add the event counts of a Schedule made from the same configuration
+    /// to the counts of this one.
+    void addToCounters(Schedule const& other);
+
+    /// Do not print the pass/fail summary at endJob.
+    void disableSummary() { wantSummary_ = false; }
+
   private:
 
     AllWorkers::const_iterator workersBegin() const {
@@ -245,15 +318,21 @@ namespace edm {
     }
 
     void resetAll();
+    void resetTriggerPathWorkers();
 
     template <typename T>
     bool runTriggerPaths(typename T::MyPrincipal&, EventSetup const&);
 
+    template <typename T>
+    void runTriggerPathGroupsConcurrently(typename T::MyPrincipal&, EventSetup const&);
+
     template <typename T>
     void runEndPaths(typename T::MyPrincipal&, EventSetup const&);
 
     void setupOnDemandSystem(EventPrincipal& principal, EventSetup const& es);
 
+    void startPrefetching(EventPrincipal const& principal);
+
     void reportSkipped(EventPrincipal const& ep) const;
     void reportSkipped(LuminosityBlockPrincipal const&) const {}
     void reportSkipped(RunPrincipal const&) const {}
@@ -288,6 +367,13 @@ namespace edm {
     void initializeEarlyDelete(edm::ParameterSet const& opts,
                                edm::ProductRegistry const& preg, 
                                edm::ParameterSet const* subProcPSet);
+    void addAutomaticEarlyDeleteCandidates(edm::ProductRegistry const& preg,
+                                           std::multimap<std::string,Worker*>& branchToReadingWorker) const;
+    void initializeConcurrentPaths(edm::ParameterSet const& opts,
+                                   edm::ProductRegistry const& preg);
+    void initializePrefetching(edm::ParameterSet const& opts,
+                               edm::ProductRegistry const& preg);
+    void initializeUnscheduledGraph();
 
     WorkerRegistry                                worker_reg_;
     ActionTable const*                            act_table_;
@@ -321,12 +407,28 @@ namespace edm {
     // has been marked for early deletion
     std::vector<EarlyDeleteHelper> earlyDeleteHelpers_;
 
+    //Indices into trig_paths_ of the paths which can be run concurrently.
+    // Paths within one group depend on each other and are run serially
+    // in configuration order. Empty unless concurrent running was requested
+    // and there is more than one group.
+    std::vector<std::vector<unsigned int> > concurrentPathGroups_;
+
+    //Reads the products declared by modules on the trigger paths while the paths run
+    ProductPrefetcher        prefetcher_;
+
+    //Filled by runEndPathsSeparately, the workers run only on end paths and all the others
+    bool                     endPathsRunSeparately_;
+    Workers                  endPathWorkers_;
+    Workers                  triggerPathWorkers_;
+
     bool                           wantSummary_;
     int                            total_events_;
     int                            total_passed_;
     RunStopwatch::StopwatchPointer stopwatch_;
 
     boost::shared_ptr<UnscheduledCallProducer> unscheduled_;
+    UnscheduledProducerGraph                   unscheduledGraph_;
+    bool                                       hasSubProcess_;
 
     volatile bool           endpathsAreActive_;
   };
@@ -352,22 +454,39 @@ namespace edm {
 
   class UnscheduledCallProducer : public UnscheduledHandler {
   public:
-    UnscheduledCallProducer() : UnscheduledHandler(), labelToWorkers_() {}
+    UnscheduledCallProducer() : UnscheduledHandler(), labelToWorkers_(), runningMutex_(), moduleFinished_(), waiting_() {}
     void addWorker(Worker* aWorker) {
       assert(0 != aWorker);
-      labelToWorkers_[aWorker->description().moduleLabel()] = aWorker;
+      labelToWorkers_[aWorker->description().moduleLabel()] = UnscheduledWorker(aWorker);
+    }
+
+    std::vector<Worker*> workers() const {
+      std::vector<Worker*> result;
+      result.reserve(labelToWorkers_.size());
+      for(auto const& labelAndWorker : labelToWorkers_) {
+        result.push_back(labelAndWorker.second.worker_);
+      }
+      return result;
+    }
+
+    ///the workers will no longer be run for runs and luminosity blocks
+    void prune(std::vector<Worker*> const& iWorkers) {
+      for(auto worker : iWorkers) {
+        labelToWorkers_[worker->description().moduleLabel()].pruned_ = true;
+      }
     }
 
     template <typename T>
     void runNow(typename T::MyPrincipal& p, EventSetup const& es) {
       //do nothing for event since we will run when requested
       if(!T::isEvent_) {
-        for(std::map<std::string, Worker*>::iterator it = labelToWorkers_.begin(), itEnd=labelToWorkers_.end();
+        for(std::map<std::string, UnscheduledWorker>::iterator it = labelToWorkers_.begin(), itEnd=labelToWorkers_.end();
             it != itEnd;
             ++it) {
+          if(it->second.pruned_) continue;
           CPUTimer timer;
           try {
-            it->second->doWork<T>(p, es, 0, &timer);
+            it->second.worker_->doWork<T>(p, es, 0, &timer);
           }
           catch (cms::Exception & ex) {
 	    std::ostringstream ost;
@@ -390,8 +509,8 @@ namespace edm {
               // It should be impossible to get here ...
               ost << "Calling unknown function";
             }
-            ost << " for unscheduled module " << it->second->description().moduleName()
-                << "/'" << it->second->description().moduleLabel() << "'";
+            ost << " for unscheduled module " << it->second.worker_->description().moduleName()
+                << "/'" << it->second.worker_->description().moduleLabel() << "'";
             ex.addContext(ost.str());
             ost.str("");
             ost << "Processing " << p.id();
@@ -402,23 +521,60 @@ namespace edm {
       }
     }
 
+    virtual void startWaitingFor(std::vector<std::string const*> const& iLabels);
+    virtual void stopWaitingFor(std::vector<std::string const*> const& iLabels);
+
   private:
+    struct UnscheduledWorker {
+      UnscheduledWorker() : worker_(0), runningOn_(), pruned_(false) {}
+      explicit UnscheduledWorker(Worker* iWorker) : worker_(iWorker), runningOn_(), pruned_(false) {}
+      Worker* worker_;
+      //the thread running the module for the event, none if it is not running
+      std::thread::id runningOn_;
+      bool pruned_;
+    };
+
+    //Several threads may ask for the products of the same module at once. The first runs
+    // it and the others wait until it is done, then get the result kept by the Worker. No
+    // lock is held while the module runs as it may itself wait for other modules.
+    class RunningSentry {
+    public:
+      RunningSentry(UnscheduledCallProducer& iProducer, UnscheduledWorker& iWorker) :
+        producer_(iProducer), worker_(iWorker) {
+        producer_.startRunning(worker_);
+      }
+      ~RunningSentry() {
+        producer_.stopRunning(worker_);
+      }
+    private:
+      UnscheduledCallProducer& producer_;
+      UnscheduledWorker& worker_;
+    };
+
+    void startRunning(UnscheduledWorker& iWorker);
+    void stopRunning(UnscheduledWorker& iWorker);
+    bool waitsFor(std::thread::id iThread, std::vector<UnscheduledWorker const*> iWorkers) const;
+
     virtual bool tryToFillImpl(std::string const& moduleLabel,
                                EventPrincipal& event,
                                EventSetup const& eventSetup,
                                CurrentProcessingContext const* iContext) {
-      std::map<std::string, Worker*>::const_iterator itFound =
+      std::map<std::string, UnscheduledWorker>::iterator itFound =
         labelToWorkers_.find(moduleLabel);
       if(itFound != labelToWorkers_.end()) {
+        Worker* worker = itFound->second.worker_;
+        RunningSentry running(*this, itFound->second);
         CPUTimer timer;
         try {
-          itFound->second->doWork<OccurrenceTraits<EventPrincipal, BranchActionBegin> >(event, eventSetup, iContext, &timer);
+          TaskScheduler::isolate([&]() {
+            worker->doWork<OccurrenceTraits<EventPrincipal, BranchActionBegin> >(event, eventSetup, iContext, &timer);
+          });
         }
         catch (cms::Exception & ex) {
 	  std::ostringstream ost;
           ost << "Calling produce method for unscheduled module " 
-              <<  itFound->second->description().moduleName() << "/'"
-              << itFound->second->description().moduleLabel() << "'";
+              <<  worker->description().moduleName() << "/'"
+              << worker->description().moduleLabel() << "'";
           ex.addContext(ost.str());
           throw;
         }
@@ -426,7 +582,14 @@ namespace edm {
       }
       return false;
     }
-    std::map<std::string, Worker*> labelToWorkers_;
+
+    std::map<std::string, UnscheduledWorker> labelToWorkers_;
+
+    //guards the runningOn_ of the workers and waiting_
+    std::mutex runningMutex_;
+    std::condition_variable moduleFinished_;
+    //the unscheduled modules each thread is waiting for, used to find circular dependencies
+    std::map<std::thread::id, std::vector<UnscheduledWorker const*> > waiting_;
   };
 
   void
@@ -441,7 +604,12 @@ namespace edm {
   Schedule::processOneOccurrence(typename T::MyPrincipal& ep,
                                  EventSetup const& es,
                                  bool cleaningUpAfterException) {
-    this->resetAll();
+    bool const endPathsNow = endpathsAreActive_ && !(T::isEvent_ && endPathsRunSeparately_);
+    if (T::isEvent_ && endPathsRunSeparately_) {
+      this->resetTriggerPathWorkers();
+    } else {
+      this->resetAll();
+    }
     state_ = Running;
 
     // A RunStopwatch, but only if we are processing an event.
@@ -450,6 +618,7 @@ namespace edm {
     if (T::isEvent_) {
       ++total_events_;
       setupOnDemandSystem(dynamic_cast<EventPrincipal&>(ep), es);
+      startPrefetching(dynamic_cast<EventPrincipal&>(ep));
     }
     try {
       try {
@@ -471,6 +640,8 @@ namespace edm {
             throw;
           }
         }
+        //nothing after the trigger paths needs the prefetched products
+        prefetcher_.finish();
 
         try {
           CPUTimer timer;
@@ -486,7 +657,7 @@ namespace edm {
           throw;
         }
 
-        if (endpathsAreActive_) runEndPaths<T>(ep, es);
+        if (endPathsNow) runEndPaths<T>(ep, es);
         if(T::isEvent_) resetEarlyDelete();
       }
       catch (cms::Exception& e) { throw; }
@@ -497,6 +668,7 @@ namespace edm {
       catch (...) { convertException::unknownToEDM(); }
     }
     catch(cms::Exception& ex) {
+      prefetcher_.finish();
       if (ex.context().empty()) {
         addContextAndPrintException("Calling function Schedule::processOneOccurrence", ex, cleaningUpAfterException);
       } else {
@@ -509,13 +681,102 @@ namespace edm {
     state_ = Ready;
   }
 
+  template <typename T>
+  void
+  Schedule::processEndPaths(typename T::MyPrincipal& ep,
+                            EventSetup const& es) {
+    assert(endPathsRunSeparately_);
+    for_all(endPathWorkers_, boost::bind(&Worker::reset, _1));
+    endpath_results_->reset();
+    if (!endpathsAreActive_) return;
+    try {
+      try {
+        runEndPaths<T>(ep, es);
+      }
+      catch (cms::Exception& e) { throw; }
+      catch(std::bad_alloc& bda) { convertException::badAllocToEDM(); }
+      catch (std::exception& e) { convertException::stdToEDM(e); }
+      catch(std::string& s) { convertException::stringToEDM(s); }
+      catch(char const* c) { convertException::charPtrToEDM(c); }
+      catch (...) { convertException::unknownToEDM(); }
+    }
+    catch(cms::Exception& ex) {
+      if (ex.context().empty()) {
+        addContextAndPrintException("Calling function Schedule::processEndPaths", ex, false);
+      } else {
+        addContextAndPrintException("", ex, false);
+      }
+      throw;
+    }
+  }
+
   template <typename T>
   bool
   Schedule::runTriggerPaths(typename T::MyPrincipal& ep, EventSetup const& es) {
-    for_all(trig_paths_, ProcessOneOccurrence<T>(ep, es));
+    if (T::isEvent_ && !concurrentPathGroups_.empty()) {
+      runTriggerPathGroupsConcurrently<T>(ep, es);
+    } else {
+      for_all(trig_paths_, ProcessOneOccurrence<T>(ep, es));
+    }
     return results_->accept();
   }
 
+  template <typename T>
+  void
+  Schedule::runTriggerPathGroupsConcurrently(typename T::MyPrincipal& ep, EventSetup const& es) {
+    // Each group stops at its first exception, just as the serial loop
+    // would. Once all groups are done we rethrow the exception from the
+    // path which comes first in the configuration, which is the one the
+    // serial loop would have reported.
+    typedef std::pair<unsigned int, std::exception_ptr> PathException;
+    std::vector<PathException> exceptions(concurrentPathGroups_.size(),
+                                          PathException(trig_paths_.size(), std::exception_ptr()));
+    // char rather than bool so that each task writes its own element
+    std::vector<char> pathsRun(trig_paths_.size(), 0);
+
+    auto runGroup = [this, &ep, &es, &exceptions, &pathsRun](unsigned int iGroup) {
+      ProcessOneOccurrence<T> runPath(ep, es);
+      for(unsigned int pathIndex : concurrentPathGroups_[iGroup]) {
+        try {
+          trig_paths_[pathIndex].saveCounters();
+          pathsRun[pathIndex] = 1;
+          runPath(trig_paths_[pathIndex]);
+        }
+        catch(...) {
+          exceptions[iGroup] = PathException(pathIndex, std::current_exception());
+          return;
+        }
+      }
+    };
+
+    Service<TaskScheduler> scheduler;
+    TaskScheduler::TaskGroup tasks(*scheduler);
+    for(unsigned int iGroup = 1; iGroup < concurrentPathGroups_.size(); ++iGroup) {
+      tasks.run([&runGroup, iGroup]() { runGroup(iGroup); });
+    }
+    runGroup(0);
+    tasks.wait();
+
+    PathException const* first = nullptr;
+    for(auto const& e : exceptions) {
+      if(e.second && (first == nullptr || e.first < first->first)) {
+        first = &e;
+      }
+    }
+    if(first != nullptr) {
+      // The serial loop would have stopped at this path, so undo what the
+      // paths after it did. Going backwards undoes the later paths of a
+      // group first, since they saved the counters of shared workers after
+      // the earlier paths had changed them.
+      for(unsigned int pathIndex = trig_paths_.size(); pathIndex-- > first->first + 1;) {
+        if(pathsRun[pathIndex]) {
+          trig_paths_[pathIndex].undoOccurrence();
+        }
+      }
+      std::rethrow_exception(first->second);
+    }
+  }
+
   template <typename T>
   void
   Schedule::runEndPaths(typename T::MyPrincipal& ep, EventSetup const& es) {
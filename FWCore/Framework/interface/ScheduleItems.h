@@ -36,6 +36,9 @@ namespace edm {
     ServiceToken
     addCPRandTNS(ParameterSet const& parameterSet, ServiceToken const& token);
 
+    ServiceToken
+    addTaskScheduler(ServiceToken const& token);
+
     boost::shared_ptr<CommonParams>
     initMisc(ParameterSet& parameterSet);
 
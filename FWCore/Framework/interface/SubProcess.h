@@ -15,6 +15,7 @@
 
 #include <map>
 #include <memory>
+#include <vector>
 
 namespace edm {
   class BranchIDListHelper;
@@ -71,21 +72,21 @@ namespace edm {
     void closeOutputFiles() {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->closeOutputFiles();
-      if(subProcess_.get()) subProcess_->closeOutputFiles();
+      for(auto& subProcess : subProcesses_) subProcess->closeOutputFiles();
     }
 
     // Call openNewFileIfNeeded() on all OutputModules
     void openNewOutputFilesIfNeeded() {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->openNewOutputFilesIfNeeded();
-      if(subProcess_.get()) subProcess_->openNewOutputFilesIfNeeded();
+      for(auto& subProcess : subProcesses_) subProcess->openNewOutputFilesIfNeeded();
     }
 
     // Call openFiles() on all OutputModules
     void openOutputFiles(FileBlock& fb) {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->openOutputFiles(fb);
-      if(subProcess_.get()) subProcess_->openOutputFiles(fb);
+      for(auto& subProcess : subProcesses_) subProcess->openOutputFiles(fb);
     }
 
     // Call respondToOpenInputFile() on all Modules
@@ -95,39 +96,47 @@ namespace edm {
     void respondToCloseInputFile(FileBlock const& fb) {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->respondToCloseInputFile(fb);
-      if(subProcess_.get()) subProcess_->respondToCloseInputFile(fb);
+      for(auto& subProcess : subProcesses_) subProcess->respondToCloseInputFile(fb);
     }
 
     // Call respondToOpenOutputFiles() on all Modules
     void respondToOpenOutputFiles(FileBlock const& fb) {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->respondToOpenOutputFiles(fb);
-      if(subProcess_.get()) subProcess_->respondToOpenOutputFiles(fb);
+      for(auto& subProcess : subProcesses_) subProcess->respondToOpenOutputFiles(fb);
     }
 
     // Call respondToCloseOutputFiles() on all Modules
     void respondToCloseOutputFiles(FileBlock const& fb) {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->respondToCloseOutputFiles(fb);
-      if(subProcess_.get()) subProcess_->respondToCloseOutputFiles(fb);
+      for(auto& subProcess : subProcesses_) subProcess->respondToCloseOutputFiles(fb);
     }
 
     // Call shouldWeCloseFile() on all OutputModules.
     bool shouldWeCloseOutput() const {
       ServiceRegistry::Operate operate(serviceToken_);
-      return schedule_->shouldWeCloseOutput() || (subProcess_.get() ? subProcess_->shouldWeCloseOutput() : false);
+      if(schedule_->shouldWeCloseOutput()) {
+        return true;
+      }
+      for(auto const& subProcess : subProcesses_) {
+        if(subProcess->shouldWeCloseOutput()) {
+          return true;
+        }
+      }
+      return false;
     }
 
     void preForkReleaseResources() {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->preForkReleaseResources();
-      if(subProcess_.get()) subProcess_->preForkReleaseResources();
+      for(auto& subProcess : subProcesses_) subProcess->preForkReleaseResources();
     }
 
     void postForkReacquireResources(unsigned int iChildIndex, unsigned int iNumberOfChildren) {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->postForkReacquireResources(iChildIndex, iNumberOfChildren);
-      if(subProcess_.get()) subProcess_->postForkReacquireResources(iChildIndex, iNumberOfChildren);
+      for(auto& subProcess : subProcesses_) subProcess->postForkReacquireResources(iChildIndex, iNumberOfChildren);
     }
 
     /// Return a vector allowing const access to all the ModuleDescriptions for this SubProcess
@@ -162,7 +171,7 @@ namespace edm {
     void enableEndPaths(bool active) {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->enableEndPaths(active);
-      if(subProcess_.get()) subProcess_->enableEndPaths(active);
+      for(auto& subProcess : subProcesses_) subProcess->enableEndPaths(active);
     }
 
     /// Return true if end_paths are active, and false if they are inactive.
@@ -179,17 +188,29 @@ namespace edm {
     }
 
     /// Return whether each output module has reached its maximum count.
-    /// If there is a subprocess, get this information from the subprocess.
+    /// If there are subprocesses, get this information from the subprocesses.
     bool terminate() const {
       ServiceRegistry::Operate operate(serviceToken_);
-      return subProcess_.get() ? subProcess_->terminate() : schedule_->terminate();
+      return subProcesses_.empty() ? schedule_->terminate() : terminate(subProcesses_);
     }
 
+    /// Return whether every SubProcess in iSubProcesses has terminated.
+    static bool terminate(std::vector<std::unique_ptr<SubProcess> > const& iSubProcesses);
+
+    /// Process the event in each SubProcess in iSubProcesses. If iConcurrently is set the
+    /// SubProcesses are run concurrently as tasks of the TaskScheduler service. They then
+    /// share the products of the parent event, which must not be changed until they are done,
+    /// and their services see the signals for events, paths and modules from several threads.
+    static void doEvent(std::vector<std::unique_ptr<SubProcess> >& iSubProcesses,
+                        EventPrincipal const& principal,
+                        IOVSyncValue const& ts,
+                        bool iConcurrently);
+
     ///  Clear all the counters in the trigger report.
     void clearCounters() {
       ServiceRegistry::Operate operate(serviceToken_);
       schedule_->clearCounters();
-      if(subProcess_.get()) subProcess_->clearCounters();
+      for(auto& subProcess : subProcesses_) subProcess->clearCounters();
     }
 
   private:
@@ -209,6 +230,9 @@ namespace edm {
     virtual void writeRun(RunPrincipal const&) { throw 0; }
     virtual void writeLuminosityBlock(LuminosityBlockPrincipal const&) { throw 0; }
 
+    void beginEvent(IOVSyncValue const& ts);
+    void processEvent(EventPrincipal const& principal);
+    void readKeptProducts(EventPrincipal const& parentPrincipal) const;
     void propagateProducts(BranchType type, Principal const& parentPrincipal, Principal& principal) const;
     void fixBranchIDListsForEDAliases(std::map<BranchID::value_type, BranchID::value_type> const& droppedBranchIDToKeptBranchID);
 
@@ -224,12 +248,13 @@ namespace edm {
     std::map<ProcessHistoryID, ProcessHistoryID>  parentToChildPhID_;
     boost::scoped_ptr<HistoryAppender>            historyAppender_;
     std::auto_ptr<ESInfo>                         esInfo_;
-    std::auto_ptr<SubProcess>                     subProcess_;
+    std::vector<std::unique_ptr<SubProcess> >     subProcesses_;
+    bool                                          concurrentSubProcesses_;
     bool                                          cleaningUpAfterException_;
     std::unique_ptr<ParameterSet>                 processParameterSet_;
   };
 
   // free function
-  std::auto_ptr<ParameterSet> popSubProcessParameterSet(ParameterSet& parameterSet);
+  std::vector<ParameterSet> popSubProcessVParameterSet(ParameterSet& parameterSet);
 }
 #endif
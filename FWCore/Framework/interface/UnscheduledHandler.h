@@ -13,6 +13,9 @@
     This class is used internally to the Framework for running the unscheduled case.  It is written as a base class
 to keep the EventPrincipal class from having too much 'physical' coupling with the implementation.
 
+    Unscheduled modules for the same event may be run on several threads at once. The current processing context
+and the unscheduled modules being run are therefore kept for each thread.
+
 */
 //
 // Original Author:  Chris Jones
@@ -24,6 +27,7 @@ to keep the EventPrincipal class from having too much 'physical' coupling with t
 // user include files
 #include "FWCore/Framework/interface/Frameworkfwd.h"
 #include <string>
+#include <vector>
 
 // forward declarations
 namespace edm {
@@ -34,7 +38,7 @@ namespace edm {
 
    public:
       friend class UnscheduledHandlerSentry;
-      UnscheduledHandler(): m_setup(0), m_context(0) {}
+      UnscheduledHandler(): m_setup(0) {}
       virtual ~UnscheduledHandler();
 
       // ---------- const member functions ---------------------
@@ -42,13 +46,21 @@ namespace edm {
       // ---------- static member functions --------------------
 
       // ---------- member functions ---------------------------
-      ///returns true if found an EDProducer and ran it
+      ///returns true if found an EDProducer and ran it. Throws if the module is
+      /// already being run for iEvent on this thread, or on another thread which waits for
+      /// this one, i.e. modules depend on each other in a circle.
       bool tryToFill(std::string const& label,
                      EventPrincipal& iEvent);
 
       void setEventSetup(EventSetup const& iSetup) {
          m_setup = &iSetup;
       }
+
+      ///called before this thread waits for other tasks to run the modules iLabels for it and,
+      /// with the same iLabels, once they are done. Used to find circular dependencies which
+      /// go through those tasks.
+      virtual void startWaitingFor(std::vector<std::string const*> const& /*iLabels*/) {}
+      virtual void stopWaitingFor(std::vector<std::string const*> const& /*iLabels*/) {}
    private:
       CurrentProcessingContext const* setCurrentProcessingContext(CurrentProcessingContext const* iContext);
       //void popCurrentProcessingContext();
@@ -63,7 +75,6 @@ namespace edm {
                                  CurrentProcessingContext const*) = 0;
       // ---------- member data --------------------------------
       EventSetup const* m_setup;
-      CurrentProcessingContext const* m_context;
 };
    class UnscheduledHandlerSentry {
    public:
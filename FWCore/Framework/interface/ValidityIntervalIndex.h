@@ -0,0 +1,59 @@
+#ifndef Framework_ValidityIntervalIndex_h
+#define Framework_ValidityIntervalIndex_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ValidityIntervalIndex
+//
+/**\class ValidityIntervalIndex ValidityIntervalIndex.h FWCore/Framework/interface/ValidityIntervalIndex.h
+
+ Description: Sorted ValidityIntervals which can be searched for the one holding an IOVSyncValue
+
+ Usage:
+    Used by EventSetupRecordIntervalFinder to remember the intervals a Finder found if the
+ Finder always finds the same interval for an IOVSyncValue. The intervals must not overlap.
+ Run/lumi/event based intervals and time based intervals are kept apart since they can not
+ be compared with one another.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/interface/ValidityInterval.h"
+
+// forward declarations
+namespace edm {
+   class ValidityIntervalIndex {
+
+   public:
+      ValidityIntervalIndex() : byEventID_(), byTime_() {}
+
+      // ---------- const member functions ---------------------
+      ///returns 0 if no interval holds iTime
+      ValidityInterval const* find(IOVSyncValue const& iTime) const;
+
+      std::size_t size() const { return byEventID_.size() + byTime_.size(); }
+
+      // ---------- member functions ---------------------------
+      ///invalid intervals and intervals with an unknown end are not added
+      void insert(ValidityInterval const& iInterval);
+
+      void clear() {
+         byEventID_.clear();
+         byTime_.clear();
+      }
+
+   private:
+      // ---------- member data --------------------------------
+      //both are sorted by the start of the intervals
+      std::vector<ValidityInterval> byEventID_;
+      std::vector<ValidityInterval> byTime_;
+   };
+}
+
+#endif
@@ -0,0 +1,105 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     CallbackInputs
+//
+// Implementation:
+//     The Recorder in scope is kept per thread since the Records may be prefetched
+//     concurrently. Recorders nest the same way as the ESProducer methods calling
+//     each other through the Records do.
+//
+// $Id$
+//
+
+// system include files
+#include <cstring>
+
+#include "TBufferFile.h"
+#include "TClass.h"
+
+// user include files
+#include "FWCore/Framework/interface/CallbackInputs.h"
+#include "FWCore/Framework/interface/DataProxy.h"
+#include "FWCore/Framework/interface/EventSetupRecord.h"
+#include "FWCore/Utilities/interface/Digest.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
+
+namespace edm {
+   namespace eventsetup {
+      namespace {
+         thread_local CallbackInputs* s_recording = 0;
+      }
+
+      CallbackInputs::Recorder::Recorder(CallbackInputs* iInputs) :
+         previous_(s_recording) {
+         s_recording = iInputs;
+      }
+
+      CallbackInputs::Recorder::~Recorder() {
+         s_recording = previous_;
+      }
+
+      void
+      CallbackInputs::record(DataProxy const* iProxy, EventSetupRecord const& iRecord, DataKey const& iKey) {
+         if(0 == s_recording) {
+            return;
+         }
+         for(auto const& input : s_recording->inputs_) {
+            if(input.proxy_ == iProxy) {
+               return;
+            }
+         }
+         s_recording->inputs_.push_back(Input(iProxy, &iRecord, iKey, iRecord.proxiesIdentifier(), iProxy->dataIdentifier()));
+      }
+
+      bool
+      CallbackInputs::unchanged() const {
+         //what is gotten here is not an input of an ESProducer method which may be running
+         Recorder notRecording(0);
+         for(auto const& input : inputs_) {
+            //a Proxy which was replaced may have been deleted
+            if(input.record_->proxiesIdentifier() != input.proxiesIdentifier_) {
+               return false;
+            }
+            input.proxy_->doGet(*input.record_, input.key_, false);
+            if(input.proxy_->dataIdentifier() != input.dataIdentifier_) {
+               return false;
+            }
+         }
+         return true;
+      }
+
+      unsigned long long
+      CallbackInputs::fingerprint() const {
+         //FNV-1a over the Proxies and the identifiers of their data
+         unsigned long long returnValue = 14695981039346656037ULL;
+         for(auto const& input : inputs_) {
+            returnValue = (returnValue ^ reinterpret_cast<unsigned long long>(input.proxy_)) * 1099511628211ULL;
+            returnValue = (returnValue ^ input.dataIdentifier_) * 1099511628211ULL;
+         }
+         return 0 == returnValue ? 1 : returnValue;
+      }
+
+      unsigned long long
+      CallbackInputs::payloadFingerprint(std::type_info const& iType, void const* iPayload) {
+         if(0 == iPayload) {
+            return 0;
+         }
+         cms::MD5Result digest;
+         {
+            //the streamer infos of ROOT are shared by all threads
+            boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
+            TClass* cls = TClass::GetClass(iType);
+            if(0 == cls || !cls->IsLoaded()) {
+               return 0;
+            }
+            TBufferFile buffer(TBuffer::kWrite);
+            cls->WriteBuffer(buffer, const_cast<void*>(iPayload));
+            digest = cms::Digest(std::string(buffer.Buffer(), buffer.Length())).digest();
+         }
+         unsigned long long returnValue = 0;
+         std::memcpy(&returnValue, digest.bytes, sizeof(returnValue));
+         return 0 == returnValue ? 1 : returnValue;
+      }
+   }
+}
@@ -130,6 +130,17 @@ DataKey::operator==(const DataKey& iRHS) const
             (name_ == iRHS.name_));
 }
 
+std::size_t
+DataKey::hash() const
+{
+   //FNV-1a over the name, the type already has a hash
+   std::size_t value = 14695981039346656037ULL;
+   for(char const* c = name_.value(); *c != '\0'; ++c) {
+      value = (value ^ static_cast<unsigned char>(*c)) * 1099511628211ULL;
+   }
+   return value ^ type_.value().hash_code();
+}
+
 bool
 DataKey::operator<(const DataKey& iRHS) const 
 {
@@ -14,6 +14,7 @@
 
 // user include files
 #include "FWCore/Framework/interface/DataProxy.h"
+#include "FWCore/Framework/interface/CallbackInputs.h"
 #include "FWCore/Framework/interface/ComponentDescription.h"
 #include "FWCore/Framework/interface/MakeDataException.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
@@ -27,6 +28,9 @@ namespace edm {
 //
 // static data member definitions
 //
+//fingerprints have the highest bit cleared so they never equal an identifier from here
+static std::atomic<unsigned long long> s_lastDataIdentifier(1ULL << 63);
+
 static
 const ComponentDescription*
 dummyDescription()
@@ -41,6 +45,7 @@ DataProxy::DataProxy() :
    cache_(0),
    cacheIsValid_(false),
    nonTransientAccessRequested_(false),
+   dataIdentifier_(0),
    description_(dummyDescription())
 {
 }
@@ -95,6 +100,11 @@ void
 DataProxy::invalidateTransientCache() {
    invalidateCache();
 }
+
+unsigned long long
+DataProxy::dataFingerprint() const {
+   return 0;
+}
 //
 // const member functions
 //
@@ -110,7 +120,14 @@ const void*
 DataProxy::get(const EventSetupRecord& iRecord, const DataKey& iKey, bool iTransiently) const
 {
    if(!cacheIsValid()) {
-      cache_ = const_cast<DataProxy*>(this)->getImpl(iRecord, iKey);
+      //cache_ is set before cacheIsValid_ so a thread which sees a valid cache does not need the lock
+      std::lock_guard<std::mutex> guard(mutex_);
+      if(!cacheIsValid()) {
+         cache_ = const_cast<DataProxy*>(this)->getImpl(iRecord, iKey);
+         unsigned long long fingerprint = dataFingerprint() & ~(1ULL << 63);
+         dataIdentifier_ = 0 != fingerprint ? fingerprint : ++s_lastDataIdentifier;
+         setCacheIsValidAndAccessType(iTransiently);
+      }
    }
    //It is safe to always set cache to valid.
    //We need to set the AccessType for each request so this can't be called in the if block above.
@@ -120,6 +137,7 @@ DataProxy::get(const EventSetupRecord& iRecord, const DataKey& iKey, bool iTrans
    if(0 == cache_) {
       throwMakeException(iRecord, iKey);
    }
+   CallbackInputs::record(this, iRecord, iKey);
    return cache_;
 }
 
@@ -72,6 +72,26 @@ DependentRecordIntervalFinder::setAlternateFinder(boost::shared_ptr<EventSetupRe
   alternate_ = iOther;
 }
 
+bool
+DependentRecordIntervalFinder::hasFixedIntervals() const
+{
+   if(providers_.empty() && alternate_.get() == 0) {
+      return false;
+   }
+   if(alternate_.get() != 0 && !alternate_->hasFixedIntervals()) {
+      return false;
+   }
+   for(Providers::const_iterator itProvider = providers_.begin(), itProviderEnd = providers_.end();
+       itProvider != itProviderEnd;
+       ++itProvider) {
+      boost::shared_ptr<EventSetupRecordIntervalFinder> finder = (*itProvider)->finder();
+      if(finder.get() == 0 || !finder->hasFixedIntervals()) {
+         return false;
+      }
+   }
+   return true;
+}
+
 void 
 DependentRecordIntervalFinder::setIntervalFor(const EventSetupRecordKey& iKey,
                                                const IOVSyncValue& iTime, 
@@ -27,6 +27,7 @@ namespace edm {
 			CurrentProcessingContext const* cpc) {
     detail::CPCSentry sentry(current_context_, cpc);
     Event e(const_cast<EventPrincipal&>(ep), moduleDescription_);
+    e.setConsumer(this);
     this->analyze(e, c);
     return true;
   }
@@ -0,0 +1,78 @@
+// -*- C++ -*-
+//
+// Package:     FWCore/Framework
+// Class  :     EDConsumerBase
+//
+// Implementation:
+//     The indexes found for a token are only valid for the ProductRegistry,
+//     and the state of its lookup map, they were found with.
+//
+// $Id$
+//
+
+// system include files
+
+// user include files
+#include "FWCore/Framework/interface/EDConsumerBase.h"
+#include "DataFormats/Provenance/interface/ProductRegistry.h"
+#include "FWCore/Framework/interface/Principal.h"
+#include "FWCore/Utilities/interface/EDMException.h"
+
+using namespace edm;
+
+//
+// constructors and destructor
+//
+EDConsumerBase::ItemToGet::ItemToGet(TypeID const& iType, InputTag const& iTag):
+  type_(iType),
+  tag_(iTag),
+  indexes_(),
+  registry_(0),
+  fillCount_(0)
+{
+}
+
+EDConsumerBase::EDConsumerBase():
+  itemsToGet_()
+{
+}
+
+EDConsumerBase::~EDConsumerBase()
+{
+}
+
+//
+// member functions
+//
+unsigned int
+EDConsumerBase::recordConsumes(TypeID const& iType, InputTag const& iTag)
+{
+  itemsToGet_.emplace_back(iType, iTag);
+  return itemsToGet_.size() - 1;
+}
+
+//
+// const member functions
+//
+BasicHandle
+EDConsumerBase::getByToken(EDGetToken iToken, TypeID const& iType, Principal const& iPrincipal) const
+{
+  if(iToken.isUninitialized() || iToken.index() >= itemsToGet_.size()) {
+    throw Exception(errors::LogicError)
+      << "getByToken was called with a token which was not returned by 'consumes' of this module.\n";
+  }
+  ItemToGet const& item = itemsToGet_[iToken.index()];
+  if(item.type_ != iType) {
+    throw Exception(errors::LogicError)
+      << "getByToken was called for type " << iType.className() << " with a token for type "
+      << item.type_.className() << ".\n";
+  }
+  ProductRegistry const* registry = &iPrincipal.productRegistry();
+  int fillCount = registry->productLookup().fillCount();
+  if(item.registry_ != registry || item.fillCount_ != fillCount) {
+    iPrincipal.productIndexesByLabel(item.type_, item.tag_.label(), item.tag_.instance(), item.tag_.process(), item.indexes_);
+    item.registry_ = registry;
+    item.fillCount_ = fillCount;
+  }
+  return iPrincipal.getByIndexes(item.type_, item.indexes_, item.tag_);
+}
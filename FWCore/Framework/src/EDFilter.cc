@@ -23,6 +23,7 @@ namespace edm {
     detail::CPCSentry sentry(current_context_, cpc);
     bool rc = false;
     Event e(ep, moduleDescription_);
+    e.setConsumer(this);
     rc = this->filter(e, c);
     e.commit_(&previousParentage_, &previousParentageId_);
     return rc;
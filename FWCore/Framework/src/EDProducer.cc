@@ -28,6 +28,7 @@ namespace edm {
 			     CurrentProcessingContext const* cpc) {
     detail::CPCSentry sentry(current_context_, cpc);
     Event e(ep, moduleDescription_);
+    e.setConsumer(this);
     this->produce(e, c);
     e.commit_(&previousParentage_, &previousParentageId_);
     return true;
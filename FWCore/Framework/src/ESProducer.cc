@@ -28,7 +28,8 @@ namespace edm {
 //
 // constructors and destructor
 //
-ESProducer::ESProducer()
+ESProducer::ESProducer() :
+   reuseResults_(false)
 {
 }
 
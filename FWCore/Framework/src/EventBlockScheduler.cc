@@ -0,0 +1,89 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     EventBlockScheduler
+//
+// Implementation:
+//     The rate of a child is the average of its previous rate and the rate of its last block,
+//     so a child which slows down, e.g. because it reached a region of harder events, gets
+//     smaller blocks soon after.
+//
+// $Id$
+//
+
+// system include files
+#include <algorithm>
+#include <cmath>
+
+// user include files
+#include "EventBlockScheduler.h"
+
+using namespace edm::multicore;
+//
+// constants, enums and typedefs
+//
+namespace {
+   //the events not yet handed out are shared in this many blocks per child
+   double const kBlocksPerChild = 2.;
+}
+
+//
+// constructors and destructor
+//
+EventBlockScheduler::EventBlockScheduler(unsigned int iNChildren, unsigned long iMaxBlockSize, long iNEvents, bool iAdaptive) :
+m_nChildren(std::max(iNChildren, 1U)),
+m_maxBlockSize(std::max(iMaxBlockSize, 1UL)),
+m_nEvents(iNEvents),
+m_adaptive(iAdaptive),
+m_nextIndex(0),
+m_rates()
+{
+}
+
+//
+// member functions
+//
+MessageForSource
+EventBlockScheduler::nextBlock(int iChild, unsigned long iNEventsProcessed, double iSeconds)
+{
+   if(0 != iNEventsProcessed && iSeconds > 0.) {
+      double rate = iNEventsProcessed / iSeconds;
+      std::map<int, double>::iterator itRate = m_rates.find(iChild);
+      if(itRate == m_rates.end()) {
+         m_rates.insert(std::make_pair(iChild, rate));
+      } else {
+         itRate->second = 0.5 * (itRate->second + rate);
+      }
+   }
+
+   MessageForSource block;
+   block.startIndex = m_nextIndex;
+   block.nIndices = m_maxBlockSize;
+   if(m_adaptive) {
+      double share = m_maxBlockSize;
+      unsigned long remaining = 0;
+      if(m_nEvents >= 0) {
+         unsigned long const nEvents = static_cast<unsigned long>(m_nEvents);
+         remaining = m_nextIndex < nEvents ? nEvents - m_nextIndex : 0;
+         if(0 == remaining) {
+            block.nIndices = 0;
+            return block;
+         }
+         share = remaining / (kBlocksPerChild * m_nChildren);
+      }
+      std::map<int, double>::const_iterator itRate = m_rates.find(iChild);
+      if(itRate != m_rates.end()) {
+         double sum = 0.;
+         for(std::map<int, double>::const_iterator it = m_rates.begin(), itEnd = m_rates.end(); it != itEnd; ++it) {
+            sum += it->second;
+         }
+         share *= itRate->second * m_rates.size() / sum;
+      }
+      block.nIndices = std::min(m_maxBlockSize, std::max(1UL, static_cast<unsigned long>(std::ceil(share))));
+      if(m_nEvents >= 0) {
+         block.nIndices = std::min(block.nIndices, remaining);
+      }
+   }
+   m_nextIndex += block.nIndices;
+   return block;
+}
@@ -0,0 +1,78 @@
+#ifndef FWCore_Framework_EventBlockScheduler_h
+#define FWCore_Framework_EventBlockScheduler_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     EventBlockScheduler
+//
+/**\class EventBlockScheduler EventBlockScheduler.h FWCore/Framework/src/EventBlockScheduler.h
+
+ Description: Decides which block of events a forked child processes next
+
+ Usage:
+    This class is an internal detail of how the parent process hands out work to the child
+ processes. Each time a child asks for work it reports how many events it processed since it
+ last asked and how long it took, and is given the next block of consecutive event indices.
+
+    Without adaptive blocks every block holds the maximum number of events. With adaptive blocks
+ the size of a block is chosen so that
+ - a block holds about 1/(2 x number of children) of the events not yet handed out, so blocks
+   are large at the beginning of the job and shrink as the end is approached
+ - a child which processes events faster than the average gets a proportionally larger block
+   so every block takes about the same time whichever child processes it
+ and never holds more than the maximum number of events. The last blocks therefore take little
+ time and the children all finish at about the same time. If the number of events of the job
+ is not known only the second rule applies.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <map>
+
+// user include files
+#include "MessageForSource.h"
+
+// forward declarations
+
+namespace edm {
+   namespace multicore {
+      class EventBlockScheduler
+      {
+
+      public:
+         ///iNEvents is the number of events of the job or a negative number if it is not known
+         EventBlockScheduler(unsigned int iNChildren, unsigned long iMaxBlockSize, long iNEvents, bool iAdaptive);
+
+         // ---------- const member functions ---------------------
+         unsigned long maxBlockSize() const { return m_maxBlockSize; }
+         ///the index of the first event not yet handed out
+         unsigned long nextIndex() const { return m_nextIndex; }
+
+         // ---------- member functions ---------------------------
+         /**Returns the block for the child iChild which processed iNEventsProcessed events in
+          iSeconds since it was given its previous block. A block with no events tells the
+          child there is no more work.
+          */
+         MessageForSource nextBlock(int iChild, unsigned long iNEventsProcessed, double iSeconds);
+
+      private:
+         EventBlockScheduler(const EventBlockScheduler&); // stop default
+
+         const EventBlockScheduler& operator=(const EventBlockScheduler&); // stop default
+
+         // ---------- member data --------------------------------
+         unsigned int const m_nChildren;
+         unsigned long const m_maxBlockSize;
+         long const m_nEvents;
+         bool const m_adaptive;
+         unsigned long m_nextIndex;
+         //events per second of each child which reported some
+         std::map<int, double> m_rates;
+      };
+   }
+}
+
+#endif
@@ -14,6 +14,7 @@
 #include "FWCore/Framework/interface/ProductDeletedException.h"
 #include "FWCore/Utilities/interface/Algorithms.h"
 #include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 
 #include <algorithm>
 
@@ -28,11 +29,13 @@ namespace edm {
           luminosityBlockPrincipal_(),
           branchMapperPtr_(),
           unscheduledHandler_(),
-          moduleLabelsRunning_(),
           eventSelectionIDs_(new EventSelectionIDVector),
           branchIDListHelper_(branchIDListHelper),
           branchListIndexes_(new BranchListIndexes),
-          branchListIndexToProcessIndex_() {}
+          branchListIndexToProcessIndex_(),
+          branchIDListOffsets_(),
+          productIDToHolderIndex_(),
+          nProductsInHolderIndex_(0) {}
 
   void
   EventPrincipal::clearEventPrincipal() {
@@ -41,7 +44,6 @@ namespace edm {
     luminosityBlockPrincipal_.reset();
     branchMapperPtr_.reset();
     unscheduledHandler_.reset();
-    moduleLabelsRunning_.clear();
     eventSelectionIDs_->clear();
     branchListIndexes_->clear();
     branchListIndexToProcessIndex_.clear();
@@ -71,6 +73,8 @@ namespace edm {
       branchListIndexes_->push_back(productRegistry().producedBranchListIndex());
     }
 
+    updateProductIDToHolderIndex();
+
     // Fill in helper map for Branch to ProductID mapping
     ProcessIndex pix = 0;
     for(auto const& blindex : *branchListIndexes_) {
@@ -84,6 +88,28 @@ namespace edm {
     }
   }
 
+  void
+  EventPrincipal::readImmediate() {
+    for(auto const& prod : *this) {
+      ProductHolderBase const& phb = *prod;
+      if(!phb.branchDescription().produced() && !phb.productUnavailable()) {
+        resolveProduct_(phb, false);
+      }
+    }
+    // The input reuses its BranchMapper for the next event, so take our own copy.
+    boost::shared_ptr<BranchMapper> mapper(new BranchMapper);
+    for(auto const& prod : *this) {
+      ProductProvenance const* provenance = branchMapperPtr_->branchIDToProvenance(prod->branchDescription().branchID());
+      if(provenance != 0) {
+        mapper->insertIntoSet(*provenance);
+      }
+    }
+    branchMapperPtr_ = mapper;
+    for(auto const& prod : *this) {
+      prod->setProvenance(branchMapperPtr(), processHistoryID(), branchIDToProductID(prod->branchDescription().originalBranchID()));
+    }
+  }
+
   void
   EventPrincipal::setLuminosityBlockPrincipal(boost::shared_ptr<LuminosityBlockPrincipal> const& lbp) {
     luminosityBlockPrincipal_ = lbp;
@@ -107,6 +133,7 @@ namespace edm {
         << "put: Cannot put because ptr to product is null."
         << "\n";
     }
+    std::lock_guard<std::recursive_mutex> guard(productMutex());
     branchMapperPtr()->insertIntoSet(productProvenance);
     ProductHolderBase* phb = getExistingProduct(bd.branchID());
     assert(phb);
@@ -122,6 +149,7 @@ namespace edm {
         ProductProvenance const& productProvenance) {
 
     assert(!bd.produced());
+    std::lock_guard<std::recursive_mutex> guard(productMutex());
     branchMapperPtr()->insertIntoSet(productProvenance);
     ProductHolderBase* phb = getExistingProduct(bd.branchID());
     assert(phb);
@@ -131,10 +159,38 @@ namespace edm {
     phb->putProduct(edp, productProvenance);
   }
 
+  namespace {
+    // Marks a product as being read and, however the read ends, clears the mark
+    // under the product mutex and wakes up the threads waiting for the product.
+    class ReadSentry {
+    public:
+      ReadSentry(ProductHolderBase const& iHolder,
+                 std::unique_lock<std::recursive_mutex>& iLock,
+                 std::condition_variable_any& iRead) :
+        holder_(iHolder), lock_(iLock), read_(iRead) {
+        holder_.setBeingRead(true);
+      }
+      ~ReadSentry() {
+        if(!lock_.owns_lock()) {
+          lock_.lock();
+        }
+        holder_.setBeingRead(false);
+        read_.notify_all();
+      }
+    private:
+      ProductHolderBase const& holder_;
+      std::unique_lock<std::recursive_mutex>& lock_;
+      std::condition_variable_any& read_;
+    };
+  }
+
   void
   EventPrincipal::resolveProduct_(ProductHolderBase const& phb, bool fillOnDemand) const {
-    // Try unscheduled production.
+    // Try unscheduled production. This is done without holding the lock
+    // so unscheduled modules for this event can run concurrently.
+    std::unique_lock<std::recursive_mutex> lock(productMutex());
     if(phb.onDemand()) {
+      lock.unlock();
       if(fillOnDemand) {
         unscheduledFill(phb.branchDescription().moduleLabel());
       }
@@ -146,9 +202,27 @@ namespace edm {
     if(phb.productUnavailable()) return; // nothing to do.
     if(!reader()) return; // nothing to do.
 
-    // must attempt to load from persistent store
+    // Only one thread reads a product. The others wait for it to be put.
+    while(phb.beingRead()) {
+      productRead_.wait(lock);
+    }
+    if(phb.product()) return; // read while we waited
+
+    // An output module writing an event holds the I/O mutex while it asks for
+    // products, so it must be taken before the product mutex. The thread reading
+    // a product holds it, so a thread waiting above never does.
+    lock.unlock();
+    boost::recursive_mutex::scoped_lock ioLock(*rootfix::getIOMutex());
+    lock.lock();
+    if(phb.product()) return; // read while we waited
+
+    // must attempt to load from persistent store, without the product mutex
+    // so the products of the event can be got and put meanwhile
+    ReadSentry sentry(phb, lock, productRead_);
     BranchKey const bk = BranchKey(phb.branchDescription());
+    lock.unlock();
     WrapperOwningHolder edp(reader()->getProduct(bk, phb.productData().getInterface(), this));
+    lock.lock();
 
     // Now fix up the ProductHolder
     checkUniquenessAndType(edp, &phb);
@@ -164,6 +238,42 @@ namespace edm {
     return productIDToBranchID(pid, branchIDListHelper_->branchIDLists(), *branchListIndexes_);
   }
 
+  void
+  EventPrincipal::updateProductIDToHolderIndex() {
+    BranchIDLists const& lists = branchIDListHelper_->branchIDLists();
+    size_t const nProducts = productRegistry().constProductList().size();
+    if(lists.size() == branchIDListOffsets_.size() && nProducts == nProductsInHolderIndex_) {
+      return;
+    }
+    branchIDListOffsets_.clear();
+    productIDToHolderIndex_.clear();
+    for(auto const& list : lists) {
+      branchIDListOffsets_.push_back(productIDToHolderIndex_.size());
+      for(auto const& bid : list) {
+        productIDToHolderIndex_.push_back(productRegistry().indexFrom(BranchID(bid)));
+      }
+    }
+    nProductsInHolderIndex_ = nProducts;
+  }
+
+  ProductTransientIndex
+  EventPrincipal::productIDToHolderIndex(ProductID const& pid) const {
+    // Same as productIDToBranchID followed by ProductRegistry::indexFrom, without the map lookup
+    size_t const procIndex = pid.processIndex() - 1;
+    if(procIndex < branchListIndexes_->size()) {
+      BranchListIndex const blix = (*branchListIndexes_)[procIndex];
+      if(blix < branchIDListOffsets_.size()) {
+        size_t const begin = branchIDListOffsets_[blix];
+        size_t const end = (blix + 1U < branchIDListOffsets_.size() ? branchIDListOffsets_[blix + 1U] : productIDToHolderIndex_.size());
+        size_t const prodIndex = pid.productIndex() - 1;
+        if(prodIndex < end - begin) {
+          return productIDToHolderIndex_[begin + prodIndex];
+        }
+      }
+    }
+    return ProductRegistry::kInvalidIndex;
+  }
+
   ProductID
   EventPrincipal::branchIDToProductID(BranchID const& bid) const {
     if(!bid.isValid()) {
@@ -200,8 +310,12 @@ namespace edm {
   
   BasicHandle
   EventPrincipal::getByProductID(ProductID const& pid) const {
-    BranchID bid = pidToBid(pid);
-    ConstProductPtr const phb = getProductHolder(bid, true, true);
+    if(!pid.isValid()) {
+      throw Exception(errors::ProductNotFound, "InvalidID")
+        << "get by product ID: invalid ProductID supplied\n";
+    }
+    ProductTransientIndex const index = productIDToHolderIndex(pid);
+    ConstProductPtr const phb = (index == ProductRegistry::kInvalidIndex ? nullptr : getProductByIndex(index, true, true));
     if(phb == nullptr) {
       boost::shared_ptr<cms::Exception> whyFailed(new Exception(errors::ProductNotFound, "InvalidID"));
       *whyFailed
@@ -258,31 +372,9 @@ namespace edm {
 
   bool
   EventPrincipal::unscheduledFill(std::string const& moduleLabel) const {
-
-    // If it is a module already currently running in unscheduled
-    // mode, then there is a circular dependency related to which
-    // EDProducts modules require and produce.  There is no safe way
-    // to recover from this.  Here we check for this problem and throw
-    // an exception.
-    std::vector<std::string>::const_iterator i =
-      find_in_all(moduleLabelsRunning_, moduleLabel);
-
-    if(i != moduleLabelsRunning_.end()) {
-      throw Exception(errors::LogicError)
-        << "Hit circular dependency while trying to run an unscheduled module.\n"
-        << "Current implementation of unscheduled execution cannot always determine\n"
-        << "the proper order for module execution.  It is also possible the modules\n"
-        << "have a built in circular dependence that will not work with any order.\n"
-        << "In the first case, scheduling some or all required modules in paths will help.\n"
-        << "In the second case, the modules themselves will have to be fixed.\n";
-    }
-
-    moduleLabelsRunning_.push_back(moduleLabel);
-
     if(unscheduledHandler_) {
       unscheduledHandler_->tryToFill(moduleLabel, *const_cast<EventPrincipal*>(this));
     }
-    moduleLabelsRunning_.pop_back();
     return true;
   }
 }
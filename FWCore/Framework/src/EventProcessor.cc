@@ -10,6 +10,7 @@
 #include "DataFormats/Provenance/interface/ProcessHistoryRegistry.h"
 
 #include "FWCore/Framework/interface/CommonParams.h"
+#include "FWCore/Framework/interface/ComponentDescription.h"
 #include "FWCore/Framework/interface/EDLooperBase.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Framework/interface/EventSetupProvider.h"
@@ -29,9 +30,11 @@
 #include "FWCore/Framework/interface/Schedule.h"
 #include "FWCore/Framework/interface/ScheduleInfo.h"
 #include "FWCore/Framework/interface/SubProcess.h"
+#include "FWCore/Framework/interface/TriggerNamesService.h"
 #include "FWCore/Framework/src/Breakpoints.h"
 #include "FWCore/Framework/src/EPStates.h"
 #include "FWCore/Framework/src/EventSetupsController.h"
+#include "FWCore/Framework/src/EventStreams.h"
 #include "FWCore/Framework/src/InputSourceFactory.h"
 
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
@@ -46,17 +49,20 @@
 
 #include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
 
 #include "FWCore/Utilities/interface/DebugMacros.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
 #include "FWCore/Utilities/interface/ConvertException.h"
 #include "FWCore/Utilities/interface/RandomNumberGenerator.h"
+#include "FWCore/Utilities/interface/SharedMemoryArena.h"
 #include "FWCore/Utilities/interface/UnixSignalHandlers.h"
 #include "FWCore/Utilities/interface/ExceptionCollector.h"
 
 #include "MessageForSource.h"
 #include "MessageForParent.h"
+#include "EventBlockScheduler.h"
 
 #include "boost/bind.hpp"
 #include "boost/thread/xtime.hpp"
@@ -83,6 +89,11 @@
 #include <sched.h>
 #endif
 
+//Used for giving back the free heap before forking
+#ifndef __APPLE__
+#include <malloc.h>
+#endif
+
 //Needed for introspection
 #include "Cintex/Cintex.h"
 
@@ -384,7 +395,8 @@ namespace edm {
     act_table_(),
     processConfiguration_(),
     schedule_(),
-    subProcess_(),
+    subProcesses_(),
+    concurrentSubProcesses_(false),
     historyAppender_(new HistoryAppender),
     state_(sInit),
     event_loop_(),
@@ -414,8 +426,21 @@ namespace edm {
     forceESCacheClearOnNewRun_(false),
     numberOfForkedChildren_(0),
     numberOfSequentialEventsPerChild_(1),
+    adaptiveEventBlocks_(false),
+    trimHeapBeforeFork_(false),
+    mergeChildOutputs_(false),
     setCpuAffinity_(false),
-    eventSetupDataToExcludeFromPrefetching_() {
+    eventSetupDataToExcludeFromPrefetching_(),
+    eventSetupSharedMemorySize_(0U),
+    eventSetupSharedMemory_(),
+    prefetchEventSetupOnNewIOV_(false),
+    prefetchedCacheIdentifiers_(),
+    numberOfStreams_(1U),
+    streamSchedules_(),
+    streamRegistries_(),
+    streamBranchIDListHelpers_(),
+    eventStreams_(),
+    endPathMutex_() {
     boost::shared_ptr<ParameterSet> parameterSet = PythonProcessDesc(config).parameterSet();
     boost::shared_ptr<ProcessDesc> processDesc(new ProcessDesc(parameterSet));
     processDesc->addServices(defaultServices, forcedServices);
@@ -437,7 +462,8 @@ namespace edm {
     act_table_(),
     processConfiguration_(),
     schedule_(),
-    subProcess_(),
+    subProcesses_(),
+    concurrentSubProcesses_(false),
     historyAppender_(new HistoryAppender),
     state_(sInit),
     event_loop_(),
@@ -467,8 +493,21 @@ namespace edm {
     forceESCacheClearOnNewRun_(false),
     numberOfForkedChildren_(0),
     numberOfSequentialEventsPerChild_(1),
+    adaptiveEventBlocks_(false),
+    trimHeapBeforeFork_(false),
+    mergeChildOutputs_(false),
     setCpuAffinity_(false),
-    eventSetupDataToExcludeFromPrefetching_() {
+    eventSetupDataToExcludeFromPrefetching_(),
+    eventSetupSharedMemorySize_(0U),
+    eventSetupSharedMemory_(),
+    prefetchEventSetupOnNewIOV_(false),
+    prefetchedCacheIdentifiers_(),
+    numberOfStreams_(1U),
+    streamSchedules_(),
+    streamRegistries_(),
+    streamBranchIDListHelpers_(),
+    eventStreams_(),
+    endPathMutex_() {
     boost::shared_ptr<ParameterSet> parameterSet = PythonProcessDesc(config).parameterSet();
     boost::shared_ptr<ProcessDesc> processDesc(new ProcessDesc(parameterSet));
     processDesc->addServices(defaultServices, forcedServices);
@@ -490,7 +529,8 @@ namespace edm {
     act_table_(),
     processConfiguration_(),
     schedule_(),
-    subProcess_(),
+    subProcesses_(),
+    concurrentSubProcesses_(false),
     historyAppender_(new HistoryAppender),
     state_(sInit),
     event_loop_(),
@@ -520,8 +560,21 @@ namespace edm {
     forceESCacheClearOnNewRun_(false),
     numberOfForkedChildren_(0),
     numberOfSequentialEventsPerChild_(1),
+    adaptiveEventBlocks_(false),
+    trimHeapBeforeFork_(false),
+    mergeChildOutputs_(false),
     setCpuAffinity_(false),
-    eventSetupDataToExcludeFromPrefetching_() {
+    eventSetupDataToExcludeFromPrefetching_(),
+    eventSetupSharedMemorySize_(0U),
+    eventSetupSharedMemory_(),
+    prefetchEventSetupOnNewIOV_(false),
+    prefetchedCacheIdentifiers_(),
+    numberOfStreams_(1U),
+    streamSchedules_(),
+    streamRegistries_(),
+    streamBranchIDListHelpers_(),
+    eventStreams_(),
+    endPathMutex_() {
     init(processDesc, token, legacy);
   }
 
@@ -539,7 +592,8 @@ namespace edm {
     act_table_(),
     processConfiguration_(),
     schedule_(),
-    subProcess_(),
+    subProcesses_(),
+    concurrentSubProcesses_(false),
     historyAppender_(new HistoryAppender),
     state_(sInit),
     event_loop_(),
@@ -569,8 +623,21 @@ namespace edm {
     forceESCacheClearOnNewRun_(false),
     numberOfForkedChildren_(0),
     numberOfSequentialEventsPerChild_(1),
+    adaptiveEventBlocks_(false),
+    trimHeapBeforeFork_(false),
+    mergeChildOutputs_(false),
     setCpuAffinity_(false),
-    eventSetupDataToExcludeFromPrefetching_() {
+    eventSetupDataToExcludeFromPrefetching_(),
+    eventSetupSharedMemorySize_(0U),
+    eventSetupSharedMemory_(),
+    prefetchEventSetupOnNewIOV_(false),
+    prefetchedCacheIdentifiers_(),
+    numberOfStreams_(1U),
+    streamSchedules_(),
+    streamRegistries_(),
+    streamBranchIDListHelpers_(),
+    eventStreams_(),
+    endPathMutex_() {
     if(isPython) {
       boost::shared_ptr<ParameterSet> parameterSet = PythonProcessDesc(config).parameterSet();
       boost::shared_ptr<ProcessDesc> processDesc(new ProcessDesc(parameterSet));
@@ -595,18 +662,26 @@ namespace edm {
     //std::cerr << parameterSet->dump() << std::endl;
 
     // If there is a subprocess, pop the subprocess parameter set out of the process parameter set
-    boost::shared_ptr<ParameterSet> subProcessParameterSet(popSubProcessParameterSet(*parameterSet).release());
+    std::vector<ParameterSet> subProcessVParameterSet(popSubProcessVParameterSet(*parameterSet));
+    ParameterSet const* subProcessParameterSet = subProcessVParameterSet.empty() ? 0 : &subProcessVParameterSet[0];
 
     // Now set some parameters specific to the main process.
     ParameterSet const& optionsPset(parameterSet->getUntrackedParameterSet("options", ParameterSet()));
     fileMode_ = optionsPset.getUntrackedParameter<std::string>("fileMode", "");
     emptyRunLumiMode_ = optionsPset.getUntrackedParameter<std::string>("emptyRunLumiMode", "");
     forceESCacheClearOnNewRun_ = optionsPset.getUntrackedParameter<bool>("forceEventSetupCacheClearOnNewRun", false);
+    numberOfStreams_ = optionsPset.getUntrackedParameter<unsigned int>("numberOfStreams", 1U);
+    concurrentSubProcesses_ = optionsPset.getUntrackedParameter<bool>("concurrentSubProcesses", false);
+    prefetchEventSetupOnNewIOV_ = optionsPset.getUntrackedParameter<bool>("prefetchEventSetupOnNewIOV", false);
     ParameterSet const& forking = optionsPset.getUntrackedParameterSet("multiProcesses", ParameterSet());
     numberOfForkedChildren_ = forking.getUntrackedParameter<int>("maxChildProcesses", 0);
     numberOfSequentialEventsPerChild_ = forking.getUntrackedParameter<unsigned int>("maxSequentialEventsPerChild", 1);
+    adaptiveEventBlocks_ = forking.getUntrackedParameter<bool>("adaptiveEventBlocks", false);
+    trimHeapBeforeFork_ = forking.getUntrackedParameter<bool>("trimHeapBeforeFork", false);
+    mergeChildOutputs_ = forking.getUntrackedParameter<bool>("mergeChildOutputs", false);
     setCpuAffinity_ = forking.getUntrackedParameter<bool>("setCpuAffinity", false);
     continueAfterChildFailure_ = forking.getUntrackedParameter<bool>("continueAfterChildFailure",false);
+    eventSetupSharedMemorySize_ = forking.getUntrackedParameter<unsigned int>("eventSetupSharedMemorySize", 0U);
     std::vector<ParameterSet> const& excluded = forking.getUntrackedParameterSetVector("eventSetupDataToExcludeFromPrefetching", std::vector<ParameterSet>());
     for(std::vector<ParameterSet>::const_iterator itPS = excluded.begin(), itPSEnd = excluded.end();
         itPS != itPSEnd;
@@ -623,7 +698,7 @@ namespace edm {
     //initialize the services
     boost::shared_ptr<std::vector<ParameterSet> > pServiceSets = processDesc->getServicesPSets();
     ServiceToken token = items.initServices(*pServiceSets, *parameterSet, iToken, iLegacy, true);
-    serviceToken_ = items.addCPRandTNS(*parameterSet, token);
+    serviceToken_ = items.addTaskScheduler(items.addCPRandTNS(*parameterSet, token));
 
     //make the services available
     ServiceRegistry::Operate operate(serviceToken_);
@@ -644,8 +719,12 @@ namespace edm {
     // initialize the input source
     input_ = makeInput(*parameterSet, *common, *items.preg_, items.branchIDListHelper_, items.actReg_, items.processConfiguration_);
 
+    // the Schedules of any additional event streams must start from the same state
+    ParameterSet const unreducedParameterSet(*parameterSet);
+    ProductRegistry::ProductList const inputProducts(items.preg_->productList());
+
     // intialize the Schedule
-    schedule_ = items.initSchedule(*parameterSet,subProcessParameterSet.get());
+    schedule_ = items.initSchedule(*parameterSet,subProcessParameterSet);
 
     // set the data members
     act_table_ = items.act_table_;
@@ -657,16 +736,110 @@ namespace edm {
     FDEBUG(2) << parameterSet << std::endl;
     connectSigs(this);
 
-    // Reusable event principal
-    boost::shared_ptr<EventPrincipal> ep(new EventPrincipal(preg_, branchIDListHelper_, *processConfiguration_, historyAppender_.get()));
-    principalCache_.insert(ep);
+    setupEventStreams(unreducedParameterSet, subProcessParameterSet, inputProducts);
+
+    // Reusable event principal, one for each stream
+    for(unsigned int i = 0; i != numberOfStreams_; ++i) {
+      boost::shared_ptr<EventPrincipal> ep(new EventPrincipal(preg_, branchIDListHelper_, *processConfiguration_, historyAppender_.get()));
+      principalCache_.insert(ep);
+    }
       
-    // initialize the subprocess, if there is one
-    if(subProcessParameterSet) {
-      subProcess_.reset(new SubProcess(*subProcessParameterSet, *parameterSet, preg_, branchIDListHelper_, *espController_, *actReg_, token, serviceregistry::kConfigurationOverrides));
+    // initialize the subprocesses, if there are any
+    for(auto& subProcessPSet : subProcessVParameterSet) {
+      subProcesses_.emplace_back(new SubProcess(subProcessPSet, *parameterSet, preg_, branchIDListHelper_, *espController_, *actReg_, token, serviceregistry::kConfigurationOverrides));
     }
   }
 
+  void
+  EventProcessor::setupEventStreams(ParameterSet const& unreducedParameterSet,
+                                    ParameterSet const* subProcessParameterSet,
+                                    ProductRegistry::ProductList const& inputProducts) {
+    ParameterSet const& optionsPset(unreducedParameterSet.getUntrackedParameterSet("options", ParameterSet()));
+    if(numberOfStreams_ < 2U) {
+      numberOfStreams_ = 1U;
+      unsigned int readAhead = optionsPset.getUntrackedParameter<unsigned int>("eventReadAhead", 0U);
+      if(readAhead > 0U) {
+        setupEventReadAhead(readAhead);
+      }
+      return;
+    }
+    char const* reason = 0;
+    if(looper_) {
+      reason = "an EDLooper is used";
+    } else if(subProcessParameterSet != 0) {
+      reason = "a SubProcess is used";
+    } else if(numberOfForkedChildren_ > 0) {
+      reason = "child processes are forked";
+    } else if(!optionsPset.getUntrackedParameter<std::vector<std::string> >("canDeleteEarly", std::vector<std::string>()).empty()) {
+      reason = "'canDeleteEarly' is used";
+    } else if(optionsPset.getUntrackedParameter<bool>("deleteEarlyAutomatically", false)) {
+      reason = "'deleteEarlyAutomatically' is used";
+    } else if(!schedule_->runEndPathsSeparately()) {
+      reason = "a module is on both a Path and an EndPath";
+    }
+    if(reason != 0) {
+      LogWarning("EventStreams")
+        << "'numberOfStreams' was set to " << numberOfStreams_ << " but " << reason << ".\n"
+        << "Only one event will be processed at a time.";
+      numberOfStreams_ = 1U;
+      return;
+    }
+
+    // Each additional stream gets its own instance of every module on the trigger paths.
+    // The EndPaths of all streams are run by schedule_, one event at a time.
+    service::TriggerNamesService& tns = ServiceRegistry::instance().get<service::TriggerNamesService>();
+    for(unsigned int i = 1; i != numberOfStreams_; ++i) {
+      ParameterSet streamParameterSet(unreducedParameterSet);
+      boost::shared_ptr<ProductRegistry> streamRegistry(new ProductRegistry(inputProducts, false));
+      boost::shared_ptr<BranchIDListHelper> streamBranchIDListHelper(new BranchIDListHelper);
+      boost::shared_ptr<Schedule> streamSchedule(new Schedule(streamParameterSet, tns, *streamRegistry, *streamBranchIDListHelper,
+                                                              *act_table_, actReg_, processConfiguration_, 0));
+      // The EventPrincipals of all streams are built from preg_
+      bool sameProducts = streamRegistry->productList().size() == preg_->productList().size();
+      for(ProductRegistry::ProductList::const_iterator it = streamRegistry->productList().begin(),
+          itEnd = streamRegistry->productList().end(), itMain = preg_->productList().begin();
+          sameProducts && it != itEnd;
+          ++it, ++itMain) {
+        sameProducts = (it->first == itMain->first && it->second.branchID() == itMain->second.branchID());
+      }
+      if(!sameProducts || streamParameterSet.id() != processConfiguration_->parameterSetID()) {
+        throw Exception(errors::Configuration)
+          << "The Schedule for event stream " << i << " does not match the Schedule for stream 0.\n"
+          << "Please set 'numberOfStreams' to 1.\n";
+      }
+      streamSchedule->enableEndPaths(false);
+      streamSchedule->disableSummary();
+      streamSchedules_.push_back(streamSchedule);
+      streamRegistries_.push_back(streamRegistry);
+      streamBranchIDListHelpers_.push_back(streamBranchIDListHelper);
+    }
+    eventStreams_.reset(new EventStreams(*Service<TaskScheduler>(), numberOfStreams_));
+    LogInfo("EventStreams") << "Processing up to " << numberOfStreams_ << " events concurrently";
+  }
+
+  void
+  EventProcessor::setupEventReadAhead(unsigned int iReadAhead) {
+    char const* reason = 0;
+    if(looper_) {
+      reason = "an EDLooper is used";
+    } else if(numberOfForkedChildren_ > 0) {
+      reason = "child processes are forked";
+    }
+    if(reason != 0) {
+      LogWarning("EventReadAhead")
+        << "'eventReadAhead' was set to " << iReadAhead << " but " << reason << ".\n"
+        << "Events will not be read ahead.";
+      return;
+    }
+    // One EventPrincipal for the event being processed and one for each event read ahead.
+    // All are processed by schedule_, one at a time in the order they were read.
+    // The source and the output modules both use ROOT, so reading and writing take turns
+    // on the I/O mutex of GlobalMutex.h and the reads only overlap with the other modules.
+    numberOfStreams_ = iReadAhead + 1U;
+    eventStreams_.reset(new EventStreams(*Service<TaskScheduler>(), numberOfStreams_, true));
+    LogInfo("EventReadAhead") << "Reading up to " << iReadAhead << " events ahead of the event being processed";
+  }
+
   EventProcessor::~EventProcessor() {
     // Make the services available while everything is being deleted.
     ServiceToken token = getToken();
@@ -680,9 +853,11 @@ namespace edm {
     }
 
     // manually destroy all these thing that may need the services around
+    eventStreams_.reset();
     espController_.reset();
-    subProcess_.reset();
+    subProcesses_.clear();
     esp_.reset();
+    streamSchedules_.clear();
     schedule_.reset();
     input_.reset();
     looper_.reset();
@@ -739,8 +914,11 @@ namespace edm {
       throw;
     }
     schedule_->beginJob();
+    for(auto const& streamSchedule : streamSchedules_) {
+      streamSchedule->beginJob();
+    }
     // toerror.succeeded(); // should we add this?
-    if(hasSubProcess()) subProcess_->doBeginJob();
+    for(auto& subProcess : subProcesses_) subProcess->doBeginJob();
     actReg_->postBeginJobSignal_();
   }
 
@@ -755,9 +933,13 @@ namespace edm {
     //make the services available
     ServiceRegistry::Operate operate(serviceToken_);
 
+    for(auto const& streamSchedule : streamSchedules_) {
+      streamSchedule->endJob(c);
+      schedule_->addToCounters(*streamSchedule);
+    }
     schedule_->endJob(c);
-    if(hasSubProcess()) {
-      c.call(boost::bind(&SubProcess::doEndJob, subProcess_.get()));
+    for(auto& subProcess : subProcesses_) {
+      c.call(boost::bind(&SubProcess::doEndJob, subProcess.get()));
     }
     c.call(boost::bind(&InputSource::doEndJob, input_));
     if(looper_) {
@@ -780,6 +962,8 @@ namespace edm {
     //These are volatile since the compiler can not be allowed to optimize them
     // since they can be modified in the signaller handler
     volatile bool child_failed = false;
+    //unlike child_failed this is never reset when the job continues after a child failure
+    volatile bool any_child_failed = false;
     volatile unsigned int num_children_done = 0;
     volatile int child_fail_exit_status = 0;
     volatile int child_fail_signal = 0;
@@ -800,12 +984,14 @@ namespace edm {
             if(0 != WEXITSTATUS(stat_loc)) {
               child_fail_exit_status = WEXITSTATUS(stat_loc);
               child_failed = true;
+              any_child_failed = true;
             }
           }
           if(WIFSIGNALED(stat_loc)) {
             ++num_children_done;
             child_fail_signal = WTERMSIG(stat_loc);
             child_failed = true;
+            any_child_failed = true;
           }
           p = waitpid(-1, &stat_loc, WNOHANG);
         }
@@ -834,16 +1020,31 @@ namespace edm {
       return n;
     }
     
+    /*The pages of the heap which only hold freed memory are given back to the system.
+     Pages holding any live object stay as they are, so what the children share and
+     copy on write does not change: a child reusing a trimmed page gets a new page
+     just as it would have copied the old one. The gain is the smaller resident memory
+     of the parent for the rest of the job.*/
+    void trimHeapBeforeFork() {
+#ifndef __APPLE__
+      bool released = 0 != malloc_trim(0);
+      LogSystem("ForkingTrimHeap") << (released ? " gave back the free pages of the heap"
+                                                     : " found no free pages of the heap to give back");
+#else
+      LogInfo("ForkingTrimHeap") << "Giving back the free heap is not implemented for this architecture.";
+#endif
+    }
+
     /*This class embodied the thread which is used to listen to the forked children and
      then tell them which events they should process */
     class MessageSenderToSource {
     public:
-      MessageSenderToSource(std::vector<int> const& childrenSockets, std::vector<int> const& childrenPipes, long iNEventsToProcess);
+      MessageSenderToSource(std::vector<int> const& childrenSockets, std::vector<int> const& childrenPipes, multicore::EventBlockScheduler& iScheduler);
       void operator()();
 
     private:
       const std::vector<int>& m_childrenPipes;
-      long const m_nEventsToProcess;
+      multicore::EventBlockScheduler& m_scheduler;
       fd_set m_socketSet;
       unsigned int m_aliveChildren;
       int m_maxFd;
@@ -851,9 +1052,9 @@ namespace edm {
     
     MessageSenderToSource::MessageSenderToSource(std::vector<int> const& childrenSockets,
                                                  std::vector<int> const& childrenPipes,
-                                                 long iNEventsToProcess):
+                                                 multicore::EventBlockScheduler& iScheduler):
     m_childrenPipes(childrenPipes),
-    m_nEventsToProcess(iNEventsToProcess),
+    m_scheduler(iScheduler),
     m_aliveChildren(childrenSockets.size()),
     m_maxFd(0)
     {
@@ -878,7 +1079,8 @@ namespace edm {
     /* This function is the heart of the communication between parent and child.
      * When ready for more data, the child (see MessageReceiverForSource) requests
      * data through a AF_UNIX socket message.  The parent will then assign the next
-     * chunk of data by sending a message back.
+     * chunk of data by sending a message back. How large the chunk is is decided by the
+     * EventBlockScheduler from what the child reports about its previous chunk.
      *
      * Additionally, this function also monitors the read-side of the pipe fd from the child.
      * If the child dies unexpectedly, the pipe will be selected as ready for read and
@@ -897,9 +1099,6 @@ namespace edm {
       LogInfo("ForkingController") << "I am controller";
       //this is the master and therefore the controller
       
-      multicore::MessageForSource sndmsg;
-      sndmsg.startIndex = 0;
-      sndmsg.nIndices = m_nEventsToProcess;
       do {
         
         fd_set readSockets, errorSockets;
@@ -962,6 +1161,7 @@ namespace edm {
             }
           
             // Tell the child what events to process.
+            multicore::MessageForSource sndmsg = m_scheduler.nextBlock(idx, childMsg.nEventsProcessed, childMsg.processingTime);
             // If 'send' fails, then the child process has failed (any other possibilities are
             // eliminated because we are using fixed-size messages with Unix datagram sockets).
             // Thus, the SIGCHLD handler will fire and set child_fail = true.
@@ -972,7 +1172,6 @@ namespace edm {
               continue;
             }
             //std::cout << "Sent chunk starting at " << sndmsg.startIndex << " to child, length " << sndmsg.nIndices << std::endl;
-            sndmsg.startIndex += sndmsg.nIndices;
           }
         }
       
@@ -999,6 +1198,159 @@ namespace edm {
     }
   }
 
+  void
+  EventProcessor::fillDataKeysToPrefetch(eventsetup::EventSetupRecord const& iRecord,
+                                         std::vector<eventsetup::DataKey>& oDataKeys,
+                                         char const* iCategory) const {
+    oDataKeys.clear();
+    //see if this is on our exclusion list
+    ExcludedDataMap::const_iterator itExcludeRec = eventSetupDataToExcludeFromPrefetching_.find(iRecord.key().type().name());
+    ExcludedData const* excludedData(0);
+    if(itExcludeRec != eventSetupDataToExcludeFromPrefetching_.end()) {
+      excludedData = &(itExcludeRec->second);
+      if(excludedData->size() == 0 || excludedData->begin()->first == "*") {
+        //skip all items in this record
+        return;
+      }
+    }
+    iRecord.fillRegisteredDataKeys(oDataKeys);
+    if(0 != excludedData) {
+      std::vector<eventsetup::DataKey>::iterator itKeep = oDataKeys.begin();
+      for(std::vector<eventsetup::DataKey>::iterator itDataKey = oDataKeys.begin(), itDataKeyEnd = oDataKeys.end();
+          itDataKey != itDataKeyEnd;
+          ++itDataKey) {
+        if(excludedData->find(std::make_pair(itDataKey->type().name(), itDataKey->name().value())) != excludedData->end()) {
+          LogInfo(iCategory) << "   excluding:" << itDataKey->type().name() << " " << itDataKey->name().value() << std::endl;
+          continue;
+        }
+        if(itKeep != itDataKey) {
+          *itKeep = *itDataKey;
+        }
+        ++itKeep;
+      }
+      oDataKeys.erase(itKeep, oDataKeys.end());
+    }
+  }
+
+  void
+  EventProcessor::prefetchEventSetup(EventSetup const& es, char const* iCategory) {
+    //get all the data available in the EventSetup
+    std::vector<eventsetup::EventSetupRecordKey> recordKeys;
+    es.fillAvailableRecordKeys(recordKeys);
+    std::vector<eventsetup::DataKey> dataKeys;
+    for(std::vector<eventsetup::EventSetupRecordKey>::const_iterator itKey = recordKeys.begin(), itEnd = recordKeys.end();
+        itKey != itEnd;
+        ++itKey) {
+      eventsetup::EventSetupRecord const* recordPtr = es.find(*itKey);
+      if(0 != recordPtr) {
+        fillDataKeysToPrefetch(*recordPtr, dataKeys, iCategory);
+        for(std::vector<eventsetup::DataKey>::const_iterator itDataKey = dataKeys.begin(), itDataKeyEnd = dataKeys.end();
+            itDataKey != itDataKeyEnd;
+            ++itDataKey) {
+          try {
+            recordPtr->doGet(*itDataKey);
+          } catch(cms::Exception& e) {
+           LogWarning(iCategory) << e.what();
+          }
+        }
+      }
+    }
+  }
+
+  void
+  EventProcessor::prefetchChangedEventSetupRecords(EventSetup const& es) {
+    char const* const category = "EventSetupPreFetching";
+    //only the Records which got a new IOV since the last call need their data to be made
+    std::vector<eventsetup::EventSetupRecordKey> recordKeys;
+    es.fillAvailableRecordKeys(recordKeys);
+    std::vector<eventsetup::EventSetupRecord const*> records;
+    std::set<eventsetup::EventSetupRecordKey> pending;
+    for(auto const& recordKey : recordKeys) {
+      eventsetup::EventSetupRecord const* recordPtr = es.find(recordKey);
+      if(0 == recordPtr) continue;
+      unsigned long long& cacheIdentifier = prefetchedCacheIdentifiers_[recordPtr];
+      if(cacheIdentifier != recordPtr->cacheIdentifier()) {
+        cacheIdentifier = recordPtr->cacheIdentifier();
+        records.push_back(recordPtr);
+        pending.insert(recordKey);
+      }
+    }
+
+    // The Records are done in waves. A Record is in a wave once none of the Records it
+    // depends on is still to be done, so an ESProducer getting data from a dependent Record
+    // finds it already made. Within a wave the data of the ESSources is made first, one at
+    // a time on this thread, as sources often read from files or databases which must not be
+    // used from several threads. Then the data of each ESProducer is made by one task, in
+    // turn, and the tasks of the different producers run concurrently. A producer which asks
+    // for data being made by another task waits on the mutex of that datum, see DataProxy.
+    // Each task is isolated so a thread waiting inside a producer does not take up another
+    // prefetch task which could need a datum that thread is already making.
+    typedef std::vector<std::pair<eventsetup::EventSetupRecord const*, eventsetup::DataKey> > DataToGet;
+    std::vector<eventsetup::DataKey> dataKeys;
+    std::vector<eventsetup::EventSetupRecord const*> notReady;
+    while(!records.empty()) {
+      std::map<eventsetup::ComponentDescription const*, DataToGet> dataPerProvider;
+      std::vector<eventsetup::EventSetupRecordKey> done;
+      notReady.clear();
+      for(auto recordPtr : records) {
+        std::set<eventsetup::EventSetupRecordKey> const dependsOn = esp_->dependentRecords(recordPtr->key());
+        bool ready = true;
+        for(auto const& dependent : dependsOn) {
+          if(pending.find(dependent) != pending.end()) {
+            ready = false;
+            break;
+          }
+        }
+        if(!ready) {
+          notReady.push_back(recordPtr);
+          continue;
+        }
+        done.push_back(recordPtr->key());
+        fillDataKeysToPrefetch(*recordPtr, dataKeys, category);
+        for(auto const& dataKey : dataKeys) {
+          dataPerProvider[recordPtr->providerDescription(dataKey)].push_back(std::make_pair(recordPtr, dataKey));
+        }
+      }
+      //Records can not depend on each other in a loop
+      assert(!done.empty());
+
+      for(auto const& providerAndData : dataPerProvider) {
+        if(providerAndData.first->isSource_) {
+          for(auto const& recordAndKey : providerAndData.second) {
+            try {
+              recordAndKey.first->doGet(recordAndKey.second);
+            } catch(cms::Exception& e) {
+              LogWarning(category) << e.what();
+            }
+          }
+        }
+      }
+
+      TaskScheduler::TaskGroup group(*Service<TaskScheduler>());
+      for(auto const& providerAndData : dataPerProvider) {
+        if(providerAndData.first->isSource_) continue;
+        DataToGet const* data = &providerAndData.second;
+        group.run([data, category]() {
+          TaskScheduler::isolate([data, category]() {
+            for(auto const& recordAndKey : *data) {
+              try {
+                recordAndKey.first->doGet(recordAndKey.second);
+              } catch(cms::Exception& e) {
+                LogWarning(category) << e.what();
+              }
+            }
+          });
+        });
+      }
+      group.wait();
+
+      for(auto const& recordKey : done) {
+        pending.erase(recordKey);
+      }
+      records.swap(notReady);
+    }
+  }
+
   bool
   EventProcessor::forkProcess(std::string const& jobReportFile) {
 
@@ -1020,49 +1372,21 @@ namespace edm {
       itemType = input_->nextItemType();
       assert(itemType == InputSource::IsRun);
 
+      if(0U != eventSetupSharedMemorySize_) {
+        //made before the fork so all children map it at the same address
+        eventSetupSharedMemory_.reset(new SharedMemoryArena(eventSetupSharedMemorySize_ * 1024UL * 1024UL));
+        SharedMemoryArena::setForkShared(eventSetupSharedMemory_.get());
+        LogSystem("ForkingEventSetupSharedMemory") << " sharing up to " << eventSetupSharedMemorySize_
+                                                   << " MB of EventSetup data between the children";
+      }
+
       LogSystem("ForkingEventSetupPreFetching") << " prefetching for run " << input_->runAuxiliary()->run();
       IOVSyncValue ts(EventID(input_->runAuxiliary()->run(), 0, 0),
                       input_->runAuxiliary()->beginTime());
       espController_->eventSetupForInstance(ts);
       EventSetup const& es = esp_->eventSetup();
 
-      //now get all the data available in the EventSetup
-      std::vector<eventsetup::EventSetupRecordKey> recordKeys;
-      es.fillAvailableRecordKeys(recordKeys);
-      std::vector<eventsetup::DataKey> dataKeys;
-      for(std::vector<eventsetup::EventSetupRecordKey>::const_iterator itKey = recordKeys.begin(), itEnd = recordKeys.end();
-          itKey != itEnd;
-          ++itKey) {
-        eventsetup::EventSetupRecord const* recordPtr = es.find(*itKey);
-        //see if this is on our exclusion list
-        ExcludedDataMap::const_iterator itExcludeRec = eventSetupDataToExcludeFromPrefetching_.find(itKey->type().name());
-        ExcludedData const* excludedData(0);
-        if(itExcludeRec != eventSetupDataToExcludeFromPrefetching_.end()) {
-          excludedData = &(itExcludeRec->second);
-          if(excludedData->size() == 0 || excludedData->begin()->first == "*") {
-            //skip all items in this record
-            continue;
-          }
-        }
-        if(0 != recordPtr) {
-          dataKeys.clear();
-          recordPtr->fillRegisteredDataKeys(dataKeys);
-          for(std::vector<eventsetup::DataKey>::const_iterator itDataKey = dataKeys.begin(), itDataKeyEnd = dataKeys.end();
-              itDataKey != itDataKeyEnd;
-              ++itDataKey) {
-            //std::cout << "  " << itDataKey->type().name() << " " << itDataKey->name().value() << std::endl;
-            if(0 != excludedData && excludedData->find(std::make_pair(itDataKey->type().name(), itDataKey->name().value())) != excludedData->end()) {
-              LogInfo("ForkingEventSetupPreFetching") << "   excluding:" << itDataKey->type().name() << " " << itDataKey->name().value() << std::endl;
-              continue;
-            }
-            try {
-              recordPtr->doGet(*itDataKey);
-            } catch(cms::Exception& e) {
-             LogWarning("ForkingEventSetupPreFetching") << e.what();
-            }
-          }
-        }
-      }
+      prefetchEventSetup(es, "ForkingEventSetupPreFetching");
     }
     LogSystem("ForkingEventSetupPreFetching") <<"  done prefetching";
     {
@@ -1075,6 +1399,10 @@ namespace edm {
       actReg_->preForkReleaseResourcesSignal_();
       input_->doPreForkReleaseResources();
       schedule_->preForkReleaseResources();
+
+      if(trimHeapBeforeFork_) {
+        trimHeapBeforeFork();
+      }
     }
     installCustomHandler(SIGCHLD, ep_sigchld);
 
@@ -1204,6 +1532,10 @@ namespace edm {
       }
 
       if(childIndex < kMaxChildren) {
+        if(eventSetupSharedMemory_) {
+          //the data shared with the other children must never be changed
+          eventSetupSharedMemory_->makeFilledReadOnly();
+        }
         jobReport->childAfterFork(jobReportFile, childIndex, kMaxChildren);
         actReg_->postForkReacquireResourcesSignal_(childIndex, kMaxChildren);
 
@@ -1248,7 +1580,9 @@ namespace edm {
     //create a thread that sends the units of work to workers
     // we create it after all signals were blocked so that this
     // thread is never interupted by a signal
-    MessageSenderToSource sender(childrenSockets, childrenPipes, numberOfSequentialEventsPerChild_);
+    multicore::EventBlockScheduler scheduler(childrenSockets.size(), numberOfSequentialEventsPerChild_,
+                                             input_->remainingEvents(), adaptiveEventBlocks_);
+    MessageSenderToSource sender(childrenSockets, childrenPipes, scheduler);
     boost::thread senderThread(sender);
 
     if(not too_many_fds) {
@@ -1297,6 +1631,15 @@ namespace edm {
     if(too_many_fds) {
       throw cms::Exception("ForkedParentFailed") << "hit select limit for number of fds";
     }
+    if(mergeChildOutputs_ && !shutdown_flag) {
+      if(any_child_failed) {
+        LogWarning("ForkingMerge") << "not merging the output files since a child failed";
+      } else {
+        ServiceRegistry::Operate operate(serviceToken_);
+        LogSystem("ForkingMerge") << "merging the output files of the " << kMaxChildren << " children";
+        schedule_->mergeForkedChildrenOutputs(kMaxChildren);
+      }
+    }
     return false;
   }
 
@@ -1682,6 +2025,11 @@ namespace edm {
             itemType = (more ? input_->nextItemType() : InputSource::IsStop);
             
             FDEBUG(1) << "itemType = " << itemType << "\n";
+
+            // Events still being processed must finish before any other transition
+            if(hasEventStreams() && (itemType != InputSource::IsEvent || state_ == sStopping || state_ == sShuttingDown)) {
+              eventStreams_->waitForAll();
+            }
             
             // These are used for asynchronous running only and
             // and are checking to see if stopAsync or shutdownAsync
@@ -1709,6 +2057,7 @@ namespace edm {
             {
               boost::mutex::scoped_lock sl(usr2_lock);
               if(shutdown_flag) {
+                if(hasEventStreams()) eventStreams_->waitForAll();
                 changeState(mShutdownSignal);
                 returnCode = epSignal;
                 forceLooperToEnd_ = true;
@@ -1800,6 +2149,7 @@ namespace edm {
       
       catch (cms::Exception & e) {
         alreadyHandlingException_ = true;
+        if(hasEventStreams()) eventStreams_->waitForAll(false);
         terminateMachine(machine);
         alreadyHandlingException_ = false;
         if (!exceptionMessageLumis_.empty()) {
@@ -1872,7 +2222,7 @@ namespace edm {
   void EventProcessor::openOutputFiles() {
     if (fb_.get() != 0) {
       schedule_->openOutputFiles(*fb_);
-      if(hasSubProcess()) subProcess_->openOutputFiles(*fb_);
+      for(auto& subProcess : subProcesses_) subProcess->openOutputFiles(*fb_);
     }
     FDEBUG(1) << "\topenOutputFiles\n";
   }
@@ -1880,7 +2230,7 @@ namespace edm {
   void EventProcessor::closeOutputFiles() {
     if (fb_.get() != 0) {
       schedule_->closeOutputFiles();
-      if(hasSubProcess()) subProcess_->closeOutputFiles();
+      for(auto& subProcess : subProcesses_) subProcess->closeOutputFiles();
     }
     FDEBUG(1) << "\tcloseOutputFiles\n";
   }
@@ -1888,7 +2238,10 @@ namespace edm {
   void EventProcessor::respondToOpenInputFile() {
     if (fb_.get() != 0) {
       schedule_->respondToOpenInputFile(*fb_);
-      if(hasSubProcess()) subProcess_->respondToOpenInputFile(*fb_);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->respondToOpenInputFile(*fb_);
+      }
+      for(auto& subProcess : subProcesses_) subProcess->respondToOpenInputFile(*fb_);
     }
     FDEBUG(1) << "\trespondToOpenInputFile\n";
   }
@@ -1896,7 +2249,10 @@ namespace edm {
   void EventProcessor::respondToCloseInputFile() {
     if (fb_.get() != 0) {
       schedule_->respondToCloseInputFile(*fb_);
-      if(hasSubProcess()) subProcess_->respondToCloseInputFile(*fb_);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->respondToCloseInputFile(*fb_);
+      }
+      for(auto& subProcess : subProcesses_) subProcess->respondToCloseInputFile(*fb_);
     }
     FDEBUG(1) << "\trespondToCloseInputFile\n";
   }
@@ -1904,7 +2260,10 @@ namespace edm {
   void EventProcessor::respondToOpenOutputFiles() {
     if (fb_.get() != 0) {
       schedule_->respondToOpenOutputFiles(*fb_);
-      if(hasSubProcess()) subProcess_->respondToOpenOutputFiles(*fb_);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->respondToOpenOutputFiles(*fb_);
+      }
+      for(auto& subProcess : subProcesses_) subProcess->respondToOpenOutputFiles(*fb_);
     }
     FDEBUG(1) << "\trespondToOpenOutputFiles\n";
   }
@@ -1912,7 +2271,10 @@ namespace edm {
   void EventProcessor::respondToCloseOutputFiles() {
     if (fb_.get() != 0) {
       schedule_->respondToCloseOutputFiles(*fb_);
-      if(hasSubProcess()) subProcess_->respondToCloseOutputFiles(*fb_);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->respondToCloseOutputFiles(*fb_);
+      }
+      for(auto& subProcess : subProcesses_) subProcess->respondToCloseOutputFiles(*fb_);
     }
     FDEBUG(1) << "\trespondToCloseOutputFiles\n";
   }
@@ -1953,7 +2315,15 @@ namespace edm {
 
   bool EventProcessor::shouldWeCloseOutput() const {
     FDEBUG(1) << "\tshouldWeCloseOutput\n";
-    return hasSubProcess() ? subProcess_->shouldWeCloseOutput() : schedule_->shouldWeCloseOutput();
+    if(!hasSubProcess()) {
+      return schedule_->shouldWeCloseOutput();
+    }
+    for(auto const& subProcess : subProcesses_) {
+      if(subProcess->shouldWeCloseOutput()) {
+        return true;
+      }
+    }
+    return false;
   }
 
   void EventProcessor::doErrorStuff() {
@@ -1977,6 +2347,9 @@ namespace edm {
     }
     espController_->eventSetupForInstance(ts);
     EventSetup const& es = esp_->eventSetup();
+    if(prefetchEventSetupOnNewIOV_) {
+      prefetchChangedEventSetupRecords(es);
+    }
     if(looper_ && looperBeginJobRun_== false) {
       looper_->copyInfo(ScheduleInfo(schedule_.get()));
       looper_->beginOfJob(es);
@@ -1987,11 +2360,17 @@ namespace edm {
       typedef OccurrenceTraits<RunPrincipal, BranchActionBegin> Traits;
       ScheduleSignalSentry<Traits> sentry(actReg_.get(), &runPrincipal, &es);
       schedule_->processOneOccurrence<Traits>(runPrincipal, es);
-      if(hasSubProcess()) {
-        subProcess_->doBeginRun(runPrincipal, ts);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->processOneOccurrence<Traits>(runPrincipal, es);
+      }
+      for(auto& subProcess : subProcesses_) {
+        subProcess->doBeginRun(runPrincipal, ts);
       }
     }
     FDEBUG(1) << "\tbeginRun " << run.runNumber() << "\n";
+    if(hasEventStreams()) {
+      prefetchEventSetup(es, "EventStreamsEventSetupPreFetching");
+    }
     if(looper_) {
       looper_->doBeginRun(runPrincipal, es);
     }
@@ -2008,8 +2387,11 @@ namespace edm {
       typedef OccurrenceTraits<RunPrincipal, BranchActionEnd> Traits;
       ScheduleSignalSentry<Traits> sentry(actReg_.get(), &runPrincipal, &es);
       schedule_->processOneOccurrence<Traits>(runPrincipal, es, cleaningUpAfterException);
-      if(hasSubProcess()) {
-        subProcess_->doEndRun(runPrincipal, ts, cleaningUpAfterException);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->processOneOccurrence<Traits>(runPrincipal, es, cleaningUpAfterException);
+      }
+      for(auto& subProcess : subProcesses_) {
+        subProcess->doEndRun(runPrincipal, ts, cleaningUpAfterException);
       }
     }
     FDEBUG(1) << "\tendRun " << run.runNumber() << "\n";
@@ -2033,15 +2415,24 @@ namespace edm {
     IOVSyncValue ts(EventID(lumiPrincipal.run(), lumiPrincipal.luminosityBlock(), 0), lumiPrincipal.beginTime());
     espController_->eventSetupForInstance(ts);
     EventSetup const& es = esp_->eventSetup();
+    if(prefetchEventSetupOnNewIOV_) {
+      prefetchChangedEventSetupRecords(es);
+    }
     {
       typedef OccurrenceTraits<LuminosityBlockPrincipal, BranchActionBegin> Traits;
       ScheduleSignalSentry<Traits> sentry(actReg_.get(), &lumiPrincipal, &es);
       schedule_->processOneOccurrence<Traits>(lumiPrincipal, es);
-      if(hasSubProcess()) {
-        subProcess_->doBeginLuminosityBlock(lumiPrincipal, ts);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->processOneOccurrence<Traits>(lumiPrincipal, es);
+      }
+      for(auto& subProcess : subProcesses_) {
+        subProcess->doBeginLuminosityBlock(lumiPrincipal, ts);
       }
     }
     FDEBUG(1) << "\tbeginLumi " << run << "/" << lumi << "\n";
+    if(hasEventStreams()) {
+      prefetchEventSetup(es, "EventStreamsEventSetupPreFetching");
+    }
     if(looper_) {
       looper_->doBeginLuminosityBlock(lumiPrincipal, es);
     }
@@ -2060,8 +2451,11 @@ namespace edm {
       typedef OccurrenceTraits<LuminosityBlockPrincipal, BranchActionEnd> Traits;
       ScheduleSignalSentry<Traits> sentry(actReg_.get(), &lumiPrincipal, &es);
       schedule_->processOneOccurrence<Traits>(lumiPrincipal, es, cleaningUpAfterException);
-      if(hasSubProcess()) {
-        subProcess_->doEndLuminosityBlock(lumiPrincipal, ts, cleaningUpAfterException);
+      for(auto const& streamSchedule : streamSchedules_) {
+        streamSchedule->processOneOccurrence<Traits>(lumiPrincipal, es, cleaningUpAfterException);
+      }
+      for(auto& subProcess : subProcesses_) {
+        subProcess->doEndLuminosityBlock(lumiPrincipal, ts, cleaningUpAfterException);
       }
     }
     FDEBUG(1) << "\tendLumi " << run << "/" << lumi << "\n";
@@ -2114,29 +2508,33 @@ namespace edm {
 
   void EventProcessor::writeRun(statemachine::Run const& run) {
     schedule_->writeRun(principalCache_.runPrincipal(run.processHistoryID(), run.runNumber()));
-    if(hasSubProcess()) subProcess_->writeRun(run.processHistoryID(), run.runNumber());
+    for(auto& subProcess : subProcesses_) subProcess->writeRun(run.processHistoryID(), run.runNumber());
     FDEBUG(1) << "\twriteRun " << run.runNumber() << "\n";
   }
 
   void EventProcessor::deleteRunFromCache(statemachine::Run const& run) {
     principalCache_.deleteRun(run.processHistoryID(), run.runNumber());
-    if(hasSubProcess()) subProcess_->deleteRunFromCache(run.processHistoryID(), run.runNumber());
+    for(auto& subProcess : subProcesses_) subProcess->deleteRunFromCache(run.processHistoryID(), run.runNumber());
     FDEBUG(1) << "\tdeleteRunFromCache " << run.runNumber() << "\n";
   }
 
   void EventProcessor::writeLumi(ProcessHistoryID const& phid, RunNumber_t run, LuminosityBlockNumber_t lumi) {
     schedule_->writeLumi(principalCache_.lumiPrincipal(phid, run, lumi));
-    if(hasSubProcess()) subProcess_->writeLumi(phid, run, lumi);
+    for(auto& subProcess : subProcesses_) subProcess->writeLumi(phid, run, lumi);
     FDEBUG(1) << "\twriteLumi " << run << "/" << lumi << "\n";
   }
 
   void EventProcessor::deleteLumiFromCache(ProcessHistoryID const& phid, RunNumber_t run, LuminosityBlockNumber_t lumi) {
     principalCache_.deleteLumi(phid, run, lumi);
-    if(hasSubProcess()) subProcess_->deleteLumiFromCache(phid, run, lumi);
+    for(auto& subProcess : subProcesses_) subProcess->deleteLumiFromCache(phid, run, lumi);
     FDEBUG(1) << "\tdeleteLumiFromCache " << run << "/" << lumi << "\n";
   }
 
   void EventProcessor::readAndProcessEvent() {
+    if(hasEventStreams()) {
+      readAndProcessEventOnStream();
+      return;
+    }
     EventPrincipal *pep = input_->readEvent(principalCache_.eventPrincipal());
     FDEBUG(1) << "\treadEvent\n";
     assert(pep != 0);
@@ -2148,13 +2546,14 @@ namespace edm {
     IOVSyncValue ts(pep->id(), pep->time());
     espController_->eventSetupForInstance(ts);
     EventSetup const& es = esp_->eventSetup();
+    if(prefetchEventSetupOnNewIOV_) {
+      prefetchChangedEventSetupRecords(es);
+    }
     {
       typedef OccurrenceTraits<EventPrincipal, BranchActionBegin> Traits;
       ScheduleSignalSentry<Traits> sentry(actReg_.get(), pep, &es);
       schedule_->processOneOccurrence<Traits>(*pep, es);
-      if(hasSubProcess()) {
-        subProcess_->doEvent(*pep, ts);
-      }
+      SubProcess::doEvent(subProcesses_, *pep, ts, concurrentSubProcesses_);
     }
 
     if(looper_) {
@@ -2186,10 +2585,71 @@ namespace edm {
     pep->clearEventPrincipal();
   }
 
+  void EventProcessor::readAndProcessEventOnStream() {
+    // If anything goes wrong the state machine will end the luminosity block
+    // and run while unwinding, so all other events must be finished first.
+    try {
+      startEventOnStream();
+    }
+    catch(...) {
+      eventStreams_->waitForAll(false);
+      throw;
+    }
+  }
+
+  void EventProcessor::startEventOnStream() {
+    unsigned int stream = eventStreams_->waitForIdleStream();
+    EventPrincipal *pep = input_->readEvent(principalCache_.eventPrincipal(stream));
+    FDEBUG(1) << "\treadEvent on stream " << stream << "\n";
+    assert(pep != 0);
+    // The source will have moved on to the next event before this one is
+    // processed, so everything it could deliver later must be read now.
+    pep->readImmediate();
+    pep->setLuminosityBlockPrincipal(principalCache_.lumiPrincipalPtr());
+    assert(pep->luminosityBlockPrincipalPtrValid());
+    assert(principalCache_.lumiPrincipalPtr()->run() == pep->run());
+    assert(principalCache_.lumiPrincipalPtr()->luminosityBlock() == pep->luminosityBlock());
+
+    IOVSyncValue ts(pep->id(), pep->time());
+    if(!esp_->presentRecordsAreValidFor(ts)) {
+      // The EventSetup is shared by all streams so it can only be changed
+      // once no event is using it.
+      eventStreams_->waitForAll();
+      espController_->eventSetupForInstance(ts);
+      if(prefetchEventSetupOnNewIOV_) {
+        prefetchChangedEventSetupRecords(esp_->eventSetup());
+      } else {
+        prefetchEventSetup(esp_->eventSetup(), "EventStreamsEventSetupPreFetching");
+      }
+    }
+    EventSetup const& es = esp_->eventSetup();
+    Schedule* schedule = &streamSchedule(stream);
+    eventStreams_->run(stream, [this, pep, schedule, &es, ts]() {
+      {
+        typedef OccurrenceTraits<EventPrincipal, BranchActionBegin> Traits;
+        ScheduleSignalSentry<Traits> sentry(actReg_.get(), pep, &es);
+        schedule->processOneOccurrence<Traits>(*pep, es);
+        if(eventStreams_->inOrder()) {
+          // Events read ahead are processed one at a time by schedule_,
+          // which has already run the EndPaths
+          SubProcess::doEvent(subProcesses_, *pep, ts, concurrentSubProcesses_);
+        } else {
+          boost::mutex::scoped_lock lock(endPathMutex_);
+          schedule_->processEndPaths<Traits>(*pep, es);
+        }
+      }
+      FDEBUG(1) << "\tprocessEvent\n";
+      pep->clearEventPrincipal();
+    });
+  }
+
   bool EventProcessor::shouldWeStop() const {
     FDEBUG(1) << "\tshouldWeStop\n";
-    if(shouldWeStop_) return true;
-    return (schedule_->terminate() || (hasSubProcess() && subProcess_->terminate()));
+    bool stop = shouldWeStop_ || schedule_->terminate() || (hasSubProcess() && SubProcess::terminate(subProcesses_));
+    // The state machine goes on to end the luminosity block and run, which
+    // must not happen while events are still being processed
+    if(stop && hasEventStreams()) eventStreams_->waitForAll();
+    return stop;
   }
 
   void EventProcessor::setExceptionMessageFiles(std::string& message) {
@@ -30,6 +30,11 @@
 //                      avoid performance penalty of creating a new
 //                      EventSelector instance for each call (in static case)
 //
+// 7 - The selection is compiled into bit masks over the trigger results packed
+//     2 bits per path, which selectionDecision applies a word at a time.  The
+//     criteria for the trigger names of previous processes are kept for each
+//     ParameterSetID so going back to an earlier menu does no pattern matching.
+//
 
 
 #include "FWCore/Framework/interface/EventSelector.h"
@@ -46,6 +51,48 @@
 
 namespace edm
 {
+  namespace
+  {
+    unsigned int const kPathsPerWord = 32;
+    // the low bit of the 2 bit field of each path
+    cms_uint64_t const kLowBits = 0x5555555555555555ULL;
+    // trigger results of up to this many words are packed on the stack
+    unsigned int const kLocalWords = 16;
+
+    unsigned int wordsFor(unsigned int nPaths)
+    {
+      return (nPaths + kPathsPerWord - 1) / kPathsPerWord;
+    }
+
+    void setBit(std::vector<cms_uint64_t>& mask, unsigned int pos)
+    {
+      mask[pos / kPathsPerWord] |= 1ULL << (2 * (pos % kPathsPerWord));
+    }
+
+    // returns true if any path selected by the mask has a low bit set in the results
+    bool anyOf(cms_uint64_t const* results, std::vector<cms_uint64_t> const& mask,
+               unsigned int nWords)
+    {
+      unsigned int e = std::min(nWords, static_cast<unsigned int>(mask.size()));
+      cms_uint64_t found = 0;
+      for (unsigned int w = 0; w != e; ++w) {
+        found |= results[w] & mask[w];
+      }
+      return found != 0;
+    }
+
+    // returns true if every path selected by the mask has a low bit set in the results
+    bool allOf(cms_uint64_t const* results, std::vector<cms_uint64_t> const& mask,
+               unsigned int nWords)
+    {
+      for (unsigned int w = 0; w != mask.size(); ++w) {
+        cms_uint64_t found = w < nWords ? results[w] : 0;
+        if ((mask[w] & ~found) != 0) return false;
+      }
+      return true;
+    }
+  }
+
   EventSelector::EventSelector(Strings const& pathspecs,
 			       Strings const& names):
     accept_all_(false),
@@ -59,7 +106,9 @@ namespace edm
     psetID_(),
     paths_(),
     nTriggerNames_(0),
-    notStarPresent_(false)
+    notStarPresent_(false),
+    compiled_(),
+    criteriaCache_()
   {
     init(pathspecs, names);
   }
@@ -76,7 +125,9 @@ namespace edm
     psetID_(),
     paths_(pathspecs),
     nTriggerNames_(0),
-    notStarPresent_(false)
+    notStarPresent_(false),
+    compiled_(),
+    criteriaCache_()
   {
   }
 
@@ -93,7 +144,9 @@ namespace edm
     psetID_(),
     paths_(),
     nTriggerNames_(0),
-    notStarPresent_(false)
+    notStarPresent_(false),
+    compiled_(),
+    criteriaCache_()
   {
     Strings paths; // default is empty...
 
@@ -120,6 +173,7 @@ namespace edm
     if (paths.empty())
       {
 	accept_all_ = true;
+	compile();
 	return;
       }
 
@@ -263,9 +317,74 @@ namespace edm
 
     if (unrestricted_star && negated_star && exception_star) accept_all_ = true;
 
+    compile();
+
     // std::cerr << "### init exited\n";
 
   } // EventSelector::init
+
+  void
+  EventSelector::compile()
+  {
+    compiled_ = CompiledSelection();
+    unsigned int nWords = wordsFor(nTriggerNames_);
+    Mask empty(nWords, 0);
+    compiled_.absolutePass_ = empty;
+    compiled_.absoluteFail_ = empty;
+    compiled_.conditionalPass_ = empty;
+    compiled_.conditionalFail_ = empty;
+    compiled_.exception_ = empty;
+    for (Bits::const_iterator i = absolute_acceptors_.begin(); i != absolute_acceptors_.end(); ++i) {
+      setBit(i->accept_state_ ? compiled_.absolutePass_ : compiled_.absoluteFail_, i->pos_);
+    }
+    for (Bits::const_iterator i = conditional_acceptors_.begin(); i != conditional_acceptors_.end(); ++i) {
+      setBit(i->accept_state_ ? compiled_.conditionalPass_ : compiled_.conditionalFail_, i->pos_);
+    }
+    for (Bits::const_iterator i = exception_acceptors_.begin(); i != exception_acceptors_.end(); ++i) {
+      setBit(compiled_.exception_, i->pos_);
+    }
+    // the bits of all_must_fail_ always demand Fail
+    for (std::vector<Bits>::const_iterator f = all_must_fail_.begin(); f != all_must_fail_.end(); ++f) {
+      compiled_.mustFail_.push_back(empty);
+      for (Bits::const_iterator i = f->begin(); i != f->end(); ++i) {
+        setBit(compiled_.mustFail_.back(), i->pos_);
+      }
+    }
+    for (std::vector<Bits>::const_iterator f = all_must_fail_noex_.begin(); f != all_must_fail_noex_.end(); ++f) {
+      compiled_.mustFailNoex_.push_back(empty);
+      for (Bits::const_iterator i = f->begin(); i != f->end(); ++i) {
+        setBit(compiled_.mustFailNoex_.back(), i->pos_);
+      }
+    }
+  }
+
+  void
+  EventSelector::saveCriteria(Criteria& oCriteria) const
+  {
+    oCriteria.accept_all_ = accept_all_;
+    oCriteria.absolute_acceptors_ = absolute_acceptors_;
+    oCriteria.conditional_acceptors_ = conditional_acceptors_;
+    oCriteria.exception_acceptors_ = exception_acceptors_;
+    oCriteria.all_must_fail_ = all_must_fail_;
+    oCriteria.all_must_fail_noex_ = all_must_fail_noex_;
+    oCriteria.nTriggerNames_ = nTriggerNames_;
+    oCriteria.notStarPresent_ = notStarPresent_;
+    oCriteria.compiled_ = compiled_;
+  }
+
+  void
+  EventSelector::restoreCriteria(Criteria const& iCriteria)
+  {
+    accept_all_ = iCriteria.accept_all_;
+    absolute_acceptors_ = iCriteria.absolute_acceptors_;
+    conditional_acceptors_ = iCriteria.conditional_acceptors_;
+    exception_acceptors_ = iCriteria.exception_acceptors_;
+    all_must_fail_ = iCriteria.all_must_fail_;
+    all_must_fail_noex_ = iCriteria.all_must_fail_noex_;
+    nTriggerNames_ = iCriteria.nTriggerNames_;
+    notStarPresent_ = iCriteria.notStarPresent_;
+    compiled_ = iCriteria.compiled_;
+  }
   
   bool EventSelector::acceptEvent(TriggerResults const& tr)
   {
@@ -284,31 +403,41 @@ namespace edm
       // then the names have not changed and we can skip this initialization.
       if (!(psetID_initialized_ && psetID_ == tr.parameterSetID())) {
 
-        Strings triggernames;
-        bool fromPSetRegistry;
+        std::map<ParameterSetID, Criteria>::const_iterator itCached =
+          criteriaCache_.find(tr.parameterSetID());
+        if (itCached != criteriaCache_.end()) {
+          restoreCriteria(itCached->second);
+          psetID_ = tr.parameterSetID();
+          psetID_initialized_ = true;
+        }
+        else {
+          Strings triggernames;
+          bool fromPSetRegistry;
 
-        Service<service::TriggerNamesService> tns;
-        if (tns->getTrigPaths(tr, triggernames, fromPSetRegistry)) {
+          Service<service::TriggerNamesService> tns;
+          if (tns->getTrigPaths(tr, triggernames, fromPSetRegistry)) {
 
-          init(paths_, triggernames);
+            init(paths_, triggernames);
 
-          if (fromPSetRegistry) {
-            psetID_ = tr.parameterSetID();
-            psetID_initialized_ = true;
+            if (fromPSetRegistry) {
+              psetID_ = tr.parameterSetID();
+              psetID_initialized_ = true;
+              saveCriteria(criteriaCache_[psetID_]);
+            }
+            else {
+              psetID_initialized_ = false;
+            }
           }
+          // This should never happen
           else {
-            psetID_initialized_ = false;
-          }
+            throw edm::Exception(errors::Unknown)
+              << "EventSelector::acceptEvent cannot find the trigger names for\n"
+                 "a process for which the configuration has requested that the\n"
+                 "OutputModule use TriggerResults to select events from.  This should\n"
+                 "be impossible, please send information to reproduce this problem to\n"
+                 "the edm developers.\n"; 
+	  }
         }
-        // This should never happen
-        else {
-          throw edm::Exception(errors::Unknown)
-            << "EventSelector::acceptEvent cannot find the trigger names for\n"
-               "a process for which the configuration has requested that the\n"
-               "OutputModule use TriggerResults to select events from.  This should\n"
-               "be impossible, please send information to reproduce this problem to\n"
-               "the edm developers.\n"; 
-	}
       }
     }
 
@@ -336,27 +465,30 @@ namespace edm
 
     if (accept_all_) return true;
 
-    // Form HLTGlobalStatus object to represent the array_of_trigger_results
-    HLTGlobalStatus tr(number_of_trigger_paths);
-    int byteIndex = 0;
-    int subIndex  = 0;
-    for (int pathIndex = 0; pathIndex < number_of_trigger_paths; ++pathIndex)
-    {
-      int state = array_of_trigger_results[byteIndex] >> (subIndex * 2);
-      state &= 0x3;
-      HLTPathStatus pathStatus(static_cast<hlt::HLTState>(state));
-      tr[pathIndex] = pathStatus;
-      ++subIndex;
-      if (subIndex == 4)
-      { ++byteIndex;
-        subIndex = 0;
-      }
-    }    
+    // The bytes hold 4 paths each, in the same layout as the packed words
+    unsigned int nWords = wordsFor(number_of_trigger_paths);
+    cms_uint64_t local[kLocalWords];
+    std::vector<cms_uint64_t> heap;
+    cms_uint64_t* packed = local;
+    if (nWords > kLocalWords) {
+      heap.resize(nWords);
+      packed = &heap[0];
+    }
+    std::fill(packed, packed + nWords, 0ULL);
+    unsigned int nBytes = (number_of_trigger_paths + 3) / 4;
+    for (unsigned int byteIndex = 0; byteIndex != nBytes; ++byteIndex) {
+      packed[byteIndex / 8] |= 
+        static_cast<cms_uint64_t>(array_of_trigger_results[byteIndex]) << (8 * (byteIndex % 8));
+    }
+    // ignore whatever follows the last path in its byte
+    unsigned int lastPaths = number_of_trigger_paths % kPathsPerWord;
+    if (lastPaths != 0) {
+      packed[nWords - 1] &= (1ULL << (2 * lastPaths)) - 1;
+    }
 
-    // Now make the decision, based on the HLTGlobalStatus tr,
-    // which we have created from the supplied array of results
+    // Now make the decision, based on the packed array of results
     
-    return selectionDecision(tr);
+    return selectionDecision(packed, nWords);
 
   } // acceptEvent(array_of_trigger_results, number_of_trigger_paths)
 
@@ -365,37 +497,73 @@ namespace edm
   {
     if (accept_all_) return true;
 
+    unsigned int nPaths = tr.size();
+    unsigned int nWords = wordsFor(nPaths);
+    cms_uint64_t local[kLocalWords];
+    std::vector<cms_uint64_t> heap;
+    cms_uint64_t* packed = local;
+    if (nWords > kLocalWords) {
+      heap.resize(nWords);
+      packed = &heap[0];
+    }
+    std::fill(packed, packed + nWords, 0ULL);
+    for (unsigned int i = 0; i != nPaths; ++i) {
+      packed[i / kPathsPerWord] |= 
+        static_cast<cms_uint64_t>(tr[i].state() & 0x3) << (2 * (i % kPathsPerWord));
+    }
+    return selectionDecision(packed, nWords);
+  }
+
+  // The packed states are Ready 00, Pass 01, Fail 10 and Exception 11.  For
+  // each word the paths in each state are found as a mask of low bits, which
+  // is then compared with the compiled masks.
+  bool 
+  EventSelector::selectionDecision(cms_uint64_t const* packedResults,
+                                   unsigned int nWords) const
+  {
+    if (accept_all_) return true;
+
+    cms_uint64_t localPass[kLocalWords], localFail[kLocalWords], localException[kLocalWords];
+    std::vector<cms_uint64_t> heap;
+    cms_uint64_t* pass = localPass;
+    cms_uint64_t* fail = localFail;
+    cms_uint64_t* exception = localException;
+    if (nWords > kLocalWords) {
+      heap.resize(3 * nWords);
+      pass = &heap[0];
+      fail = pass + nWords;
+      exception = fail + nWords;
+    }
     bool exceptionPresent = false;
-    bool exceptionsLookedFor = false;
-    
-    if (acceptOneBit(absolute_acceptors_, tr)) return true;
-    if (acceptOneBit(conditional_acceptors_, tr)) {
-      exceptionPresent = containsExceptions(tr);
-      if (!exceptionPresent) return true;
-      exceptionsLookedFor = true;
+    for (unsigned int w = 0; w != nWords; ++w) {
+      cms_uint64_t low = packedResults[w] & kLowBits;
+      cms_uint64_t high = (packedResults[w] >> 1) & kLowBits;
+      pass[w] = low & ~high;
+      fail[w] = high & ~low;
+      exception[w] = low & high;
+      exceptionPresent = exceptionPresent || exception[w] != 0;
     }
-    if (acceptOneBit(exception_acceptors_, tr, hlt::Exception)) return true;
 
-    for (std::vector<Bits>::const_iterator f =  all_must_fail_.begin();
-    					   f != all_must_fail_.end(); ++f)
+    if (anyOf(pass, compiled_.absolutePass_, nWords) ||
+        anyOf(fail, compiled_.absoluteFail_, nWords)) return true;
+    if ((anyOf(pass, compiled_.conditionalPass_, nWords) ||
+         anyOf(fail, compiled_.conditionalFail_, nWords)) && !exceptionPresent) return true;
+    if (anyOf(exception, compiled_.exception_, nWords)) return true;
+
+    for (std::vector<Mask>::const_iterator f = compiled_.mustFail_.begin();
+    					   f != compiled_.mustFail_.end(); ++f)
     {
-      if (acceptAllBits(*f, tr)) return true;
+      if (allOf(fail, *f, nWords)) return true;
     }
-    for (std::vector<Bits>::const_iterator fn =  all_must_fail_noex_.begin();
-    					   fn != all_must_fail_noex_.end(); ++fn)
+
+    for (std::vector<Mask>::const_iterator fn = compiled_.mustFailNoex_.begin();
+    					   fn != compiled_.mustFailNoex_.end(); ++fn)
     {
-      if (acceptAllBits(*fn, tr)) {
-        if (!exceptionsLookedFor) exceptionPresent = containsExceptions(tr);
-        return (!exceptionPresent);
-      }
+      if (allOf(fail, *fn, nWords)) return !exceptionPresent;
     }
-    
-    // If we have not accepted based on any of the acceptors, nor on any one of
-    // the all_must_fail_ collections, then we reject this event.
-    
+
     return false;
-  
-  }  // selectionDecision()
+  }
 
 // Obsolete...
   bool EventSelector::acceptTriggerPath(HLTPathStatus const& pathStatus,
@@ -406,42 +574,6 @@ namespace edm
             ((pathStatus.state()==hlt::Exception)));
   }
 
-  // Indicate if any bit in the trigger results matches the desired value
-  // at that position, based on the Bits array.  If s is Exception, this
-  // looks for a Exceptionmatch; otherwise, true-->Pass, false-->Fail.
-  bool 
-  EventSelector::acceptOneBit(Bits const& b, 
-    		       	       HLTGlobalStatus const& tr, 
-    		               hlt::HLTState const& s) const
-  {
-    bool lookForException = (s == hlt::Exception);
-    Bits::const_iterator i(b.begin());
-    Bits::const_iterator e(b.end());
-    for(;i!=e;++i) {
-      hlt::HLTState bstate = 
-          lookForException ? hlt::Exception
-      			   : i->accept_state_ ? hlt::Pass
-				              : hlt::Fail;
-      if (tr[i->pos_].state() == bstate) return true;
-    }
-    return false;    
-  } // acceptOneBit			       
-
-  // Indicate if *every* bit in the trigger results matches the desired value
-  // at that position, based on the Bits array: true-->Pass, false-->Fail.
-  bool 
-  EventSelector::acceptAllBits(Bits const& b, 
-    		        	HLTGlobalStatus const& tr) const
-  {
-    Bits::const_iterator i(b.begin());
-    Bits::const_iterator e(b.end());
-    for(;i!=e;++i) {
-      hlt::HLTState bstate = i->accept_state_ ? hlt::Pass : hlt::Fail;
-      if (tr[i->pos_].state() != bstate) return false;
-    }
-    return true;    
-  } // acceptAllBits			       
-
   /**
    * Tests if the specified trigger selection list (path spec) is valid
    * in the context of the specified full trigger list.  Each element in
@@ -23,6 +23,7 @@
 #include "FWCore/Framework/interface/EventSetupRecordProviderFactoryManager.h"
 #include "FWCore/Framework/interface/EventSetupRecord.h"
 #include "FWCore/Framework/interface/DataProxyProvider.h"
+#include "FWCore/Framework/interface/DependentRecordIntervalFinder.h"
 #include "FWCore/Framework/interface/EventSetupRecordIntervalFinder.h"
 #include "FWCore/Framework/interface/ModuleFactory.h"
 #include "FWCore/Framework/interface/ParameterSetIDHolder.h"
@@ -744,6 +745,44 @@ EventSetupProvider::eventSetupForInstance(const IOVSyncValue& iValue)
    return eventSetup_;
 }
 
+bool
+EventSetupProvider::presentRecordsAreValidFor(IOVSyncValue const& iValue)
+{
+   for(auto const& keyAndRecord : eventSetup_.recordMap_) {
+      if(not keyAndRecord.second->validityInterval().validFor(iValue)) {
+         return false;
+      }
+   }
+   //A Record which is missing becomes valid once its finder has an interval for iValue.
+   // Only the finder is asked so neither the Record nor its proxies change.
+   for(auto const& keyAndProvider : providers_) {
+      if(0 != eventSetup_.find(keyAndProvider.first)) {
+         continue;
+      }
+      boost::shared_ptr<EventSetupRecordIntervalFinder> finder = keyAndProvider.second->finder();
+      //A Record without a finder never becomes valid. The interval of a dependent Record
+      // follows those of the Records it depends on, which were checked above, and asking
+      // for it would update their providers.
+      if(0 == finder.get() || 0 != dynamic_cast<DependentRecordIntervalFinder*>(finder.get())) {
+         continue;
+      }
+      if(finder->findIntervalFor(keyAndProvider.first, iValue).first() != IOVSyncValue::invalidIOVSyncValue()) {
+         return false;
+      }
+   }
+   return true;
+}
+
+std::set<EventSetupRecordKey>
+EventSetupProvider::dependentRecords(EventSetupRecordKey const& iKey) const
+{
+   Providers::const_iterator itFound = providers_.find(iKey);
+   if(itFound == providers_.end()) {
+      return std::set<EventSetupRecordKey>();
+   }
+   return itFound->second->dependentRecords();
+}
+
 namespace {
    struct InsertAll : public std::unary_function< const std::set<ComponentDescription>&, void>{
       
@@ -12,6 +12,7 @@
 
 // system include files
 #include <assert.h>
+#include <atomic>
 #include <string>
 #include <exception>
 
@@ -33,6 +34,7 @@ namespace edm {
 //
 // static data member definitions
 //
+static std::atomic<unsigned long long> s_lastProxiesIdentifier(0);
 
 //
 // constructors and destructor
@@ -40,6 +42,8 @@ namespace edm {
 EventSetupRecord::EventSetupRecord() :
 validity_(),
 proxies_(),
+proxyIndex_(),
+proxiesIdentifier_(++s_lastProxiesIdentifier),
 eventSetup_(0),
 cacheIdentifier_(1), //start with 1 since 0 means we haven't checked yet
 transientAccessRequested_(false)
@@ -76,6 +80,12 @@ EventSetupRecord::set(const ValidityInterval& iInterval)
    validity_ = iInterval;
 }
 
+void
+EventSetupRecord::setNewProxiesIdentifier()
+{
+   proxiesIdentifier_ = ++s_lastProxiesIdentifier;
+}
+
 void
 EventSetupRecord::getESProducers(std::vector<ComponentDescription const*>& esproducers) {
    esproducers.clear();
@@ -116,6 +126,8 @@ EventSetupRecord::add(const DataKey& iKey ,
       assert(iProxy->providerDescription());
       if(iProxy->providerDescription()->isLooper_) {
          (*proxies_.find(iKey)).second = iProxy ;
+         proxyIndex_.find(iKey)->second = iProxy;
+         setNewProxiesIdentifier();
 	 return true;
       }
 	 
@@ -132,13 +144,16 @@ EventSetupRecord::add(const DataKey& iKey ,
          <<"\n   or use an es_prefer statement in the configuration to choose one.";
       } else if(proxy->providerDescription()->isSource_) {
          (*proxies_.find(iKey)).second = iProxy ;
+         proxyIndex_.find(iKey)->second = iProxy;
       } else {
          return false;
       }
    }
    else {
       proxies_.insert(Proxies::value_type(iKey , iProxy)) ;
+      proxyIndex_.insert(Proxies::value_type(iKey , iProxy));
    }
+   setNewProxiesIdentifier();
    return true ;
 }
 
@@ -146,6 +161,8 @@ void
 EventSetupRecord::clearProxies() 
 {
    proxies_.clear();
+   proxyIndex_.clear();
+   setNewProxiesIdentifier();
 }
 
 void 
@@ -171,11 +188,18 @@ const void*
 EventSetupRecord::getFromProxy(DataKey const & iKey ,
                                const ComponentDescription*& iDesc,
                                bool iTransientAccessOnly) const
+{
+   return getFromProxy(this->find(iKey), iKey, iDesc, iTransientAccessOnly);
+}
+
+const void* 
+EventSetupRecord::getFromProxy(const DataProxy* proxy,
+                               DataKey const & iKey ,
+                               const ComponentDescription*& iDesc,
+                               bool iTransientAccessOnly) const
 {
    if(iTransientAccessOnly) { this->transientAccessRequested(); }
 
-   const DataProxy* proxy = this->find(iKey);
-   
    const void* hold = 0;
    
    if(0!=proxy) {
@@ -204,8 +228,8 @@ EventSetupRecord::getFromProxy(DataKey const & iKey ,
 const DataProxy* 
 EventSetupRecord::find(const DataKey& iKey) const 
 {
-   Proxies::const_iterator entry(proxies_.find(iKey)) ;
-   if (entry != proxies_.end()) {
+   auto entry = proxyIndex_.find(iKey);
+   if (entry != proxyIndex_.end()) {
       return entry->second;
    }
    return 0;
@@ -64,7 +64,18 @@ EventSetupRecordIntervalFinder::findIntervalFor(const EventSetupRecordKey& iKey,
    Intervals::iterator itFound = intervals_.find(iKey);
    assert(itFound != intervals_.end()) ;
    if(! itFound->second.validFor(iInstance)) {
-      setIntervalFor(iKey, iInstance, itFound->second);
+      if(hasFixedIntervals()) {
+         ValidityIntervalIndex& index = indexes_[iKey];
+         ValidityInterval const* indexed = index.find(iInstance);
+         if(0 != indexed) {
+            itFound->second = *indexed;
+         } else {
+            setIntervalFor(iKey, iInstance, itFound->second);
+            index.insert(itFound->second);
+         }
+      } else {
+         setIntervalFor(iKey, iInstance, itFound->second);
+      }
    }
    return itFound->second;
 }
@@ -82,6 +93,12 @@ EventSetupRecordIntervalFinder::delaySettingRecords()
 //
 // const member functions
 //
+bool
+EventSetupRecordIntervalFinder::hasFixedIntervals() const
+{
+   return hasFixedIntervals_;
+}
+
 std::set<EventSetupRecordKey> 
 EventSetupRecordIntervalFinder::findingForRecords() const
 {
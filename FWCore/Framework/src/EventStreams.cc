@@ -0,0 +1,152 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     EventStreams
+//
+// Implementation:
+//     Each stream has its own TaskGroup so we can wait for one particular
+//     stream. Busy streams are waited for in the order their work was started.
+//     When the work is done in order, the task doing one work starts the task
+//     for the next, so by the time the oldest busy stream is waited for its
+//     task has always been given to its TaskGroup.
+//
+// $Id$
+//
+
+// system include files
+#include <cassert>
+
+// user include files
+#include "FWCore/Framework/src/EventStreams.h"
+
+using namespace edm;
+
+//
+// constructors and destructor
+//
+EventStreams::EventStreams(TaskScheduler& iScheduler, unsigned int iNumberOfStreams, bool iInOrder):
+  numberOfStreams_(iNumberOfStreams),
+  tasks_(),
+  exceptions_(iNumberOfStreams),
+  idleStreams_(),
+  busyStreams_(),
+  inOrder_(iInOrder),
+  orderMutex_(),
+  running_(false),
+  failed_(false),
+  waiting_()
+{
+  assert(iNumberOfStreams > 0);
+  tasks_.reserve(iNumberOfStreams);
+  idleStreams_.reserve(iNumberOfStreams);
+  for(unsigned int i = 0; i != iNumberOfStreams; ++i) {
+    tasks_.emplace_back(new TaskScheduler::TaskGroup(iScheduler));
+  }
+  //put stream 0 on the top of the stack so it is used first
+  for(unsigned int i = iNumberOfStreams; i != 0; --i) {
+    idleStreams_.push_back(i-1);
+  }
+}
+
+EventStreams::~EventStreams()
+{
+  waitForAll(false);
+}
+
+//
+// member functions
+//
+unsigned int
+EventStreams::waitForIdleStream()
+{
+  if(idleStreams_.empty()) {
+    assert(not busyStreams_.empty());
+    unsigned int stream = busyStreams_.front();
+    busyStreams_.pop_front();
+    std::exception_ptr exception = waitFor(stream);
+    if(exception) {
+      std::rethrow_exception(exception);
+    }
+  }
+  return idleStreams_.back();
+}
+
+void
+EventStreams::run(unsigned int iStream, std::function<void()> iWork)
+{
+  assert(not idleStreams_.empty() and idleStreams_.back() == iStream);
+  idleStreams_.pop_back();
+  busyStreams_.push_back(iStream);
+  if(inOrder_) {
+    std::lock_guard<std::mutex> guard(orderMutex_);
+    if(running_) {
+      waiting_.emplace_back(iStream, iWork);
+      return;
+    }
+    running_ = true;
+  }
+  start(iStream, iWork);
+}
+
+void
+EventStreams::start(unsigned int iStream, std::function<void()> const& iWork)
+{
+  std::exception_ptr& exception = exceptions_[iStream];
+  tasks_[iStream]->run([this, iWork, &exception]() {
+    try {
+      //failed_ is only changed by the previous work, which finished before this one started
+      if(not failed_) {
+        iWork();
+      }
+    } catch(...) {
+      exception = std::current_exception();
+      if(inOrder_) {
+        failed_ = true;
+      }
+    }
+    if(inOrder_) {
+      startNext();
+    }
+  });
+}
+
+void
+EventStreams::startNext()
+{
+  std::lock_guard<std::mutex> guard(orderMutex_);
+  if(waiting_.empty()) {
+    running_ = false;
+    return;
+  }
+  std::pair<unsigned int, std::function<void()> > next(std::move(waiting_.front()));
+  waiting_.pop_front();
+  start(next.first, next.second);
+}
+
+void
+EventStreams::waitForAll(bool iRethrow)
+{
+  std::exception_ptr first;
+  while(not busyStreams_.empty()) {
+    unsigned int stream = busyStreams_.front();
+    busyStreams_.pop_front();
+    std::exception_ptr exception = waitFor(stream);
+    if(exception and not first) {
+      first = exception;
+    }
+  }
+  failed_ = false;
+  if(first and iRethrow) {
+    std::rethrow_exception(first);
+  }
+}
+
+std::exception_ptr
+EventStreams::waitFor(unsigned int iStream)
+{
+  tasks_[iStream]->wait();
+  idleStreams_.push_back(iStream);
+  std::exception_ptr exception;
+  exception.swap(exceptions_[iStream]);
+  return exception;
+}
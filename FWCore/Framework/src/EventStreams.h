@@ -0,0 +1,105 @@
+#ifndef FWCore_Framework_EventStreams_h
+#define FWCore_Framework_EventStreams_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     EventStreams
+//
+/**\class EventStreams EventStreams.h FWCore/Framework/src/EventStreams.h
+
+ Description: Keeps track of which event streams are idle and runs the work for a stream as a task of the TaskScheduler
+
+ Usage:
+    The EventProcessor asks for an idle stream with waitForIdleStream, reads the next
+    event into the EventPrincipal of that stream and then hands the processing of the
+    event to run. Before any transition which is not an event the EventProcessor calls
+    waitForAll so that no event is still being processed.
+
+    An exception thrown by the work for a stream is held and rethrown from the call to
+    waitForIdleStream or waitForAll which finds the stream finished.
+
+    If constructed with iInOrder set, the work given to run is done one at a time in the
+    order it was given, each starting once the previous one has finished. The streams are
+    then a bounded queue of events which have been read but not yet processed. Once a
+    work has thrown, the work queued after it is not done.
+
+    All member functions must be called from the same thread. While waiting that thread
+    takes part in running the tasks so no stream can be starved of a thread.
+
+    With more than one stream the ActivityRegistry signals for events, paths and modules
+    are emitted from the threads of the streams at the same time, only the signals for
+    runs, luminosity blocks and the EndPaths are emitted one at a time. Of the services in
+    FWCore only ModuleLatency keeps its state per thread. LockService still lets only one
+    of the listed modules run at a time and the lines printed by Tracer are interleaved.
+    Timing, SimpleMemoryCheck, EnableFloatingPointExceptions, UpdaterService and the module
+    tracking of the MessageLogger keep the state of the current event or module in a data
+    member and will report mixed up values, so they should not be used with more than one
+    stream.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "boost/utility.hpp"
+
+// user include files
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
+
+// forward declarations
+namespace edm {
+  class EventStreams : private boost::noncopyable
+  {
+
+  public:
+    EventStreams(TaskScheduler& iScheduler, unsigned int iNumberOfStreams, bool iInOrder = false);
+    ~EventStreams();
+
+    // ---------- const member functions ---------------------
+    unsigned int size() const { return numberOfStreams_; }
+    bool inOrder() const { return inOrder_; }
+
+    // ---------- member functions ---------------------------
+    ///returns the index of an idle stream, first waiting for the oldest busy stream
+    /// to finish if none is idle. The stream stays idle until it is passed to run.
+    unsigned int waitForIdleStream();
+
+    ///runs iWork asynchronously on the stream last returned by waitForIdleStream,
+    /// the stream becomes idle again once iWork has finished
+    void run(unsigned int iStream, std::function<void()> iWork);
+
+    ///blocks until all streams are idle. If iRethrow is true, rethrows the exception
+    /// from the earliest started work which failed
+    void waitForAll(bool iRethrow = true);
+
+  private:
+    std::exception_ptr waitFor(unsigned int iStream);
+    void start(unsigned int iStream, std::function<void()> const& iWork);
+    void startNext();
+
+    // ---------- member data --------------------------------
+    unsigned int numberOfStreams_;
+    std::vector<std::unique_ptr<TaskScheduler::TaskGroup> > tasks_;
+    std::vector<std::exception_ptr> exceptions_;
+    std::vector<unsigned int> idleStreams_;
+    std::deque<unsigned int> busyStreams_;
+
+    //only used if the work is done in order
+    bool inOrder_;
+    std::mutex orderMutex_;
+    bool running_;
+    bool failed_;
+    std::deque<std::pair<unsigned int, std::function<void()> > > waiting_;
+  };
+}
+
+#endif
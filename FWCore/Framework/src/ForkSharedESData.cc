@@ -0,0 +1,40 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ForkSharedESData
+//
+// Implementation:
+//     The key names the Record, the data and the ESProducer making it together with the
+//     start of the IOV. The ParameterSetID of the producer tells apart producers of the
+//     same type and label, e.g. those of a SubProcess.
+//
+// $Id$
+//
+
+// system include files
+#include <sstream>
+
+// user include files
+#include "FWCore/Framework/interface/ForkSharedESData.h"
+#include "FWCore/Framework/interface/ComponentDescription.h"
+#include "FWCore/Framework/interface/EventSetupRecord.h"
+#include "FWCore/Framework/interface/EventSetupRecordKey.h"
+#include "FWCore/Framework/interface/ValidityInterval.h"
+
+namespace edm {
+   namespace eventsetup {
+      std::string
+      forkSharedESDataKey(EventSetupRecord const& iRecord, DataKey const& iDataKey) {
+         std::ostringstream key;
+         key << iRecord.key().name() << '/' << iDataKey.type().name() << '/' << iDataKey.name().value();
+         ComponentDescription const* description = iRecord.providerDescription(iDataKey);
+         if(0 != description) {
+            key << '/' << description->type_ << '/' << description->label_ << '/' << description->pid_;
+         }
+         IOVSyncValue const& first = iRecord.validityInterval().first();
+         key << '/' << first.eventID().run() << ':' << first.eventID().luminosityBlock() << ':' << first.eventID().event()
+             << '/' << first.time().value();
+         return key.str();
+      }
+   }
+}
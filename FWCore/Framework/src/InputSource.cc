@@ -24,6 +24,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/Utilities/interface/do_nothing_deleter.h"
 #include "FWCore/Utilities/interface/GlobalIdentifier.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 #include "FWCore/Utilities/interface/RandomNumberGenerator.h"
 #include "FWCore/Utilities/interface/TimeOfDay.h"
 
@@ -185,6 +186,9 @@ namespace edm {
 
   InputSource::ItemType
   InputSource::nextItemType() {
+    // Events may be processed, and so products read or written, on other threads
+    // while the source moves on
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     ItemType oldState = state_;
     if(eventLimitReached()) {
       // If the maximum event limit has been reached, stop.
@@ -260,6 +264,7 @@ namespace edm {
   // Return a dummy file block.
   boost::shared_ptr<FileBlock>
   InputSource::readFile() {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     assert(state_ == IsFile);
     assert(!limitReached());
     boost::shared_ptr<FileBlock> fb = callWithTryCatchAndPrint<boost::shared_ptr<FileBlock> >( [this](){ return readFile_(); },
@@ -269,6 +274,7 @@ namespace edm {
 
   void
   InputSource::closeFile(boost::shared_ptr<FileBlock> fb, bool cleaningUpAfterException) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     if(fb) fb->close();
     callWithTryCatchAndPrint<void>( [this](){ closeFile_(); },
                                     "Calling InputSource::closeFile_",
@@ -286,6 +292,7 @@ namespace edm {
 
   boost::shared_ptr<RunPrincipal>
   InputSource::readAndCacheRun(HistoryAppender& historyAppender) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     RunSourceSentry sentry(*this);
     boost::shared_ptr<RunPrincipal> rp(new RunPrincipal(runAuxiliary(), productRegistry_, processConfiguration(), &historyAppender));
     callWithTryCatchAndPrint<boost::shared_ptr<RunPrincipal> >( [this,&rp](){ return readRun_(rp); }, "Calling InputSource::readRun_" );
@@ -294,12 +301,14 @@ namespace edm {
 
   void
   InputSource::readAndMergeRun(boost::shared_ptr<RunPrincipal> rp) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     RunSourceSentry sentry(*this);
     callWithTryCatchAndPrint<boost::shared_ptr<RunPrincipal> >( [this,&rp](){ return readRun_(rp); }, "Calling InputSource::readRun_" );
   }
 
   boost::shared_ptr<LuminosityBlockPrincipal>
   InputSource::readAndCacheLumi(HistoryAppender& historyAppender) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     LumiSourceSentry sentry(*this);
     boost::shared_ptr<LuminosityBlockPrincipal> lbp(
       new LuminosityBlockPrincipal(luminosityBlockAuxiliary(),
@@ -316,6 +325,7 @@ namespace edm {
 
   void
   InputSource::readAndMergeLumi(boost::shared_ptr<LuminosityBlockPrincipal> lbp) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     LumiSourceSentry sentry(*this);
     callWithTryCatchAndPrint<boost::shared_ptr<LuminosityBlockPrincipal> >( [this,&lbp](){ return readLuminosityBlock_(lbp); },
                                                                             "Calling InputSource::readLuminosityBlock_" );
@@ -341,6 +351,7 @@ namespace edm {
 
   EventPrincipal*
   InputSource::readEvent(EventPrincipal& ep) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     assert(state_ == IsEvent);
     assert(!eventLimitReached());
 
@@ -362,6 +373,7 @@ namespace edm {
 
   EventPrincipal*
   InputSource::readEvent(EventPrincipal& ep, EventID const& eventID) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     EventPrincipal* result = 0;
 
     if(!limitReached()) {
@@ -381,16 +393,19 @@ namespace edm {
 
   void
   InputSource::skipEvents(int offset) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     callWithTryCatchAndPrint<void>( [this,&offset](){ skip(offset); }, "Calling InputSource::skip" );
   }
 
   bool
   InputSource::goToEvent(EventID const& eventID) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     return callWithTryCatchAndPrint<bool>( [this,&eventID](){ return goToEvent_(eventID); }, "Calling InputSource::goToEvent_" );
   }
 
   void
   InputSource::rewind() {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     state_ = IsInvalid;
     remainingEvents_ = maxEvents_;
     setNewRun();
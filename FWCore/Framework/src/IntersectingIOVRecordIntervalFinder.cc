@@ -64,6 +64,21 @@ IntersectingIOVRecordIntervalFinder::swapFinders(std::vector<boost::shared_ptr<E
    finders_.swap(iFinders);
 }
 
+bool
+IntersectingIOVRecordIntervalFinder::hasFixedIntervals() const
+{
+   if(finders_.empty()) {
+      return false;
+   }
+   for(std::vector<boost::shared_ptr<EventSetupRecordIntervalFinder> >::const_iterator it = finders_.begin(),
+       itEnd = finders_.end(); it != itEnd; ++it) {
+      if(!(*it)->hasFixedIntervals()) {
+         return false;
+      }
+   }
+   return true;
+}
+
 void 
 IntersectingIOVRecordIntervalFinder::setIntervalFor(const EventSetupRecordKey& iKey,
                                                     const IOVSyncValue& iTime, 
@@ -37,7 +37,9 @@ namespace edm {
          virtual ~IntersectingIOVRecordIntervalFinder();
          
          // ---------- const member functions ---------------------
-         
+         ///the intersections are fixed if the intervals of all the Finders are
+         virtual bool hasFixedIntervals() const;
+
          // ---------- static member functions --------------------
          
          // ---------- member functions ---------------------------
@@ -5,6 +5,7 @@
 #include "FWCore/Framework/interface/ProductHolder.h"
 #include "FWCore/Framework/interface/RunPrincipal.h"
 #include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 
 namespace edm {
 
@@ -64,6 +65,7 @@ namespace edm {
     if(!reader()) return; // nothing to do.
 
     // must attempt to load from persistent store
+    boost::recursive_mutex::scoped_lock ioLock(*rootfix::getIOMutex());
     BranchKey const bk = BranchKey(phb.branchDescription());
     WrapperOwningHolder edp(reader()->getProduct(bk, phb.productData().getInterface(), this));
 
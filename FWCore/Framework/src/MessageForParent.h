@@ -11,7 +11,9 @@
 
  Usage:
     This class is an internal detail of how the child process communicates with the parent.
- It is sent across a Unix socket to the parent to indicate that the child needs work.
+ It is sent across a Unix socket to the parent to indicate that the child needs work. It also
+ tells how many events the child processed since it was last given work and how long it took,
+ which the parent uses to size the next block of events.
 
 */
 //
@@ -32,7 +34,7 @@ namespace edm {
       class MessageForParent
       {
       public:
-         MessageForParent(): m_dummy(0) {}
+         MessageForParent(): nEventsProcessed(0), processingTime(0.) {}
          
          //virtual ~MessageForSource();
          
@@ -52,7 +54,8 @@ namespace edm {
          //const MessageForSource& operator=(const MessageForSource&); // allow default
          
          // ---------- member data --------------------------------
-         int m_dummy;
+         unsigned long nEventsProcessed; //number of events in the previous block, 0 for the first request
+         double processingTime; //seconds between receiving the previous block and this request
 
       };
 
@@ -17,6 +17,7 @@
 #include <sys/socket.h>
 #include <errno.h>
 #include <string.h>
+#include <time.h>
 
 // user include files
 #include "FWCore/Framework/interface/MessageReceiverForSource.h"
@@ -28,6 +29,13 @@ using namespace edm::multicore;
 //
 // constants, enums and typedefs
 //
+namespace {
+   double monotonicSeconds() {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      return now.tv_sec + 1e-9 * now.tv_nsec;
+   }
+}
 
 //
 // static data member definitions
@@ -40,6 +48,7 @@ MessageReceiverForSource::MessageReceiverForSource(int parentSocket, int parentP
 m_parentSocket(parentSocket),
 m_parentPipe(parentPipe),
 m_maxFd(parentPipe),
+m_blockReceivedTime(0.),
 m_startIndex(0),
 m_numberOfConsecutiveIndices(0),
 m_numberToSkip(0)
@@ -100,6 +109,11 @@ MessageReceiverForSource::receive()
 
    {
       MessageForParent parentMessage;
+      //the source only asks for more work once it processed all the events of the previous block
+      parentMessage.nEventsProcessed = previousConsecutiveIndices;
+      if(0 != previousConsecutiveIndices) {
+         parentMessage.processingTime = monotonicSeconds() - m_blockReceivedTime;
+      }
       errno = 0;
 
       // If parent has died, this will fail with "connection refused"
@@ -166,6 +180,7 @@ MessageReceiverForSource::receive()
       m_startIndex = message.startIndex;
       m_numberOfConsecutiveIndices = message.nIndices;
       m_numberToSkip = m_startIndex-previousStartIndex-previousConsecutiveIndices;
+      m_blockReceivedTime = monotonicSeconds();
 
       //printf("Start index: %lu, number consecutive: %lu, number to skip: %lu\n", m_startIndex, m_numberOfConsecutiveIndices, m_numberToSkip);
    }
@@ -20,6 +20,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
 #include "FWCore/Utilities/interface/DebugMacros.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 
 #include <cassert>
 
@@ -295,7 +296,11 @@ namespace edm {
         return true;
       }
     }
-    write(ep);
+    {
+      // the source may be reading the next events on another thread
+      boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
+      write(ep);
+    }
     updateBranchParents(ep);
     if(remainingEvents_ > 0) {
       --remainingEvents_;
@@ -342,6 +347,7 @@ namespace edm {
   void
   OutputModule::doWriteRun(RunPrincipal const& rp) {
     FDEBUG(2) << "writeRun called\n";
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     writeRun(rp);
   }
 
@@ -367,18 +373,22 @@ namespace edm {
 
   void OutputModule::doWriteLuminosityBlock(LuminosityBlockPrincipal const& lbp) {
     FDEBUG(2) << "writeLuminosityBlock called\n";
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     writeLuminosityBlock(lbp);
   }
 
   void OutputModule::doOpenFile(FileBlock const& fb) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     openFile(fb);
   }
 
   void OutputModule::doRespondToOpenInputFile(FileBlock const& fb) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     respondToOpenInputFile(fb);
   }
 
   void OutputModule::doRespondToCloseInputFile(FileBlock const& fb) {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     respondToCloseInputFile(fb);
   }
 
@@ -400,11 +410,18 @@ namespace edm {
     postForkReacquireResources(iChildIndex, iNumberOfChildren);
   }
 
+  void
+  OutputModule::doMergeForkedChildrenOutputs(unsigned int iNumberOfChildren) {
+    mergeForkedChildrenOutputs(iNumberOfChildren);
+  }
+
   void OutputModule::maybeOpenFile() {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     if(!isFileOpen()) doOpenFile();
   }
 
   void OutputModule::doCloseFile() {
+    boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
     if(isFileOpen()) reallyCloseFile();
   }
 
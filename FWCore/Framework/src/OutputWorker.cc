@@ -48,6 +48,11 @@ namespace edm {
     module().doWriteLuminosityBlock(lbp);
   }
 
+  void
+  OutputWorker::mergeForkedChildrenOutputs(unsigned int iNumberOfChildren) {
+    module().doMergeForkedChildrenOutputs(iNumberOfChildren);
+  }
+
   bool OutputWorker::wantAllEvents() const {return module().wantAllEvents();}
 
   bool OutputWorker::limitReached() const {return module().limitReached();}
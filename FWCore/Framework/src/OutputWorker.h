@@ -43,6 +43,9 @@ namespace edm {
 
     bool limitReached() const;
 
+    // Call mergeForkedChildrenOutputs() on the controlled OutputModule.
+    void mergeForkedChildrenOutputs(unsigned int iNumberOfChildren);
+
     void configure(OutputModuleDescription const& desc);
     
     SelectionsArray const& keptProducts() const;
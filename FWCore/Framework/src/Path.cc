@@ -7,6 +7,7 @@
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 
 #include <algorithm>
+#include <cassert>
 #include "boost/bind.hpp"
 
 namespace edm {
@@ -28,6 +29,11 @@ namespace edm {
     actReg_(areg),
     act_table_(&actions),
     workers_(workers),
+    savedTimesRun_(),
+    savedTimesPassed_(),
+    savedTimesFailed_(),
+    savedTimesExcept_(),
+    savedWorkers_(),
     isEndPath_(isEndPath) {
   }
   
@@ -145,6 +151,51 @@ namespace edm {
     for_all(workers_, boost::bind(&WorkerInPath::clearCounters, _1));
   }
 
+  void
+  Path::saveCounters() {
+    savedTimesRun_ = timesRun_;
+    savedTimesPassed_ = timesPassed_;
+    savedTimesFailed_ = timesFailed_;
+    savedTimesExcept_ = timesExcept_;
+    savedWorkers_.resize(workers_.size());
+    for(WorkersInPath::size_type i = 0; i != workers_.size(); ++i) {
+      Worker const* worker = workers_[i].getWorker();
+      SavedWorker saved = {workers_[i].counters(), worker->counters(), worker->state() == Worker::Ready};
+      savedWorkers_[i] = saved;
+    }
+  }
+
+  void
+  Path::undoOccurrence() {
+    assert(savedWorkers_.size() == workers_.size());
+    timesRun_ = savedTimesRun_;
+    timesPassed_ = savedTimesPassed_;
+    timesFailed_ = savedTimesFailed_;
+    timesExcept_ = savedTimesExcept_;
+    for(WorkersInPath::size_type i = 0; i != workers_.size(); ++i) {
+      Worker* worker = workers_[i].getWorker();
+      workers_[i].setCounters(savedWorkers_[i].inPath_);
+      worker->setCounters(savedWorkers_[i].worker_);
+      if(savedWorkers_[i].wasReady_) {
+        worker->reset();
+      }
+    }
+    state_ = hlt::Ready;
+    (*trptr_)[bitpos_] = HLTPathStatus();
+  }
+
+  void
+  Path::addToCounters(Path const& other) {
+    assert(workers_.size() == other.workers_.size());
+    timesRun_ += other.timesRun_;
+    timesPassed_ += other.timesPassed_;
+    timesFailed_ += other.timesFailed_;
+    timesExcept_ += other.timesExcept_;
+    for(WorkersInPath::size_type i = 0; i != workers_.size(); ++i) {
+      workers_[i].addToCounters(other.workers_[i]);
+    }
+  }
+
   void
   Path::useStopwatch() {
     stopwatch_.reset(new RunStopwatch::StopwatchPointer::element_type);
@@ -69,6 +69,14 @@ namespace edm {
     }
 
     void clearCounters();
+    void addToCounters(Path const& other);
+
+    // Used when trigger paths run concurrently. saveCounters is called before the
+    // path is run for an event and undoOccurrence puts the counters, the states of
+    // its workers and its trigger bit back as they were then. It is used for a path
+    // which a serial run would not have reached since an earlier path threw.
+    void saveCounters();
+    void undoOccurrence();
 
     int timesRun() const { return timesRun_; }
     int timesPassed() const { return timesPassed_; }
@@ -105,6 +113,17 @@ namespace edm {
     WorkersInPath workers_;
     std::vector<EarlyDeleteHelper*> earlyDeleteHelpers_;
 
+    struct SavedWorker {
+      WorkerInPath::Counters inPath_;
+      Worker::Counters worker_;
+      bool wasReady_;
+    };
+    int savedTimesRun_;
+    int savedTimesPassed_;
+    int savedTimesFailed_;
+    int savedTimesExcept_;
+    std::vector<SavedWorker> savedWorkers_;
+
     bool isEndPath_;
 
     // Helper functions
@@ -328,12 +328,16 @@ namespace edm {
   Principal::getProductByIndex(ProductTransientIndex const& index, bool resolveProd, bool fillOnDemand) const {
 
     ConstProductPtr const phb = productHolders_[index].get();
-    if(nullptr == phb) {
+    if(nullptr == phb || !resolveProd) {
       return phb;
     }
-    if(resolveProd && !phb->productUnavailable()) {
-      this->resolveProduct(*phb, fillOnDemand);
+    {
+      std::lock_guard<std::recursive_mutex> guard(productMutex_);
+      if(phb->productUnavailable()) {
+        return phb;
+      }
     }
+    this->resolveProduct(*phb, fillOnDemand);
     return phb;
   }
 
@@ -360,6 +364,46 @@ namespace edm {
     return BasicHandle(*result);
   }
 
+  void
+  Principal::productIndexesByLabel(TypeID const& productType,
+                                   std::string const& label,
+                                   std::string const& productInstanceName,
+                                   std::string const& processName,
+                                   std::vector<ProductTransientIndex>& oIndexes) const {
+    oIndexes.clear();
+    TypeLookup const& typeLookup = preg_->productLookup();
+    std::pair<TypeLookup::const_iterator, TypeLookup::const_iterator> const range =
+        typeLookup.equal_range(TypeInBranchType(productType, branchType_), label, productInstanceName);
+    for(TypeLookup::const_iterator it = range.first; it != range.second; ++it) {
+      if(it->isFirst() && it != range.first) {
+        break;
+      }
+      if(processName.empty() || processName == it->branchDescription()->processName()) {
+        oIndexes.push_back(it->index());
+      }
+    }
+  }
+
+  BasicHandle
+  Principal::getByIndexes(TypeID const& productType,
+                          std::vector<ProductTransientIndex> const& indexes,
+                          InputTag const& tag) const {
+    if(indexes.empty()) {
+      // let getByLabel check for a missing dictionary and make the exception
+      size_t cachedOffset = 0;
+      int fillCount = -1;
+      return getByLabel(productType, tag.label(), tag.instance(), tag.process(), cachedOffset, fillCount);
+    }
+    for(auto index : indexes) {
+      ProductData const* result = findAvailableProduct(index, productType, tag.label(), tag.instance(), tag.process());
+      if(result != 0) {
+        return BasicHandle(*result);
+      }
+    }
+    boost::shared_ptr<cms::Exception> whyFailed = makeNotFoundException("getByToken", productType, tag.label(), tag.instance(), tag.process());
+    return BasicHandle(whyFailed);
+  }
+
   void
   Principal::getManyByType(TypeID const& productType,
                            BasicHandleVec& results) const {
@@ -413,19 +457,28 @@ namespace edm {
 
       //now see if the data is actually available
       ConstProductPtr const& productHolder = getProductByIndex(it->index(), false, false);
-      //NOTE sometimes 'productHolder->productUnavailable()' is true if was already deleted
-      if(productHolder && productHolder->productWasDeleted()) {
-        throwProductDeletedException("findProducts",
-                                     typeID,
-                                     bd.moduleLabel(),
-                                     bd.productInstanceName(),
-                                     bd.processName());
+      if(!productHolder) {
+        continue;
+      }
+      {
+        std::lock_guard<std::recursive_mutex> guard(productMutex_);
+        //NOTE sometimes 'productHolder->productUnavailable()' is true if was already deleted
+        if(productHolder->productWasDeleted()) {
+          throwProductDeletedException("findProducts",
+                                       typeID,
+                                       bd.moduleLabel(),
+                                       bd.productInstanceName(),
+                                       bd.processName());
+        }
+        // Skip product if not available.
+        if(productHolder->productUnavailable()) {
+          continue;
+        }
       }
 
-      // Skip product if not available.
-      if(productHolder && !productHolder->productUnavailable()) {
-
+      {
         this->resolveProduct(*productHolder, true);
+        std::lock_guard<std::recursive_mutex> guard(productMutex_);
         // If the product is a dummy filler, product holder will now be marked unavailable.
         // Unscheduled execution can fail to produce the EDProduct so check
         if(productHolder->product() && !productHolder->productUnavailable() && !productHolder->onDemand()) {
@@ -453,9 +506,14 @@ namespace edm {
     // A class without a dictionary cannot be in an Event/Lumi/Run.
     // First, we check if the class has a dictionary.  If it does not, we throw an exception.
     // The missing dictionary might be for the class itself, the wrapped class, or a component of the class.
-    std::pair<TypeLookup::const_iterator, TypeLookup::const_iterator> const range = typeLookup.equal_range(TypeInBranchType(typeID, branchType_));
+    std::pair<TypeLookup::const_iterator, TypeLookup::const_iterator> const range =
+        typeLookup.equal_range(TypeInBranchType(typeID, branchType_), moduleLabel, productInstanceName);
     if(range.first == range.second) {
-      maybeThrowMissingDictionaryException(typeID, &typeLookup == &preg_->elementLookup(), preg_->missingDictionaries());
+      std::pair<TypeLookup::const_iterator, TypeLookup::const_iterator> const typeRange = typeLookup.equal_range(TypeInBranchType(typeID, branchType_));
+      if(typeRange.first == typeRange.second) {
+        maybeThrowMissingDictionaryException(typeID, &typeLookup == &preg_->elementLookup(), preg_->missingDictionaries());
+      }
+      return count;
     }
 
     unsigned int processLevelFound = std::numeric_limits<unsigned int>::max();
@@ -467,24 +525,31 @@ namespace edm {
 
       ConstBranchDescription const& bd = *(it->branchDescription());
 
-      if ( moduleLabel == bd.moduleLabel() &&
-           productInstanceName == bd.productInstanceName() &&
-           (processName.empty() || processName == bd.processName())) {
+      if (processName.empty() || processName == bd.processName()) {
 
         //now see if the data is actually available
         ConstProductPtr const& productHolder = getProductByIndex(it->index(), false, false);
-        if(productHolder && productHolder->productWasDeleted()) {
-          throwProductDeletedException("findProduct",
-                                       typeID,
-                                       bd.moduleLabel(),
-                                       bd.productInstanceName(),
-                                       bd.processName());
+        if(!productHolder) {
+          continue;
+        }
+        {
+          std::lock_guard<std::recursive_mutex> guard(productMutex_);
+          if(productHolder->productWasDeleted()) {
+            throwProductDeletedException("findProduct",
+                                         typeID,
+                                         bd.moduleLabel(),
+                                         bd.productInstanceName(),
+                                         bd.processName());
+          }
+          // Skip product if not available.
+          if(productHolder->productUnavailable()) {
+            continue;
+          }
         }
 
-        // Skip product if not available.
-        if(productHolder && !productHolder->productUnavailable()) {
-
+        {
           this->resolveProduct(*productHolder, true);
+          std::lock_guard<std::recursive_mutex> guard(productMutex_);
           // If the product is a dummy filler, product holder will now be marked unavailable.
           // Unscheduled execution can fail to produce the EDProduct so check
           if(productHolder->product() && !productHolder->productUnavailable() && !productHolder->onDemand()) {
@@ -573,27 +638,48 @@ namespace edm {
       if(!processName.empty() && processName != it->branchDescription()->processName()) {
         continue;
       }
-      //now see if the data is actually available
-      ConstProductPtr const& productHolder = getProductByIndex(it->index(), false, false);
-      if(productHolder && productHolder->productWasDeleted()) {
+      ProductData const* result = findAvailableProduct(it->index(), typeID, moduleLabel, productInstanceName, processName);
+      if(result != 0) {
+        // Found the match
+        return result;
+      }
+    }
+    return 0;
+  }
+
+  ProductData const*
+  Principal::findAvailableProduct(ProductTransientIndex index,
+                                  TypeID const& typeID,
+                                  std::string const& moduleLabel,
+                                  std::string const& productInstanceName,
+                                  std::string const& processName) const {
+    //now see if the data is actually available
+    ConstProductPtr const& productHolder = getProductByIndex(index, false, false);
+    if(!productHolder) {
+      return 0;
+    }
+    {
+      std::lock_guard<std::recursive_mutex> guard(productMutex_);
+      if(productHolder->productWasDeleted()) {
         throwProductDeletedException("findProductByLabel",
                                      typeID,
                                      moduleLabel,
                                      productInstanceName,
                                      processName);
       }
-
       // Skip product if not available.
-      if(productHolder && !productHolder->productUnavailable()) {
-        this->resolveProduct(*productHolder, true);
-        // If the product is a dummy filler, product holder will now be marked unavailable.
-        // Unscheduled execution can fail to produce the EDProduct so check
-        if(productHolder->product() && !productHolder->productUnavailable() && !productHolder->onDemand()) {
-          // Found the match
-          return &productHolder->productData();
-        }
+      if(productHolder->productUnavailable()) {
+        return 0;
       }
     }
+
+    this->resolveProduct(*productHolder, true);
+    std::lock_guard<std::recursive_mutex> guard(productMutex_);
+    // If the product is a dummy filler, product holder will now be marked unavailable.
+    // Unscheduled execution can fail to produce the EDProduct so check
+    if(productHolder->product() && !productHolder->productUnavailable() && !productHolder->onDemand()) {
+      return &productHolder->productData();
+    }
     return 0;
   }
 
@@ -619,6 +705,7 @@ namespace edm {
     if(phb == nullptr) {
       throwProductNotFoundException("getForOutput", errors::LogicError, bid);
     }
+    std::lock_guard<std::recursive_mutex> guard(productMutex_);
     if (phb->productWasDeleted()) {
       throwProductDeletedException("getForOutput",phb->productType(),
                                    phb->moduleLabel(),
@@ -638,11 +725,17 @@ namespace edm {
       throwProductNotFoundException("getProvenance", errors::ProductNotFound, bid);
     }
 
-    if(phb->onDemand()) {
+    bool onDemand = false;
+    {
+      std::lock_guard<std::recursive_mutex> guard(productMutex_);
+      onDemand = phb->onDemand();
+    }
+    if(onDemand) {
       unscheduledFill(phb->branchDescription().moduleLabel());
     }
     // We already tried to produce the unscheduled products above
     // If they still are not there, then throw
+    std::lock_guard<std::recursive_mutex> guard(productMutex_);
     if(phb->onDemand()) {
       throwProductNotFoundException("getProvenance(onDemand)", errors::ProductNotFound, bid);
     }
@@ -240,9 +240,9 @@ namespace edm {
   }
 
   void PrincipalCache::adjustEventToNewProductRegistry(boost::shared_ptr<ProductRegistry const> reg) {
-    if (eventPrincipal_) {
-      eventPrincipal_->adjustIndexesAfterProductRegistryAddition();
-      bool eventOK = eventPrincipal_->adjustToNewProductRegistry(*reg);
+    for(auto& eventPrincipal : eventPrincipals_) {
+      eventPrincipal->adjustIndexesAfterProductRegistryAddition();
+      bool eventOK = eventPrincipal->adjustToNewProductRegistry(*reg);
       assert(eventOK);
     }
   }
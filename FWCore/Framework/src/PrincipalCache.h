@@ -11,7 +11,11 @@ the same reduced ProcessHistoryID.
 
 The EventPrincipal is reused each event and is created
 by the EventProcessor or SubProcess which contains
-an object of this type as a data member.
+an object of this type as a data member. When events
+are processed concurrently there is one EventPrincipal
+for each stream, inserted in the order of the streams.
+Inserting an EventPrincipal therefore adds a stream
+instead of replacing the EventPrincipal already held.
 
 The RunPrincipal and LuminosityBlockPrincipal is
 created by the InputSource each time a different
@@ -29,6 +33,8 @@ Original Author: W. David Dagenhart
 
 #include "boost/shared_ptr.hpp"
 
+#include <vector>
+
 namespace edm {
 
   class RunPrincipal;
@@ -56,14 +62,14 @@ namespace edm {
     boost::shared_ptr<LuminosityBlockPrincipal> const& lumiPrincipalPtr() const;
     bool hasLumiPrincipal() const {return lumiPrincipal_;}
 
-    EventPrincipal& eventPrincipal() const { return *eventPrincipal_; }
+    EventPrincipal& eventPrincipal(unsigned int iStream = 0U) const { return *eventPrincipals_[iStream]; }
 
     void merge(boost::shared_ptr<RunAuxiliary> aux, boost::shared_ptr<ProductRegistry const> reg);
     void merge(boost::shared_ptr<LuminosityBlockAuxiliary> aux, boost::shared_ptr<ProductRegistry const> reg);
 
     void insert(boost::shared_ptr<RunPrincipal> rp);
     void insert(boost::shared_ptr<LuminosityBlockPrincipal> lbp);
-    void insert(boost::shared_ptr<EventPrincipal> ep) { eventPrincipal_ = ep; }
+    void insert(boost::shared_ptr<EventPrincipal> ep) { eventPrincipals_.push_back(ep); }
 
     void deleteRun(ProcessHistoryID const& phid, RunNumber_t run);
     void deleteLumi(ProcessHistoryID const& phid, RunNumber_t run, LuminosityBlockNumber_t lumi);
@@ -81,7 +87,7 @@ namespace edm {
     // lumi, or event
     boost::shared_ptr<RunPrincipal> runPrincipal_;
     boost::shared_ptr<LuminosityBlockPrincipal> lumiPrincipal_;
-    boost::shared_ptr<EventPrincipal> eventPrincipal_;
+    std::vector<boost::shared_ptr<EventPrincipal> > eventPrincipals_;
 
     // These are intentionally not cleared so that when inserting
     // the next principal the conversion from full ProcessHistoryID_
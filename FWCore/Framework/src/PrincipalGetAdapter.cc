@@ -5,6 +5,7 @@
 
 #include "FWCore/Framework/interface/PrincipalGetAdapter.h"
 #include "DataFormats/Provenance/interface/ProductRegistry.h"
+#include "FWCore/Framework/interface/EDConsumerBase.h"
 #include "FWCore/Framework/interface/Principal.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "DataFormats/Provenance/interface/ModuleDescription.h"
@@ -15,7 +16,8 @@ namespace edm {
 	ModuleDescription const& md)  :
     //putProducts_(),
     principal_(pcpl),
-    md_(md) {
+    md_(md),
+    consumer_(0) {
   }
 
   PrincipalGetAdapter::~PrincipalGetAdapter() {
@@ -66,6 +68,17 @@ namespace edm {
     return principal_.getByLabel(tid, tag.label(), tag.instance(), tag.process(), tag.cachedOffset(), tag.fillCount());
   }
 
+  BasicHandle
+  PrincipalGetAdapter::getByToken_(TypeID const& tid,
+                     EDGetToken token) const {
+    if(consumer_ == 0) {
+      throw Exception(errors::LogicError)
+        << "getByToken was called for type " << tid.className()
+        << " but the module " << md_.moduleLabel() << " can not use tokens here.\n";
+    }
+    return consumer_->getByToken(token, tid, principal_);
+  }
+
   void
   PrincipalGetAdapter::getManyByType_(TypeID const& tid,
 		  BasicHandleVec& results) const {
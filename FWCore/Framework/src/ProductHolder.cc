@@ -8,7 +8,7 @@
 #include <cassert>
 
 namespace edm {
-  ProductHolderBase::ProductHolderBase() {}
+  ProductHolderBase::ProductHolderBase() : beingRead_(false) {}
 
   ProductHolderBase::~ProductHolderBase() {}
   InputProductHolder::~InputProductHolder() {}
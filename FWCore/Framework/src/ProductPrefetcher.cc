@@ -0,0 +1,75 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ProductPrefetcher
+//
+// Implementation:
+//     One task reads the products in order. The EventPrincipal serializes
+//     the reads with any done by modules, so a module asking for a product
+//     while it is being read waits for that one read and then finds it.
+//     Every read from the input, wherever it is done, holds the I/O mutex
+//     of GlobalMutex.h, so the task never uses ROOT at the same time as the
+//     source or an output module.
+//
+// $Id$
+//
+
+// system include files
+#include <cassert>
+
+// user include files
+#include "FWCore/Framework/src/ProductPrefetcher.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
+
+using namespace edm;
+
+//
+// constructors and destructor
+//
+ProductPrefetcher::ProductPrefetcher():
+  branchIDs_(),
+  tasks_(),
+  stop_(false)
+{
+}
+
+ProductPrefetcher::~ProductPrefetcher()
+{
+  finish();
+}
+
+//
+// member functions
+//
+void
+ProductPrefetcher::start(TaskScheduler& iScheduler, EventPrincipal const& iPrincipal)
+{
+  assert(not tasks_);
+  if(branchIDs_.empty() or 0 == iPrincipal.reader()) {
+    return;
+  }
+  stop_ = false;
+  tasks_.reset(new TaskScheduler::TaskGroup(iScheduler));
+  tasks_->run([this, &iPrincipal]() {
+    for(auto const& branchID : branchIDs_) {
+      if(stop_) {
+        return;
+      }
+      try {
+        iPrincipal.getProductHolder(branchID, true, false);
+      } catch(...) {
+        //the module reading the product will get the failure itself
+      }
+    }
+  });
+}
+
+void
+ProductPrefetcher::finish()
+{
+  if(tasks_) {
+    stop_ = true;
+    tasks_->wait();
+    tasks_.reset();
+  }
+}
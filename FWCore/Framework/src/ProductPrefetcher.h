@@ -0,0 +1,71 @@
+#ifndef FWCore_Framework_ProductPrefetcher_h
+#define FWCore_Framework_ProductPrefetcher_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ProductPrefetcher
+//
+/**\class ProductPrefetcher ProductPrefetcher.h FWCore/Framework/src/ProductPrefetcher.h
+
+ Description: Reads event products from the input in the background while modules run
+
+ Usage:
+    The Schedule gives the list of products from the input which modules on its trigger
+    paths declared, through 'mightGet', they read. The list is in the order the modules
+    are run. For each event the Schedule calls start before running the trigger paths
+    and finish once they are done. In between a task of the TaskScheduler reads and
+    unpacks the products one after another, so a module usually finds the products it
+    asks for already in memory instead of waiting for the read.
+
+    A product which fails to be read is left alone. The module which asks for it will
+    then try again and report the failure.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "boost/utility.hpp"
+
+// user include files
+#include "DataFormats/Provenance/interface/BranchID.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
+
+// forward declarations
+namespace edm {
+  class EventPrincipal;
+
+  class ProductPrefetcher : private boost::noncopyable
+  {
+
+  public:
+    ProductPrefetcher();
+    ~ProductPrefetcher();
+
+    // ---------- const member functions ---------------------
+    bool empty() const { return branchIDs_.empty(); }
+
+    // ---------- member functions ---------------------------
+    ///the products to read, in the order they are needed
+    void setBranchIDs(std::vector<BranchID> const& iBranchIDs) { branchIDs_ = iBranchIDs; }
+
+    ///starts reading the products of iPrincipal asynchronously
+    void start(TaskScheduler& iScheduler, EventPrincipal const& iPrincipal);
+
+    ///stops reading and returns once the reading task has finished
+    void finish();
+
+  private:
+    // ---------- member data --------------------------------
+    std::vector<BranchID> branchIDs_;
+    std::unique_ptr<TaskScheduler::TaskGroup> tasks_;
+    std::atomic<bool> stop_;
+  };
+}
+
+#endif
@@ -6,6 +6,7 @@
 #include "FWCore/Framework/interface/DelayedReader.h"
 #include "FWCore/Framework/interface/ProductHolder.h"
 #include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 
 namespace edm {
   RunPrincipal::RunPrincipal(
@@ -62,6 +63,7 @@ namespace edm {
     if(!reader()) return; // nothing to do.
 
     // must attempt to load from persistent store
+    boost::recursive_mutex::scoped_lock ioLock(*rootfix::getIOMutex());
     BranchKey const bk = BranchKey(phb.branchDescription());
     WrapperOwningHolder edp(reader()->getProduct(bk, phb.productData().getInterface(), this));
 
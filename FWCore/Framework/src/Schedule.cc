@@ -3,6 +3,7 @@
 #include "DataFormats/Provenance/interface/BranchIDListHelper.h"
 #include "DataFormats/Provenance/interface/ProcessConfiguration.h"
 #include "DataFormats/Provenance/interface/ProductRegistry.h"
+#include "FWCore/Framework/interface/ConstProductRegistry.h"
 #include "FWCore/Framework/interface/EDProducer.h"
 #include "FWCore/Framework/interface/OutputModuleDescription.h"
 #include "FWCore/Framework/interface/TriggerNamesService.h"
@@ -23,6 +24,9 @@
 #include "FWCore/Utilities/interface/ConvertException.h"
 #include "FWCore/Utilities/interface/ExceptionCollector.h"
 #include "FWCore/Utilities/interface/DictionaryTools.h"
+#include "FWCore/Utilities/interface/BaseWithDict.h"
+#include "FWCore/Utilities/interface/MemberWithDict.h"
+#include "FWCore/Utilities/interface/TypeWithDict.h"
 
 #include "boost/bind.hpp"
 #include "boost/ref.hpp"
@@ -34,6 +38,7 @@
 #include <iomanip>
 #include <list>
 #include <map>
+#include <set>
 #include <exception>
 
 namespace edm {
@@ -83,7 +88,8 @@ namespace edm {
       ModuleDescription md(trig_pset->id(),
                            "TriggerResultInserter",
                            "TriggerResults",
-                           processConfiguration.get());
+                           processConfiguration.get(),
+                           ModuleDescription::getUniqueID());
 
       areg->preModuleConstructionSignal_(md);
       std::auto_ptr<EDProducer> producer(new TriggerResultInserter(*trig_pset, trptr));
@@ -260,6 +266,91 @@ namespace edm {
       }
 
     }
+
+    // Walks the persistent members of the type 't' and remembers which types
+    // it can refer to. An edm::Ref, RefProd or RefVector points into a
+    // collection of its first template argument. An edm::Ptr, PtrVector,
+    // RefToBase or RefToBaseVector points to an element of that type held in
+    // any collection.
+    void
+    findReferencedTypes(TypeWithDict t,
+                        std::set<std::string>& seenTypes,
+                        std::vector<TypeWithDict>& referencedCollections,
+                        std::vector<TypeWithDict>& referencedElements) {
+      TypeWithDict null;
+      for(TypeWithDict x(t.toType()); x != null && x != t; t = x, x = t.toType()) {}
+      if(not bool(t) or t.isFundamental() or t.isEnum()) {
+        return;
+      }
+      std::string const name = t.name();
+      if(not seenTypes.insert(name).second) {
+        return;
+      }
+      static std::string const refTemplates[] = {"edm::Ref<", "edm::RefProd<", "edm::RefVector<"};
+      static std::string const ptrTemplates[] = {"edm::Ptr<", "edm::PtrVector<", "edm::RefToBase<", "edm::RefToBaseVector<"};
+      for(auto const& templateName : refTemplates) {
+        if(name.compare(0, templateName.size(), templateName) == 0) {
+          referencedCollections.push_back(t.templateArgumentAt(0));
+          return;
+        }
+      }
+      for(auto const& templateName : ptrTemplates) {
+        if(name.compare(0, templateName.size(), templateName) == 0) {
+          referencedElements.push_back(t.templateArgumentAt(0));
+          return;
+        }
+      }
+      if(name.compare(0, 5, "std::") == 0) {
+        //only the contents of the standard containers matter
+        if(t.isTemplateInstance()) {
+          bool const twoParams = name.compare(0, 9, "std::map<") == 0 or
+                                 name.compare(0, 10, "std::pair<") == 0 or
+                                 name.compare(0, 14, "std::multimap<") == 0;
+          for(size_t i = 0, n = twoParams ? 2 : 1; i != n; ++i) {
+            findReferencedTypes(t.templateArgumentAt(i), seenTypes, referencedCollections, referencedElements);
+          }
+        }
+        return;
+      }
+      TypeDataMembers members(t);
+      for(auto const& member : members) {
+        MemberWithDict m(member);
+        if(not m.isTransient() and not m.isStatic()) {
+          findReferencedTypes(m.typeOf(), seenTypes, referencedCollections, referencedElements);
+        }
+      }
+      TypeBases bases(t);
+      for(auto const& base : bases) {
+        findReferencedTypes(BaseWithDict(base).toType(), seenTypes, referencedCollections, referencedElements);
+      }
+    }
+
+    // True if a Ref or Ptr found by findReferencedTypes could point into a
+    // product of type 'productType'.
+    bool
+    mightBeReferenced(TypeWithDict const& productType,
+                      std::vector<TypeWithDict> const& referencedCollections,
+                      std::vector<TypeWithDict> const& referencedElements) {
+      if(not bool(productType)) {
+        //without a dictionary we can not tell so assume the worst
+        return true;
+      }
+      if(std::find(referencedCollections.begin(), referencedCollections.end(), productType) != referencedCollections.end()) {
+        return true;
+      }
+      TypeWithDict valueType;
+      if(referencedElements.empty() or not value_type_of(productType, valueType) or not bool(valueType)) {
+        return false;
+      }
+      std::vector<TypeWithDict> elementTypes(1, valueType);
+      public_base_classes(valueType, elementTypes);
+      for(auto const& elementType : elementTypes) {
+        if(std::find(referencedElements.begin(), referencedElements.end(), elementType) != referencedElements.end()) {
+          return true;
+        }
+      }
+      return false;
+    }
   }
 
   // -----------------------------
@@ -289,11 +380,14 @@ namespace edm {
     all_output_workers_(),
     trig_paths_(),
     end_paths_(),
+    endPathsRunSeparately_(false),
     wantSummary_(tns.wantSummary()),
     total_events_(),
     total_passed_(),
     stopwatch_(wantSummary_? new RunStopwatch::StopwatchPointer::element_type : static_cast<RunStopwatch::StopwatchPointer::element_type*> (0)),
     unscheduled_(new UnscheduledCallProducer),
+    unscheduledGraph_(),
+    hasSubProcess_(0 != subProcPSet),
     endpathsAreActive_(true) {
 
     ParameterSet const& opts = proc_pset.getUntrackedParameterSet("options", ParameterSet());
@@ -414,6 +508,8 @@ namespace edm {
     processConfiguration->setParameterSetID(proc_pset.id());
 
     initializeEarlyDelete(opts,preg,subProcPSet);
+    initializeConcurrentPaths(opts,preg);
+    initializePrefetching(opts,preg);
     
     // This is used for a little sanity-check to make sure no code
     // modifications alter the number of workers at a later date.
@@ -461,6 +557,15 @@ namespace edm {
     // registered for this job
     std::multimap<std::string,Worker*> branchToReadingWorker;
     initializeBranchToReadingWorker(opts,preg,branchToReadingWorker);
+
+    //only warn about unused products if they were explicitly asked for
+    std::set<std::string> requestedBranches;
+    for(auto const& branchAndWorker : branchToReadingWorker) {
+      requestedBranches.insert(branchAndWorker.first);
+    }
+    if(opts.getUntrackedParameter<bool>("deleteEarlyAutomatically", false)) {
+      addAutomaticEarlyDeleteCandidates(preg,branchToReadingWorker);
+    }
     
     //If no delete early items have been specified we don't have to do anything
     if(branchToReadingWorker.size()==0) {
@@ -481,7 +586,10 @@ namespace edm {
           // so we should remove it from our list
           SelectionsArray const&kept = ow->keptProducts();
           for( auto const& item: kept[InEvent]) {
-            auto found = branchToReadingWorker.equal_range(item->branchName());
+            //the names in branchToReadingWorker do not have the trailing period
+            std::string name = item->branchName();
+            name.resize(name.size()-1);
+            auto found = branchToReadingWorker.equal_range(name);
             if(found.first !=found.second) {
               --nUniqueBranchesToDelete;
               branchToReadingWorker.erase(found.first,found.second);
@@ -518,7 +626,9 @@ namespace edm {
       std::vector<std::string> unusedBranches;
       while(it !=branchToReadingWorker.end()) {
         if(it->second == nullptr) {
-          unusedBranches.push_back(it->first);
+          if(requestedBranches.find(it->first) != requestedBranches.end()) {
+            unusedBranches.push_back(it->first);
+          }
           //erasing the object invalidates the iterator so must advance it first
           auto temp = it;
           ++it;
@@ -601,6 +711,282 @@ namespace edm {
     }
   }
 
+  void Schedule::addAutomaticEarlyDeleteCandidates(edm::ProductRegistry const& preg,
+                                                   std::multimap<std::string,Worker*>& branchToReadingWorker) const {
+    //We can only know when a product is no longer needed if every module says what it reads.
+    // OutputModules read what they keep.
+    std::vector<std::string> undeclaredModules;
+    for(auto worker : all_workers_) {
+      if(worker == results_inserter_.get() or 0 != dynamic_cast<OutputWorker*>(worker)) {
+        continue;
+      }
+      auto pset = pset::Registry::instance()->getMapped(worker->description().parameterSetID());
+      if(0 == pset or not pset->exists("mightGet")) {
+        undeclaredModules.push_back(worker->description().moduleLabel());
+      }
+    }
+    if(not undeclaredModules.empty()) {
+      LogWarning l("DeleteEarlyAutomatically");
+      l<<"The following modules do not declare what they read with 'mightGet' so no product will be deleted early\n"
+      " because of 'deleteEarlyAutomatically'.";
+      for(auto const& label : undeclaredModules) {
+        l<<"\n "<<label;
+      }
+      return;
+    }
+
+    //an alias shares its data with the product it refers to so neither can be deleted
+    std::set<BranchID> aliasedBranchIDs;
+    for(auto const& product : preg.productList()) {
+      if(product.second.isAlias()) {
+        aliasedBranchIDs.insert(product.second.aliasForBranchID());
+      }
+    }
+    //the OutputModules read the TriggerResults to decide which events to write
+    std::string const triggerResultsLabel = results_inserter_ ? results_inserter_->description().moduleLabel() : std::string();
+
+    //A module reading a Ref or Ptr gets the product it points to without declaring it in
+    // 'mightGet', so keep any product another event product could refer to.
+    std::set<std::string> seenTypes;
+    std::vector<TypeWithDict> referencedCollections;
+    std::vector<TypeWithDict> referencedElements;
+    for(auto const& product : preg.productList()) {
+      if(product.second.branchType() == InEvent) {
+        findReferencedTypes(TypeWithDict::byName(product.second.className()),
+                            seenTypes, referencedCollections, referencedElements);
+      }
+    }
+
+    unsigned int nCandidates = 0;
+    unsigned int nReferenced = 0;
+    for(auto const& product : preg.productList()) {
+      BranchDescription const& desc = product.second;
+      if(not desc.produced() or desc.branchType() != InEvent or desc.isAlias() or
+         aliasedBranchIDs.find(desc.branchID()) != aliasedBranchIDs.end() or
+         desc.moduleLabel() == triggerResultsLabel) {
+        continue;
+      }
+      if(mightBeReferenced(TypeWithDict::byName(desc.className()), referencedCollections, referencedElements)) {
+        ++nReferenced;
+        continue;
+      }
+      std::string name = desc.branchName();
+      name.resize(name.size()-1);
+      if(branchToReadingWorker.find(name) == branchToReadingWorker.end()) {
+        //set placeholder for the branch, we will remove the nullptr if a
+        // module actually wants the branch.
+        branchToReadingWorker.insert(std::make_pair(name, static_cast<Worker*>(nullptr)));
+        ++nCandidates;
+      }
+    }
+    LogInfo("DeleteEarlyAutomatically")
+      << nCandidates << " products made in this process may be deleted once all the modules reading them have run.\n "
+      << nReferenced << " products are kept because an edm::Ref or edm::Ptr could point to them.";
+  }
+
+  void Schedule::initializeConcurrentPaths(edm::ParameterSet const& opts, edm::ProductRegistry const& preg) {
+    if(not opts.getUntrackedParameter<bool>("concurrentTriggerPaths", false)) {
+      return;
+    }
+    //The counts used for early deletion are shared between all paths
+    if(not earlyDeleteHelpers_.empty()) {
+      LogWarning("ConcurrentTriggerPaths")
+        <<"'concurrentTriggerPaths' can not be used together with 'canDeleteEarly' or 'deleteEarlyAutomatically'.\n"
+          " The trigger paths will be run serially.";
+      return;
+    }
+
+    //Use a union-find over the trigger paths. Any two paths which must
+    // not run at the same time end up with the same root.
+    std::vector<unsigned int> parent(trig_paths_.size());
+    for(unsigned int i = 0; i != parent.size(); ++i) {
+      parent[i] = i;
+    }
+    auto findRoot = [&parent](unsigned int i) {
+      while(parent[i] != i) {
+        parent[i] = parent[parent[i]];
+        i = parent[i];
+      }
+      return i;
+    };
+    auto merge = [&parent, &findRoot](unsigned int i, unsigned int j) {
+      unsigned int ri = findRoot(i);
+      unsigned int rj = findRoot(j);
+      //keep the lowest path index as the root so groups keep their order
+      if(ri < rj) {
+        parent[rj] = ri;
+      } else {
+        parent[ri] = rj;
+      }
+    };
+
+    //the branch names (without the trailing period) of the event data
+    // made in this process and the label of the module making them
+    std::map<std::string, std::string> branchToProducer;
+    std::set<std::string> producerLabels;
+    for(auto const& product : preg.productList()) {
+      BranchDescription const& desc = product.second;
+      if(desc.produced() && desc.branchType() == InEvent) {
+        std::string name = desc.branchName();
+        name.resize(name.size()-1);
+        branchToProducer[name] = desc.moduleLabel();
+        producerLabels.insert(desc.moduleLabel());
+      }
+    }
+
+    //Paths which share a worker must run serially so the worker only runs once
+    std::map<std::string, std::vector<unsigned int> > labelToPaths;
+    for(unsigned int i = 0; i != trig_paths_.size(); ++i) {
+      for(unsigned int w = 0; w != trig_paths_[i].size(); ++w) {
+        auto& paths = labelToPaths[trig_paths_[i].getWorker(w)->description().moduleLabel()];
+        if(not paths.empty()) {
+          merge(paths.front(), i);
+        }
+        paths.push_back(i);
+      }
+    }
+
+    std::vector<unsigned int> pathsWithProducers;
+    for(unsigned int i = 0; i != trig_paths_.size(); ++i) {
+      for(unsigned int w = 0; w != trig_paths_[i].size(); ++w) {
+        if(producerLabels.find(trig_paths_[i].getWorker(w)->description().moduleLabel()) != producerLabels.end()) {
+          pathsWithProducers.push_back(i);
+          break;
+        }
+      }
+    }
+
+    //Paths where a module reads data made by a module on another path must run serially
+    const std::vector<std::string> kEmpty;
+    for(unsigned int i = 0; i != trig_paths_.size(); ++i) {
+      for(unsigned int w = 0; w != trig_paths_[i].size(); ++w) {
+        auto pset = pset::Registry::instance()->getMapped(trig_paths_[i].getWorker(w)->description().parameterSetID());
+        if(0 == pset or not pset->exists("mightGet")) {
+          //we do not know what the module reads so assume it reads everything
+          for(auto p : pathsWithProducers) {
+            merge(p, i);
+          }
+          continue;
+        }
+        for(auto const& branch : pset->getUntrackedParameter<std::vector<std::string>>("mightGet", kEmpty)) {
+          auto itProducer = branchToProducer.find(branch);
+          if(itProducer == branchToProducer.end()) {
+            continue;
+          }
+          auto itPaths = labelToPaths.find(itProducer->second);
+          if(itPaths != labelToPaths.end()) {
+            for(auto p : itPaths->second) {
+              merge(p, i);
+            }
+          }
+        }
+      }
+    }
+
+    std::map<unsigned int, std::vector<unsigned int> > rootToGroup;
+    for(unsigned int i = 0; i != trig_paths_.size(); ++i) {
+      rootToGroup[findRoot(i)].push_back(i);
+    }
+    LogInfo("ConcurrentTriggerPaths")
+      << "The " << trig_paths_.size() << " trigger paths were divided into "
+      << rootToGroup.size() << " groups which can run concurrently.";
+    if(rootToGroup.size() < 2) {
+      return;
+    }
+    concurrentPathGroups_.reserve(rootToGroup.size());
+    for(auto& rootAndGroup : rootToGroup) {
+      concurrentPathGroups_.push_back(std::move(rootAndGroup.second));
+    }
+  }
+
+  void Schedule::initializePrefetching(edm::ParameterSet const& opts, edm::ProductRegistry const& preg) {
+    if(not opts.getUntrackedParameter<bool>("prefetchProducts", false)) {
+      return;
+    }
+    //only products coming from the input need to be read
+    std::set<BranchID> inputBranchIDs;
+    for(auto const& keyAndDescription : preg.productList()) {
+      BranchDescription const& desc = keyAndDescription.second;
+      if(desc.branchType() == InEvent and not desc.produced()) {
+        inputBranchIDs.insert(desc.branchID());
+      }
+    }
+    //a product deleted early must not be read back in after it was deleted
+    for(auto const& branchAndCount : earlyDeleteBranchToCount_) {
+      inputBranchIDs.erase(branchAndCount.first);
+    }
+
+    const std::vector<std::string> kEmpty;
+    std::set<BranchID> alreadySeen;
+    std::vector<BranchID> toPrefetch;
+    for(auto const& path : trig_paths_) {
+      for(unsigned int w = 0; w != path.size(); ++w) {
+        auto pset = pset::Registry::instance()->getMapped(path.getWorker(w)->description().parameterSetID());
+        if(0 == pset) {
+          continue;
+        }
+        for(auto const& branch : pset->getUntrackedParameter<std::vector<std::string>>("mightGet", kEmpty)) {
+          //have to put back the period which is not part of the 'mightGet' names
+          BranchID bid(branch+".");
+          if(inputBranchIDs.find(bid) != inputBranchIDs.end() and alreadySeen.insert(bid).second) {
+            toPrefetch.push_back(bid);
+          }
+        }
+      }
+    }
+    LogInfo("PrefetchProducts")
+      << toPrefetch.size() << " products declared with 'mightGet' will be read ahead of the modules.";
+    prefetcher_.setBranchIDs(toPrefetch);
+  }
+
+  void Schedule::initializeUnscheduledGraph() {
+    std::vector<Worker*> unscheduledWorkers = unscheduled_->workers();
+    if(unscheduledWorkers.empty()) {
+      return;
+    }
+    std::sort(unscheduledWorkers.begin(), unscheduledWorkers.end());
+
+    //a module which has no 'mightGet' may read anything
+    const std::vector<std::string> kEmpty;
+    auto declaredReads = [&kEmpty](Worker const* iWorker) {
+      std::auto_ptr<UnscheduledProducerGraph::Branches> reads;
+      auto pset = pset::Registry::instance()->getMapped(iWorker->description().parameterSetID());
+      if(0 != pset and pset->exists("mightGet")) {
+        reads.reset(new UnscheduledProducerGraph::Branches(pset->getUntrackedParameter<std::vector<std::string>>("mightGet", kEmpty)));
+      }
+      return reads;
+    };
+
+    for(auto worker : unscheduledWorkers) {
+      std::auto_ptr<UnscheduledProducerGraph::Branches> reads = declaredReads(worker);
+      unscheduledGraph_.addProducer(worker, reads.get());
+    }
+    for(auto worker : all_workers_) {
+      if(worker == results_inserter_.get() or
+         std::binary_search(unscheduledWorkers.begin(), unscheduledWorkers.end(), worker)) {
+        continue;
+      }
+      OutputWorker* ow = dynamic_cast<OutputWorker*>(worker);
+      if(ow) {
+        //an OutputModule reads what it keeps
+        UnscheduledProducerGraph::Branches reads;
+        for(auto const& selections : ow->keptProducts()) {
+          for(auto const& item : selections) {
+            std::string const& branchName = item->branchName();
+            reads.push_back(branchName.substr(0, branchName.size() - 1));
+          }
+        }
+        unscheduledGraph_.addConsumer(worker, &reads);
+      } else {
+        std::auto_ptr<UnscheduledProducerGraph::Branches> reads = declaredReads(worker);
+        unscheduledGraph_.addConsumer(worker, reads.get());
+      }
+    }
+    //a SubProcess may read any product
+    unscheduledGraph_.build(Service<ConstProductRegistry>()->productRegistry(), hasSubProcess_);
+    unscheduled_->prune(unscheduledGraph_.prunedProducers());
+  }
+
   void Schedule::reduceParameterSet(ParameterSet& proc_pset,
                                     vstring& modulesInConfig,
                                     std::set<std::string> const& modulesInConfigSet,
@@ -1280,6 +1666,7 @@ namespace edm {
   void Schedule::beginJob() {
     for_all(all_workers_, boost::bind(&Worker::beginJob, _1));
     loadMissingDictionaries();
+    initializeUnscheduledGraph();
   }
 
   void Schedule::preForkReleaseResources() {
@@ -1288,6 +1675,9 @@ namespace edm {
   void Schedule::postForkReacquireResources(unsigned int iChildIndex, unsigned int iNumberOfChildren) {
     for_all(all_workers_, boost::bind(&Worker::postForkReacquireResources, _1, iChildIndex, iNumberOfChildren));
   }
+  void Schedule::mergeForkedChildrenOutputs(unsigned int iNumberOfChildren) {
+    for_all(all_output_workers_, boost::bind(&OutputWorker::mergeForkedChildrenOutputs, _1, iNumberOfChildren));
+  }
 
   bool Schedule::changeModule(std::string const& iLabel,
                               ParameterSet const& iPSet) {
@@ -1433,6 +1823,66 @@ namespace edm {
     endpath_results_->reset();
   }
 
+  void
+  Schedule::resetTriggerPathWorkers() {
+    for_all(triggerPathWorkers_, boost::bind(&Worker::reset, _1));
+    results_->reset();
+  }
+
+  bool
+  Schedule::runEndPathsSeparately() {
+    std::set<Worker const*> onTriggerPaths;
+    for(auto const& path : trig_paths_) {
+      for(unsigned int i = 0; i != path.size(); ++i) {
+        onTriggerPaths.insert(path.getWorker(i));
+      }
+    }
+    std::set<Worker const*> onEndPaths;
+    for(auto const& path : end_paths_) {
+      for(unsigned int i = 0; i != path.size(); ++i) {
+        if(onTriggerPaths.find(path.getWorker(i)) != onTriggerPaths.end()) {
+          return false;
+        }
+        onEndPaths.insert(path.getWorker(i));
+      }
+    }
+    endPathWorkers_.clear();
+    triggerPathWorkers_.clear();
+    for(auto worker : all_workers_) {
+      if(onEndPaths.find(worker) != onEndPaths.end()) {
+        endPathWorkers_.push_back(worker);
+      } else {
+        triggerPathWorkers_.push_back(worker);
+      }
+    }
+    endPathsRunSeparately_ = true;
+    return true;
+  }
+
+  void
+  Schedule::addToCounters(Schedule const& other) {
+    assert(trig_paths_.size() == other.trig_paths_.size());
+    assert(end_paths_.size() == other.end_paths_.size());
+    total_events_ += other.total_events_;
+    total_passed_ += other.total_passed_;
+    for(unsigned int i = 0; i != trig_paths_.size(); ++i) {
+      trig_paths_[i].addToCounters(other.trig_paths_[i]);
+    }
+    for(unsigned int i = 0; i != end_paths_.size(); ++i) {
+      end_paths_[i].addToCounters(other.end_paths_[i]);
+    }
+    std::map<std::string, Worker const*> labelToWorker;
+    for(auto worker : other.all_workers_) {
+      labelToWorker[worker->description().moduleLabel()] = worker;
+    }
+    for(auto worker : all_workers_) {
+      auto itFound = labelToWorker.find(worker->description().moduleLabel());
+      if(itFound != labelToWorker.end()) {
+        worker->addToCounters(*itFound->second);
+      }
+    }
+  }
+
   void
   Schedule::addToAllWorkers(Worker* w) {
     if (!search_all(all_workers_, w)) {
@@ -1443,6 +1893,14 @@ namespace edm {
     }
   }
 
+  void
+  Schedule::startPrefetching(EventPrincipal const& ep) {
+    if(not prefetcher_.empty()) {
+      Service<TaskScheduler> scheduler;
+      prefetcher_.start(*scheduler, ep);
+    }
+  }
+
   void
   Schedule::setupOnDemandSystem(EventPrincipal& ep, EventSetup const& es) {
     // NOTE: who owns the productdescrption?  Just copied by value
@@ -1465,4 +1923,81 @@ namespace edm {
     }
   }
 
+
+  void
+  UnscheduledCallProducer::startRunning(UnscheduledWorker& iWorker) {
+    std::thread::id const self = std::this_thread::get_id();
+    std::unique_lock<std::mutex> lock(runningMutex_);
+    while(iWorker.runningOn_ != std::thread::id()) {
+      //if the thread running the module waits, maybe through others, for this thread it will never finish
+      if(waitsFor(self, std::vector<UnscheduledWorker const*>(1, &iWorker))) {
+        throw Exception(errors::LogicError)
+          << "Hit circular dependency while trying to run the unscheduled module '"
+          << iWorker.worker_->description().moduleLabel() << "'.\n"
+          << "The module is already being run and is waiting, maybe through other modules\n"
+          << "run on other threads, for the module which asked for it.\n"
+          << "Scheduling some or all required modules in paths may help, otherwise the\n"
+          << "modules themselves will have to be fixed.\n";
+      }
+      std::vector<UnscheduledWorker const*>& waiting = waiting_[self];
+      waiting.push_back(&iWorker);
+      moduleFinished_.wait(lock);
+      waiting.pop_back();
+    }
+    iWorker.runningOn_ = self;
+  }
+
+  void
+  UnscheduledCallProducer::stopRunning(UnscheduledWorker& iWorker) {
+    {
+      std::lock_guard<std::mutex> guard(runningMutex_);
+      iWorker.runningOn_ = std::thread::id();
+    }
+    moduleFinished_.notify_all();
+  }
+
+  bool
+  UnscheduledCallProducer::waitsFor(std::thread::id iThread, std::vector<UnscheduledWorker const*> iWorkers) const {
+    std::set<std::thread::id> seen;
+    while(not iWorkers.empty()) {
+      std::thread::id const owner = iWorkers.back()->runningOn_;
+      iWorkers.pop_back();
+      if(owner == iThread) {
+        return true;
+      }
+      if(owner == std::thread::id() or not seen.insert(owner).second) {
+        continue;
+      }
+      std::map<std::thread::id, std::vector<UnscheduledWorker const*> >::const_iterator itWaiting = waiting_.find(owner);
+      if(itWaiting != waiting_.end()) {
+        iWorkers.insert(iWorkers.end(), itWaiting->second.begin(), itWaiting->second.end());
+      }
+    }
+    return false;
+  }
+
+  void
+  UnscheduledCallProducer::startWaitingFor(std::vector<std::string const*> const& iLabels) {
+    std::thread::id const self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> guard(runningMutex_);
+    std::vector<UnscheduledWorker const*>& waiting = waiting_[self];
+    for(auto label : iLabels) {
+      std::map<std::string, UnscheduledWorker>::const_iterator itFound = labelToWorkers_.find(*label);
+      if(itFound != labelToWorkers_.end()) {
+        waiting.push_back(&itFound->second);
+      }
+    }
+  }
+
+  void
+  UnscheduledCallProducer::stopWaitingFor(std::vector<std::string const*> const& iLabels) {
+    std::thread::id const self = std::this_thread::get_id();
+    std::lock_guard<std::mutex> guard(runningMutex_);
+    std::vector<UnscheduledWorker const*>& waiting = waiting_[self];
+    for(auto label : iLabels) {
+      if(labelToWorkers_.find(*label) != labelToWorkers_.end()) {
+        waiting.pop_back();
+      }
+    }
+  }
 }
@@ -10,6 +10,7 @@
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
 #include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
 #include "FWCore/Utilities/interface/GetPassID.h"
 #include "FWCore/Version/interface/GetReleaseVersion.h"
 
@@ -83,6 +84,18 @@ namespace edm {
                                              serviceregistry::kOverlapIsError);
   }
 
+  ServiceToken
+  ScheduleItems::addTaskScheduler(ServiceToken const& token) {
+    // the scheduler reports its threads' utilisation through our ActivityRegistry
+    typedef serviceregistry::ServiceWrapper<TaskScheduler> w_TS;
+    boost::shared_ptr<w_TS> tsptr
+      (new w_TS(std::auto_ptr<TaskScheduler>(new TaskScheduler(*actReg_))));
+
+    return ServiceRegistry::createContaining(tsptr,
+                                             token,
+                                             serviceregistry::kOverlapIsError);
+  }
+
   boost::shared_ptr<CommonParams>
   ScheduleItems::initMisc(ParameterSet& parameterSet) {
     act_table_.reset(new ActionTable(parameterSet));
@@ -1,6 +1,7 @@
 #include "FWCore/Framework/interface/SubProcess.h"
 
 #include "DataFormats/Common/interface/ProductData.h"
+#include "DataFormats/Provenance/interface/BranchMapper.h"
 #include "DataFormats/Provenance/interface/BranchID.h"
 #include "DataFormats/Provenance/interface/BranchIDListHelper.h"
 #include "DataFormats/Provenance/interface/EventSelectionID.h"
@@ -22,9 +23,12 @@
 #include "FWCore/Framework/src/SignallingProductRegistry.h"
 #include "FWCore/ParameterSet/interface/IllegalParameters.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
 #include "FWCore/Utilities/interface/ExceptionCollector.h"
 
 #include <cassert>
+#include <exception>
 #include <set>
 #include <string>
 #include <vector>
@@ -52,7 +56,8 @@ namespace edm {
       parentToChildPhID_(),
       historyAppender_(new HistoryAppender),
       esInfo_(0),
-      subProcess_(),
+      subProcesses_(),
+      concurrentSubProcesses_(false),
       cleaningUpAfterException_(false),
       processParameterSet_() {
 
@@ -77,15 +82,20 @@ namespace edm {
       processParameterSet_->addUntrackedParameter<ParameterSet>(maxLumis, topLevelParameterSet.getUntrackedParameterSet(maxLumis));
     }
 
-    // If this process has a subprocess, pop the subprocess parameter set out of the process parameter set
+    // If this process has subprocesses, pop the subprocess parameter sets out of the process parameter set
 
-    boost::shared_ptr<ParameterSet> subProcessParameterSet(popSubProcessParameterSet(*processParameterSet_).release());
+    std::vector<ParameterSet> subProcessVParameterSet(popSubProcessVParameterSet(*processParameterSet_));
+    ParameterSet const* subProcessParameterSet = subProcessVParameterSet.empty() ? 0 : &subProcessVParameterSet[0];
   
     ScheduleItems items(*parentProductRegistry, *parentBranchIDListHelper);
 
     ParameterSet const& optionsPset(processParameterSet_->getUntrackedParameterSet("options", ParameterSet()));
     IllegalParameters::setThrowAnException(optionsPset.getUntrackedParameter<bool>("throwIfIllegalParameter", true));
 
+    // whether sibling subprocesses are run concurrently is decided by the top level process
+    ParameterSet const& topLevelOptionsPset(topLevelParameterSet.getUntrackedParameterSet("options", ParameterSet()));
+    concurrentSubProcesses_ = topLevelOptionsPset.getUntrackedParameter<bool>("concurrentSubProcesses", false);
+
     //initialize the services
     ServiceToken iToken;
 
@@ -107,7 +117,7 @@ namespace edm {
     esp_ = esController.makeProvider(*processParameterSet_);
 
     // intialize the Schedule
-    schedule_ = items.initSchedule(*processParameterSet_,subProcessParameterSet.get());
+    schedule_ = items.initSchedule(*processParameterSet_,subProcessParameterSet);
 
     // set the items
     act_table_ = items.act_table_;
@@ -124,8 +134,8 @@ namespace edm {
     boost::shared_ptr<EventPrincipal> ep(new EventPrincipal(preg_, branchIDListHelper_, *processConfiguration_, historyAppender_.get()));
     principalCache_.insert(ep);
 
-    if(subProcessParameterSet) {
-      subProcess_.reset(new SubProcess(*subProcessParameterSet, topLevelParameterSet, preg_, branchIDListHelper_, esController, *items.actReg_, newToken, iLegacy));
+    for(auto& subProcessPSet : subProcessVParameterSet) {
+      subProcesses_.emplace_back(new SubProcess(subProcessPSet, topLevelParameterSet, preg_, branchIDListHelper_, esController, *items.actReg_, newToken, iLegacy));
     }
   }
 
@@ -159,7 +169,7 @@ namespace edm {
     }
     ServiceRegistry::Operate operate(serviceToken_);
     schedule_->beginJob();
-    if(subProcess_.get()) subProcess_->doBeginJob();
+    for(auto& subProcess : subProcesses_) subProcess->doBeginJob();
   }
 
   void
@@ -170,7 +180,7 @@ namespace edm {
     if(c.hasThrown()) {
       c.rethrow();
     }
-    if(subProcess_.get()) subProcess_->doEndJob();
+    for(auto& subProcess : subProcesses_) subProcess->doEndJob();
   }
 
   void
@@ -185,7 +195,7 @@ namespace edm {
         }
       }
     }
-    if(subProcess_.get()) subProcess_->fixBranchIDListsForEDAliases(droppedBranchIDToKeptBranchID);
+    for(auto& subProcess : subProcesses_) subProcess->fixBranchIDListsForEDAliases(droppedBranchIDToKeptBranchID);
   }
 
   SubProcess::ESInfo::ESInfo(IOVSyncValue const& ts, eventsetup::EventSetupProvider& esp) :
@@ -195,8 +205,65 @@ namespace edm {
 
   void
   SubProcess::doEvent(EventPrincipal const& principal, IOVSyncValue const& ts) {
+    beginEvent(ts);
+    processEvent(principal);
+  }
+
+  void
+  SubProcess::doEvent(std::vector<std::unique_ptr<SubProcess> >& iSubProcesses,
+                      EventPrincipal const& principal,
+                      IOVSyncValue const& ts,
+                      bool iConcurrently) {
+    if(!iConcurrently || iSubProcesses.size() < 2U) {
+      for(auto& subProcess : iSubProcesses) {
+        subProcess->doEvent(principal, ts);
+      }
+      return;
+    }
+    // Do everything which changes the parent event or the EventSetups before the
+    // subprocesses start, so while they run they only read from the parent event.
+    if(principal.branchMapperPtr()) {
+      principal.branchMapperPtr()->readProvenance();
+    }
+    for(auto& subProcess : iSubProcesses) {
+      subProcess->readKeptProducts(principal);
+      subProcess->beginEvent(ts);
+    }
+
+    std::vector<std::exception_ptr> exceptions(iSubProcesses.size());
+    {
+      Service<TaskScheduler> scheduler;
+      TaskScheduler::TaskGroup tasks(*scheduler);
+      for(unsigned int i = 0; i != iSubProcesses.size(); ++i) {
+        SubProcess* subProcess = iSubProcesses[i].get();
+        std::exception_ptr* exception = &exceptions[i];
+        // each subprocess is run to the end even if another one fails
+        tasks.run([subProcess, &principal, exception]() {
+          try {
+            subProcess->processEvent(principal);
+          } catch(...) {
+            *exception = std::current_exception();
+          }
+        });
+      }
+      tasks.wait();
+    }
+    for(auto const& exception : exceptions) {
+      if(exception) {
+        std::rethrow_exception(exception);
+      }
+    }
+  }
+
+  void
+  SubProcess::beginEvent(IOVSyncValue const& ts) {
     ServiceRegistry::Operate operate(serviceToken_);
     esInfo_.reset(new ESInfo(ts, *esp_));
+  }
+
+  void
+  SubProcess::processEvent(EventPrincipal const& principal) {
+    ServiceRegistry::Operate operate(serviceToken_);
     CurrentProcessingContext cpc;
     doEvent(principal, esInfo_->es_, &cpc);
     esInfo_.reset();
@@ -213,17 +280,23 @@ namespace edm {
       esids->push_back(selectorConfig());
     }
 
+    // The provenance of the products made in this process goes into a BranchMapper of its
+    // own, which falls back to the parent's, so subprocesses of the same parent never change
+    // what they share.
+    boost::shared_ptr<BranchMapper> mapper(new BranchMapper);
+    mapper->mergeMappers(principal.branchMapperPtr());
+
     EventPrincipal& ep = principalCache_.eventPrincipal();
     ep.fillEventPrincipal(aux,
                           esids,
                           boost::shared_ptr<BranchListIndexes>(new BranchListIndexes(principal.branchListIndexes())),
-                          principal.branchMapperPtr(),
+                          mapper,
                           principal.reader());
     ep.setLuminosityBlockPrincipal(principalCache_.lumiPrincipalPtr());
     propagateProducts(InEvent, principal, ep);
     typedef OccurrenceTraits<EventPrincipal, BranchActionBegin> Traits;
     schedule_->processOneOccurrence<Traits>(ep, esInfo_->es_);
-    if(subProcess_.get()) subProcess_->doEvent(ep, esInfo_->ts_);
+    doEvent(subProcesses_, ep, esInfo_->ts_, concurrentSubProcesses_);
     ep.clearEventPrincipal();
   }
 
@@ -254,7 +327,7 @@ namespace edm {
     propagateProducts(InRun, principal, rp);
     typedef OccurrenceTraits<RunPrincipal, BranchActionBegin> Traits;
     schedule_->processOneOccurrence<Traits>(rp, esInfo_->es_);
-    if(subProcess_.get()) subProcess_->doBeginRun(rp, esInfo_->ts_);
+    for(auto& subProcess : subProcesses_) subProcess->doBeginRun(rp, esInfo_->ts_);
   }
 
   void
@@ -273,7 +346,7 @@ namespace edm {
     propagateProducts(InRun, principal, rp);
     typedef OccurrenceTraits<RunPrincipal, BranchActionEnd> Traits;
     schedule_->processOneOccurrence<Traits>(rp, esInfo_->es_, cleaningUpAfterException_);
-    if(subProcess_.get()) subProcess_->doEndRun(rp, esInfo_->ts_, cleaningUpAfterException_);
+    for(auto& subProcess : subProcesses_) subProcess->doEndRun(rp, esInfo_->ts_, cleaningUpAfterException_);
   }
 
   void
@@ -282,7 +355,7 @@ namespace edm {
     std::map<ProcessHistoryID, ProcessHistoryID>::const_iterator it = parentToChildPhID_.find(parentPhID);
     assert(it != parentToChildPhID_.end());
     schedule_->writeRun(principalCache_.runPrincipal(it->second, runNumber));
-    if(subProcess_.get()) subProcess_->writeRun(it->second, runNumber);
+    for(auto& subProcess : subProcesses_) subProcess->writeRun(it->second, runNumber);
   }
 
   void
@@ -290,7 +363,7 @@ namespace edm {
     std::map<ProcessHistoryID, ProcessHistoryID>::const_iterator it = parentToChildPhID_.find(parentPhID);
     assert(it != parentToChildPhID_.end());
     principalCache_.deleteRun(it->second, runNumber);
-    if(subProcess_.get()) subProcess_->deleteRunFromCache(it->second, runNumber);
+    for(auto& subProcess : subProcesses_) subProcess->deleteRunFromCache(it->second, runNumber);
   }
 
   void
@@ -314,7 +387,7 @@ namespace edm {
     propagateProducts(InLumi, principal, lbp);
     typedef OccurrenceTraits<LuminosityBlockPrincipal, BranchActionBegin> Traits;
     schedule_->processOneOccurrence<Traits>(lbp, esInfo_->es_);
-    if(subProcess_.get()) subProcess_->doBeginLuminosityBlock(lbp, esInfo_->ts_);
+    for(auto& subProcess : subProcesses_) subProcess->doBeginLuminosityBlock(lbp, esInfo_->ts_);
   }
 
   void
@@ -333,7 +406,7 @@ namespace edm {
     propagateProducts(InLumi, principal, lbp);
     typedef OccurrenceTraits<LuminosityBlockPrincipal, BranchActionEnd> Traits;
     schedule_->processOneOccurrence<Traits>(lbp, esInfo_->es_, cleaningUpAfterException_);
-    if(subProcess_.get()) subProcess_->doEndLuminosityBlock(lbp, esInfo_->ts_, cleaningUpAfterException_);
+    for(auto& subProcess : subProcesses_) subProcess->doEndLuminosityBlock(lbp, esInfo_->ts_, cleaningUpAfterException_);
   }
 
   void
@@ -342,7 +415,7 @@ namespace edm {
     std::map<ProcessHistoryID, ProcessHistoryID>::const_iterator it = parentToChildPhID_.find(parentPhID);
     assert(it != parentToChildPhID_.end());
     schedule_->writeLumi(principalCache_.lumiPrincipal(it->second, runNumber, lumiNumber));
-    if(subProcess_.get()) subProcess_->writeLumi(it->second, runNumber, lumiNumber);
+    for(auto& subProcess : subProcesses_) subProcess->writeLumi(it->second, runNumber, lumiNumber);
   }
 
   void
@@ -350,7 +423,17 @@ namespace edm {
     std::map<ProcessHistoryID, ProcessHistoryID>::const_iterator it = parentToChildPhID_.find(parentPhID);
     assert(it != parentToChildPhID_.end());
     principalCache_.deleteLumi(it->second, runNumber, lumiNumber);
-      if(subProcess_.get()) subProcess_->deleteLumiFromCache(it->second, runNumber, lumiNumber);
+    for(auto& subProcess : subProcesses_) subProcess->deleteLumiFromCache(it->second, runNumber, lumiNumber);
+  }
+
+  void
+  SubProcess::readKeptProducts(EventPrincipal const& parentPrincipal) const {
+    // Products the parent has not read yet are read into the parent, so they are read once
+    // and then shared, instead of each subprocess reading its own copy.
+    Selections const& keptVector = keptProducts()[InEvent];
+    for(Selections::const_iterator it = keptVector.begin(), itEnd = keptVector.end(); it != itEnd; ++it) {
+      parentPrincipal.getProductHolder((*it)->branchID(), true, false);
+    }
   }
 
   void
@@ -390,19 +473,29 @@ namespace edm {
     ServiceRegistry::Operate operate(serviceToken_);
     branchIDListHelper_->updateFromInput(fb.branchIDLists());
     schedule_->respondToOpenInputFile(fb);
-    if(subProcess_.get()) subProcess_->respondToOpenInputFile(fb);
+    for(auto& subProcess : subProcesses_) subProcess->respondToOpenInputFile(fb);
+  }
+
+  bool
+  SubProcess::terminate(std::vector<std::unique_ptr<SubProcess> > const& iSubProcesses) {
+    for(auto const& subProcess : iSubProcesses) {
+      if(!subProcess->terminate()) {
+        return false;
+      }
+    }
+    return true;
   }
 
   // free function
-  std::auto_ptr<ParameterSet>
-  popSubProcessParameterSet(ParameterSet& parameterSet) {
+  std::vector<ParameterSet>
+  popSubProcessVParameterSet(ParameterSet& parameterSet) {
     std::vector<std::string> subProcesses = parameterSet.getUntrackedParameter<std::vector<std::string> >("@all_subprocesses");
-    if(!subProcesses.empty()) {
-      assert(subProcesses.size() == 1U);
-      assert(subProcesses[0] == "@sub_process");
-      return parameterSet.popParameterSet(subProcesses[0]);
+    std::vector<ParameterSet> subProcessPSets;
+    subProcessPSets.reserve(subProcesses.size());
+    for(auto const& subProcess : subProcesses) {
+      subProcessPSets.push_back(*parameterSet.popParameterSet(subProcess));
     }
-    return std::auto_ptr<ParameterSet>(0);
+    return subProcessPSets;
   }
 }
 
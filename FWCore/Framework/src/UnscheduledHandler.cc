@@ -11,12 +11,18 @@
 //
 
 // system include files
+#include <algorithm>
 #include <cassert>
 #include <iostream>
+#include <utility>
+#include <vector>
+
+#include "boost/thread/tss.hpp"
 
 // user include files
 #include "FWCore/Framework/interface/UnscheduledHandler.h"
 #include "FWCore/Framework/interface/CurrentProcessingContext.h"
+#include "FWCore/Utilities/interface/EDMException.h"
 
 
 namespace edm {
@@ -27,6 +33,37 @@ namespace edm {
   //
   // static data member definitions
   //
+  namespace {
+    typedef std::pair<EventPrincipal const*, std::string> RunningModule;
+
+    // Unscheduled modules for one event can be run on several threads at
+    // once, so what is being run is kept for each thread.
+    struct ThreadState {
+      ThreadState() : context_(0), running_() {}
+      CurrentProcessingContext const* context_;
+      std::vector<RunningModule> running_;
+    };
+
+    ThreadState& threadState() {
+      static boost::thread_specific_ptr<ThreadState> s_state;
+      if(0 == s_state.get()) {
+        s_state.reset(new ThreadState);
+      }
+      return *s_state;
+    }
+
+    class RunningSentry {
+    public:
+      RunningSentry(std::vector<RunningModule>& iRunning, RunningModule const& iModule) : running_(iRunning) {
+        running_.push_back(iModule);
+      }
+      ~RunningSentry() {
+        running_.pop_back();
+      }
+    private:
+      std::vector<RunningModule>& running_;
+    };
+  }
 
   //
   // constructors and destructor
@@ -57,8 +94,9 @@ namespace edm {
   //
   CurrentProcessingContext const*
   UnscheduledHandler::setCurrentProcessingContext(CurrentProcessingContext const* iContext) {
-     CurrentProcessingContext const* old = m_context;
-     m_context = iContext;
+     ThreadState& state = threadState();
+     CurrentProcessingContext const* old = state.context_;
+     state.context_ = iContext;
      return old;
   }
 
@@ -72,11 +110,31 @@ namespace edm {
   UnscheduledHandler::tryToFill(std::string const& label,
                                 EventPrincipal& iEvent) {
      assert(m_setup);
-     CurrentProcessingContext const* chosen = m_context;
+     ThreadState& state = threadState();
+
+     // If it is a module already currently running in unscheduled
+     // mode, then there is a circular dependency related to which
+     // EDProducts modules require and produce.  There is no safe way
+     // to recover from this.  Here we check for this problem and throw
+     // an exception.
+     RunningModule const module(&iEvent, label);
+     if(std::find(state.running_.begin(), state.running_.end(), module) != state.running_.end()) {
+        throw Exception(errors::LogicError)
+          << "Hit circular dependency while trying to run an unscheduled module.\n"
+          << "Current implementation of unscheduled execution cannot always determine\n"
+          << "the proper order for module execution.  It is also possible the modules\n"
+          << "have a built in circular dependence that will not work with any order.\n"
+          << "In the first case, scheduling some or all required modules in paths will help.\n"
+          << "In the second case, the modules themselves will have to be fixed.\n";
+     }
+     RunningSentry running(state.running_, module);
+
+     CurrentProcessingContext const* context = state.context_;
+     CurrentProcessingContext const* chosen = context;
      CurrentProcessingContext temp;
-     if(0 != m_context) {
-        temp = *m_context;
-        temp.setUnscheduledDepth(m_context->unscheduledDepth());
+     if(0 != context) {
+        temp = *context;
+        temp.setUnscheduledDepth(context->unscheduledDepth());
         chosen = &temp;
      }
      UnscheduledHandlerSentry sentry(this, chosen);
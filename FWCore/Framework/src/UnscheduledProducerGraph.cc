@@ -0,0 +1,291 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     UnscheduledProducerGraph
+//
+// Implementation:
+//     A producer depends on another if it declared it reads one of the other's
+//     products. The UnscheduledPrerequisites of a consumer holds the producers
+//     it needs in an order where each producer comes after those it depends on.
+//     When run, every producer starts as a task as soon as the count of the
+//     producers it is still waiting for drops to zero. Meanwhile the waiting
+//     thread only runs these tasks and the UnscheduledHandler knows what it
+//     waits for, so a circular dependency through the tasks is reported
+//     instead of hanging the job.
+//
+// $Id$
+//
+
+// system include files
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+#include "boost/shared_ptr.hpp"
+
+// user include files
+#include "FWCore/Framework/src/UnscheduledProducerGraph.h"
+#include "DataFormats/Provenance/interface/ProductRegistry.h"
+#include "FWCore/Framework/interface/EventPrincipal.h"
+#include "FWCore/Framework/interface/UnscheduledHandler.h"
+#include "FWCore/Framework/src/Worker.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
+
+using namespace edm;
+
+//
+// UnscheduledPrerequisites
+//
+void
+UnscheduledPrerequisites::run(EventPrincipal& iEvent, CurrentProcessingContext const* iContext) const
+{
+  boost::shared_ptr<UnscheduledHandler> handler = iEvent.unscheduledHandler();
+  if(not handler) {
+    return;
+  }
+  auto runProducer = [&handler, &iEvent, iContext](std::string const& iLabel) {
+    UnscheduledHandlerSentry sentry(handler.get(), iContext);
+    try {
+      handler->tryToFill(iLabel, iEvent);
+    } catch(...) {
+      //the Worker keeps the exception and rethrows it when its products are asked for
+    }
+  };
+
+  if(labels_.size() == 1) {
+    runProducer(*labels_[0]);
+    return;
+  }
+
+  std::unique_ptr<std::atomic<unsigned int>[]> waitingFor(new std::atomic<unsigned int>[labels_.size()]);
+  for(unsigned int i = 0; i != labels_.size(); ++i) {
+    waitingFor[i] = nDependencies_[i];
+  }
+
+  class WaitingSentry {
+  public:
+    WaitingSentry(UnscheduledHandler& iHandler, std::vector<std::string const*> const& iLabels) :
+      handler_(iHandler), labels_(iLabels) {
+      handler_.startWaitingFor(labels_);
+    }
+    ~WaitingSentry() {
+      handler_.stopWaitingFor(labels_);
+    }
+  private:
+    UnscheduledHandler& handler_;
+    std::vector<std::string const*> const& labels_;
+  };
+
+  Service<TaskScheduler> scheduler;
+  TaskScheduler::isolate([&]() {
+    WaitingSentry waiting(*handler, labels_);
+    TaskScheduler::TaskGroup tasks(*scheduler);
+    std::function<void(unsigned int)> runNode = [&](unsigned int iNode) {
+      runProducer(*labels_[iNode]);
+      for(auto dependent : dependents_[iNode]) {
+        if(0 == --waitingFor[dependent]) {
+          tasks.run([&runNode, dependent]() { runNode(dependent); });
+        }
+      }
+    };
+    for(unsigned int i = 0; i != labels_.size(); ++i) {
+      if(0 == nDependencies_[i]) {
+        tasks.run([&runNode, i]() { runNode(i); });
+      }
+    }
+    tasks.wait();
+  });
+}
+
+//
+// constructors and destructor
+//
+UnscheduledProducerGraph::Node::Node(Worker* iWorker, Branches const* iReads):
+  worker_(iWorker),
+  readsKnown_(0 != iReads),
+  reads_(iReads ? *iReads : Branches()),
+  dependencies_()
+{
+}
+
+UnscheduledProducerGraph::UnscheduledProducerGraph():
+  producers_(),
+  consumers_(),
+  prerequisites_(),
+  pruned_()
+{
+}
+
+//
+// member functions
+//
+void
+UnscheduledProducerGraph::addProducer(Worker* iProducer, Branches const* iReads)
+{
+  producers_.emplace_back(iProducer, iReads);
+}
+
+void
+UnscheduledProducerGraph::addConsumer(Worker* iConsumer, Branches const* iReads)
+{
+  consumers_.emplace_back(iConsumer, iReads);
+}
+
+void
+UnscheduledProducerGraph::build(ProductRegistry const& iRegistry, bool iAllProductsMayBeRead)
+{
+  std::map<std::string, unsigned int> labelToProducer;
+  for(unsigned int i = 0; i != producers_.size(); ++i) {
+    labelToProducer[producers_[i].worker_->description().moduleLabel()] = i;
+  }
+  std::map<std::string, unsigned int> branchToProducer;
+  for(auto const& keyAndDescription : iRegistry.productList()) {
+    BranchDescription const& desc = keyAndDescription.second;
+    if(not desc.produced()) {
+      continue;
+    }
+    auto itFound = labelToProducer.find(desc.moduleLabel());
+    if(itFound != labelToProducer.end()) {
+      branchToProducer[desc.branchName()] = itFound->second;
+    }
+  }
+
+  for(auto& producer : producers_) {
+    findDependencies(producer, branchToProducer);
+  }
+  for(auto& consumer : consumers_) {
+    findDependencies(consumer, branchToProducer);
+  }
+  removeCycles();
+
+  //the UnscheduledPrerequisites must not move once handed to the Workers
+  unsigned int nWithPrerequisites = 0;
+  for(auto const& consumer : consumers_) {
+    if(not consumer.dependencies_.empty()) {
+      ++nWithPrerequisites;
+    }
+  }
+  prerequisites_.clear();
+  prerequisites_.reserve(nWithPrerequisites);
+
+  bool allReadsKnown = not iAllProductsMayBeRead;
+  std::vector<bool> needed(producers_.size(), false);
+  for(auto const& consumer : consumers_) {
+    if(not consumer.readsKnown_) {
+      allReadsKnown = false;
+    } else if(not consumer.dependencies_.empty()) {
+      prerequisites_.emplace_back();
+      fillPrerequisites(consumer, prerequisites_.back(), needed);
+      consumer.worker_->setUnscheduledPrerequisites(&prerequisites_.back());
+    }
+  }
+  for(unsigned int i = 0; i != producers_.size(); ++i) {
+    if(needed[i] and not producers_[i].readsKnown_) {
+      allReadsKnown = false;
+    }
+  }
+
+  pruned_.clear();
+  if(allReadsKnown) {
+    for(unsigned int i = 0; i != producers_.size(); ++i) {
+      if(not needed[i]) {
+        pruned_.push_back(producers_[i].worker_);
+      }
+    }
+  }
+  LogInfo("UnscheduledDependencies")
+    << prerequisites_.size() << " modules run the unscheduled producers they read from before they are run, "
+    << pruned_.size() << " of the " << producers_.size() << " unscheduled producers are never read from and are not run.";
+}
+
+void
+UnscheduledProducerGraph::findDependencies(Node& iNode, std::map<std::string, unsigned int> const& iBranchToProducer) const
+{
+  iNode.dependencies_.clear();
+  for(auto const& branch : iNode.reads_) {
+    //have to put back the period which is not part of the 'mightGet' names
+    auto itFound = iBranchToProducer.find(branch + ".");
+    if(itFound == iBranchToProducer.end() or producers_[itFound->second].worker_ == iNode.worker_) {
+      continue;
+    }
+    if(std::find(iNode.dependencies_.begin(), iNode.dependencies_.end(), itFound->second) == iNode.dependencies_.end()) {
+      iNode.dependencies_.push_back(itFound->second);
+    }
+  }
+}
+
+void
+UnscheduledProducerGraph::removeCycles()
+{
+  enum Color { kNotVisited, kVisiting, kVisited };
+  std::vector<Color> color(producers_.size(), kNotVisited);
+  std::function<void(unsigned int)> visit = [&](unsigned int iNode) {
+    color[iNode] = kVisiting;
+    std::vector<unsigned int>& dependencies = producers_[iNode].dependencies_;
+    for(auto it = dependencies.begin(); it != dependencies.end();) {
+      if(color[*it] == kVisiting) {
+        LogWarning("UnscheduledDependencies")
+          << "The unscheduled module '" << producers_[iNode].worker_->description().moduleLabel()
+          << "' declares it reads from '" << producers_[*it].worker_->description().moduleLabel()
+          << "' which itself, directly or through other modules, reads from '"
+          << producers_[iNode].worker_->description().moduleLabel() << "'.\n"
+          << "This dependency is ignored when deciding in which order to run unscheduled modules.";
+        it = dependencies.erase(it);
+        continue;
+      }
+      if(color[*it] == kNotVisited) {
+        visit(*it);
+      }
+      ++it;
+    }
+    color[iNode] = kVisited;
+  };
+  for(unsigned int i = 0; i != producers_.size(); ++i) {
+    if(color[i] == kNotVisited) {
+      visit(i);
+    }
+  }
+}
+
+void
+UnscheduledProducerGraph::fillPrerequisites(Node const& iConsumer,
+                                            UnscheduledPrerequisites& oPrerequisites,
+                                            std::vector<bool>& ioNeeded) const
+{
+  //order the producers so each comes after the producers it depends on
+  std::vector<unsigned int> order;
+  std::vector<bool> seen(producers_.size(), false);
+  std::function<void(unsigned int)> visit = [&](unsigned int iNode) {
+    if(seen[iNode]) {
+      return;
+    }
+    seen[iNode] = true;
+    for(auto dependency : producers_[iNode].dependencies_) {
+      visit(dependency);
+    }
+    order.push_back(iNode);
+  };
+  for(auto dependency : iConsumer.dependencies_) {
+    visit(dependency);
+  }
+
+  std::map<unsigned int, unsigned int> producerToIndex;
+  for(unsigned int i = 0; i != order.size(); ++i) {
+    producerToIndex[order[i]] = i;
+  }
+  oPrerequisites.labels_.reserve(order.size());
+  oPrerequisites.nDependencies_.reserve(order.size());
+  oPrerequisites.dependents_.resize(order.size());
+  for(unsigned int i = 0; i != order.size(); ++i) {
+    Node const& producer = producers_[order[i]];
+    ioNeeded[order[i]] = true;
+    oPrerequisites.labels_.push_back(&producer.worker_->description().moduleLabel());
+    oPrerequisites.nDependencies_.push_back(producer.dependencies_.size());
+    for(auto dependency : producer.dependencies_) {
+      oPrerequisites.dependents_[producerToIndex[dependency]].push_back(i);
+    }
+  }
+}
@@ -0,0 +1,109 @@
+#ifndef FWCore_Framework_UnscheduledProducerGraph_h
+#define FWCore_Framework_UnscheduledProducerGraph_h
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     UnscheduledProducerGraph
+//
+/**\class UnscheduledProducerGraph UnscheduledProducerGraph.h FWCore/Framework/src/UnscheduledProducerGraph.h
+
+ Description: Dependencies between unscheduled producers and the modules which read their products
+
+ Usage:
+    The Schedule adds every unscheduled producer and every other module which reads event
+    data together with the branches the module declared, through 'mightGet', it reads. Once
+    the OutputModules know what they keep, the Schedule calls build. build
+
+    1) works out which unscheduled producers each module needs, including the producers
+       needed by those producers,
+    2) hands each module which needs at least one of them an UnscheduledPrerequisites. Before
+       the module is run for an event its UnscheduledPrerequisites runs the producers, with
+       producers which do not depend on each other running concurrently,
+    3) finds the unscheduled producers nobody reads from. These are not run for runs and
+       luminosity blocks, and for events only if a module asks for their products after all.
+
+    A module without 'mightGet' may read anything. It is given no UnscheduledPrerequisites
+    and, if it may read from unscheduled producers, no producer is pruned. Its unscheduled
+    products are still made on demand when it asks for them.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <map>
+#include <string>
+#include <vector>
+
+#include "boost/utility.hpp"
+
+// user include files
+
+// forward declarations
+namespace edm {
+  class CurrentProcessingContext;
+  class EventPrincipal;
+  class ProductRegistry;
+  class Worker;
+
+  class UnscheduledPrerequisites
+  {
+
+  public:
+    // ---------- const member functions ---------------------
+    ///runs each unscheduled producer once all the producers it needs have finished. A producer
+    /// which fails keeps its exception, which is rethrown when its products are asked for.
+    void run(EventPrincipal& iEvent, CurrentProcessingContext const* iContext) const;
+
+  private:
+    friend class UnscheduledProducerGraph;
+
+    // ---------- member data --------------------------------
+    std::vector<std::string const*> labels_;
+    std::vector<unsigned int> nDependencies_;
+    std::vector<std::vector<unsigned int> > dependents_;
+  };
+
+  class UnscheduledProducerGraph : private boost::noncopyable
+  {
+
+  public:
+    typedef std::vector<std::string> Branches;
+
+    UnscheduledProducerGraph();
+
+    // ---------- const member functions ---------------------
+    ///the unscheduled producers nobody reads from, filled by build
+    std::vector<Worker*> const& prunedProducers() const { return pruned_; }
+
+    // ---------- member functions ---------------------------
+    ///iReads are the branch names without the trailing '.', null if the module did not declare what it reads
+    void addProducer(Worker* iProducer, Branches const* iReads);
+    void addConsumer(Worker* iConsumer, Branches const* iReads);
+
+    ///iAllProductsMayBeRead is set if something which is not a module, e.g. a SubProcess, may read any product
+    void build(ProductRegistry const& iRegistry, bool iAllProductsMayBeRead);
+
+  private:
+    struct Node {
+      Node(Worker* iWorker, Branches const* iReads);
+      Worker* worker_;
+      bool readsKnown_;
+      Branches reads_;
+      std::vector<unsigned int> dependencies_;
+    };
+
+    void findDependencies(Node& iNode, std::map<std::string, unsigned int> const& iBranchToProducer) const;
+    void removeCycles();
+    void fillPrerequisites(Node const& iConsumer, UnscheduledPrerequisites& oPrerequisites, std::vector<bool>& ioNeeded) const;
+
+    // ---------- member data --------------------------------
+    std::vector<Node> producers_;
+    std::vector<Node> consumers_;
+    std::vector<UnscheduledPrerequisites> prerequisites_;
+    std::vector<Worker*> pruned_;
+  };
+}
+
+#endif
@@ -0,0 +1,83 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     ValidityIntervalIndex
+//
+// Implementation:
+//     An interval goes with the run/lumi/event based ones if both of its ends have a
+//     run number, otherwise with the time based ones if both of its ends have a time.
+//     Only IOVSyncValues which have a run number, or a time, are compared with those.
+//
+// $Id$
+//
+
+// system include files
+#include <algorithm>
+
+// user include files
+#include "FWCore/Framework/interface/ValidityIntervalIndex.h"
+
+namespace edm {
+   namespace {
+      bool hasEventID(IOVSyncValue const& iValue) {
+         return 0 != iValue.eventID().run();
+      }
+      bool hasTime(IOVSyncValue const& iValue) {
+         return 0 != iValue.time().value();
+      }
+
+      struct StartsAfter {
+         bool operator()(IOVSyncValue const& iTime, ValidityInterval const& iInterval) const {
+            return iTime < iInterval.first();
+         }
+         bool operator()(ValidityInterval const& iInterval, IOVSyncValue const& iTime) const {
+            return iInterval.first() < iTime;
+         }
+      };
+
+      ValidityInterval const* findIn(std::vector<ValidityInterval> const& iIntervals, IOVSyncValue const& iTime) {
+         //the last interval starting at or before iTime is the only one which can hold it
+         std::vector<ValidityInterval>::const_iterator itFound =
+            std::upper_bound(iIntervals.begin(), iIntervals.end(), iTime, StartsAfter());
+         if(itFound == iIntervals.begin()) {
+            return 0;
+         }
+         --itFound;
+         return itFound->validFor(iTime) ? &(*itFound) : 0;
+      }
+
+      void insertIn(std::vector<ValidityInterval>& iIntervals, ValidityInterval const& iInterval) {
+         std::vector<ValidityInterval>::iterator itFound =
+            std::lower_bound(iIntervals.begin(), iIntervals.end(), iInterval.first(), StartsAfter());
+         if(itFound != iIntervals.end() && itFound->first() == iInterval.first()) {
+            return;
+         }
+         iIntervals.insert(itFound, iInterval);
+      }
+   }
+
+   ValidityInterval const*
+   ValidityIntervalIndex::find(IOVSyncValue const& iTime) const {
+      ValidityInterval const* returnValue = 0;
+      if(hasEventID(iTime)) {
+         returnValue = findIn(byEventID_, iTime);
+      }
+      if(0 == returnValue && hasTime(iTime)) {
+         returnValue = findIn(byTime_, iTime);
+      }
+      return returnValue;
+   }
+
+   void
+   ValidityIntervalIndex::insert(ValidityInterval const& iInterval) {
+      if(iInterval.first() == IOVSyncValue::invalidIOVSyncValue() ||
+         iInterval.last() == IOVSyncValue::invalidIOVSyncValue()) {
+         return;
+      }
+      if(hasEventID(iInterval.first()) && hasEventID(iInterval.last())) {
+         insertIn(byEventID_, iInterval);
+      } else if(hasTime(iInterval.first()) && hasTime(iInterval.last())) {
+         insertIn(byTime_, iInterval);
+      }
+   }
+}
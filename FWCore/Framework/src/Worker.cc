@@ -4,6 +4,7 @@
 
 #include "FWCore/Framework/src/Worker.h"
 #include "FWCore/Framework/src/EarlyDeleteHelper.h"
+#include "FWCore/Framework/src/UnscheduledProducerGraph.h"
 
 namespace edm {
   namespace {
@@ -54,7 +55,8 @@ private:
     actions_(iWP.actions_),
     cached_exception_(),
     actReg_(),
-    earlyDeleteHelper_(0)
+    earlyDeleteHelper_(0),
+    unscheduledPrerequisites_(0)
   {
   }
 
@@ -68,6 +70,14 @@ private:
   void Worker::setEarlyDeleteHelper(EarlyDeleteHelper* iHelper) {
     earlyDeleteHelper_=iHelper;
   }
+
+  void Worker::setUnscheduledPrerequisites(UnscheduledPrerequisites const* iPrerequisites) {
+    unscheduledPrerequisites_ = iPrerequisites;
+  }
+
+  void Worker::runUnscheduledPrerequisites(EventPrincipal& ep, CurrentProcessingContext const* cpc) {
+    unscheduledPrerequisites_->run(ep, cpc);
+  }
   
   void Worker::beginJob() {
     try {
@@ -43,6 +43,7 @@ the worker is reset().
 namespace edm {
   class EventPrincipal;
   class EarlyDeleteHelper;
+  class UnscheduledPrerequisites;
 
   class Worker : private boost::noncopyable {
   public:
@@ -78,13 +79,42 @@ namespace edm {
     
     void setEarlyDeleteHelper(EarlyDeleteHelper* iHelper);
 
+    ///The unscheduled producers to run before this module is run for an event
+    void setUnscheduledPrerequisites(UnscheduledPrerequisites const* iPrerequisites);
+
     std::pair<double, double> timeCpuReal() const {
       return std::pair<double, double>(stopwatch_->cpuTime(), stopwatch_->realTime());
     }
 
+    struct Counters {
+      int timesRun_;
+      int timesVisited_;
+      int timesPassed_;
+      int timesFailed_;
+      int timesExcept_;
+    };
+
     void clearCounters() {
       timesRun_ = timesVisited_ = timesPassed_ = timesFailed_ = timesExcept_ = 0;
     }
+    Counters counters() const {
+      Counters c = {timesRun_, timesVisited_, timesPassed_, timesFailed_, timesExcept_};
+      return c;
+    }
+    void setCounters(Counters const& c) {
+      timesRun_ = c.timesRun_;
+      timesVisited_ = c.timesVisited_;
+      timesPassed_ = c.timesPassed_;
+      timesFailed_ = c.timesFailed_;
+      timesExcept_ = c.timesExcept_;
+    }
+    void addToCounters(Worker const& other) {
+      timesRun_ += other.timesRun_;
+      timesVisited_ += other.timesVisited_;
+      timesPassed_ += other.timesPassed_;
+      timesFailed_ += other.timesFailed_;
+      timesExcept_ += other.timesExcept_;
+    }
     
     void useStopwatch();
 
@@ -123,6 +153,11 @@ namespace edm {
     virtual void implPreForkReleaseResources() = 0;
     virtual void implPostForkReacquireResources(unsigned int iChildIndex,
                                                unsigned int iNumberOfChildren) = 0;
+
+    void runUnscheduledPrerequisites(EventPrincipal& ep, CurrentProcessingContext const* cpc);
+    void runUnscheduledPrerequisites(LuminosityBlockPrincipal&, CurrentProcessingContext const*) {}
+    void runUnscheduledPrerequisites(RunPrincipal&, CurrentProcessingContext const*) {}
+
     RunStopwatch::StopwatchPointer stopwatch_;
 
     int timesRun_;
@@ -139,6 +174,8 @@ namespace edm {
     boost::shared_ptr<ActivityRegistry> actReg_;
     
     EarlyDeleteHelper* earlyDeleteHelper_;
+
+    UnscheduledPrerequisites const* unscheduledPrerequisites_;
   };
 
   namespace {
@@ -226,6 +263,10 @@ namespace edm {
 
     if (T::isEvent_) ++timesRun_;
 
+    if (unscheduledPrerequisites_) {
+      runUnscheduledPrerequisites(ep, cpc);
+    }
+
     try {
       try {
 
@@ -35,9 +35,32 @@ namespace edm {
       return std::pair<double,double>(0.,0.);
     }
 
+    struct Counters {
+      int timesVisited_;
+      int timesPassed_;
+      int timesFailed_;
+      int timesExcept_;
+    };
+
     void clearCounters() {
       timesVisited_ = timesPassed_ = timesFailed_ = timesExcept_ = 0;
     }
+    Counters counters() const {
+      Counters c = {timesVisited_, timesPassed_, timesFailed_, timesExcept_};
+      return c;
+    }
+    void setCounters(Counters const& c) {
+      timesVisited_ = c.timesVisited_;
+      timesPassed_ = c.timesPassed_;
+      timesFailed_ = c.timesFailed_;
+      timesExcept_ = c.timesExcept_;
+    }
+    void addToCounters(WorkerInPath const& other) {
+      timesVisited_ += other.timesVisited_;
+      timesPassed_ += other.timesPassed_;
+      timesFailed_ += other.timesFailed_;
+      timesExcept_ += other.timesExcept_;
+    }
     void useStopwatch();
     
     int timesVisited() const { return timesVisited_; }
@@ -21,7 +21,8 @@ Maker::createModuleDescription(WorkerParams const &p) const {
   ModuleDescription md(conf.id(),
 		       conf.getParameter<std::string>("@module_type"),
 		       conf.getParameter<std::string>("@module_label"),
-  		       p.processConfiguration_.get());
+  		       p.processConfiguration_.get(),
+		       ModuleDescription::getUniqueID());
   return md;
 }
 
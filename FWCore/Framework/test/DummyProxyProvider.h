@@ -43,6 +43,10 @@ protected:
    }
    void invalidateCache() {
    }   
+   //the data never changes
+   unsigned long long dataFingerprint() const {
+      return reinterpret_cast<unsigned long long>(data_);
+   }
 private:
    const DummyData* data_;
 };
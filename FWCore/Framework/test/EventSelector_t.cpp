@@ -11,6 +11,7 @@
 #include "boost/array.hpp"
 #include "boost/shared_ptr.hpp"
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <iostream>
@@ -165,6 +166,81 @@ void testall(const Strings& paths,
     }
 }
 
+// The selectors were built for previous processes, and the TriggerResults
+// alternate between menus whose trigger names are in another order or
+// differ. The selectors must switch to the criteria of each menu, whether
+// they made them for that event or kept them from an earlier one.
+void testmenus()
+{
+  boost::array<char const*, numBits> cmenu1 = {{"a1","a2","a3","a4","a5"}};
+  boost::array<char const*, numBits> cmenu2 = {{"a5","a4","a3","a2","a1"}};
+  boost::array<char const*, numBits> cmenu3 = {{"b1","a1","b2","a2","b3"}};
+  VStrings menus;
+  menus.push_back(Strings(cmenu1.begin(),cmenu1.end()));
+  menus.push_back(Strings(cmenu2.begin(),cmenu2.end()));
+  menus.push_back(Strings(cmenu3.begin(),cmenu3.end()));
+
+  std::vector<ParameterSetID> menuIDs;
+  for (unsigned int m = 0; m < menus.size(); ++m) {
+    ParameterSet trigger_pset;
+    trigger_pset.addParameter<Strings>("@trigger_paths", menus[m]);
+    trigger_pset.registerIt();
+    menuIDs.push_back(trigger_pset.id());
+  }
+
+  Strings patternA;
+  patternA.push_back("a1");
+  patternA.push_back("a2");
+  Strings patternB(1, "!a1");
+  Strings patternC(1, "a*");
+
+  // selectA and selectA2 are made from the same pattern
+  EventSelector selectA(patternA);
+  EventSelector selectA2(patternA);
+  EventSelector selectB(patternB);
+  EventSelector selectC(patternC);
+
+  // the one path which passes in each event, the others fail
+  boost::array<char const*, 6> passing = {{"a1","a2","a3","a5","b1",""}};
+  int const menuOrder[] = {0, 1, 0, 2, 1, 2, 0, 2};
+
+  for (unsigned int i = 0; i < sizeof(menuOrder)/sizeof(menuOrder[0]); ++i) {
+    Strings const& menu = menus[menuOrder[i]];
+    for (unsigned int p = 0; p < passing.size(); ++p) {
+      std::string const pass(passing[p]);
+      HLTGlobalStatus bm(menu.size());
+      for (unsigned int b = 0; b < menu.size(); ++b) {
+        bm[b] = HLTPathStatus(menu[b] == pass ? edm::hlt::Pass : edm::hlt::Fail);
+      }
+      TriggerResults results(bm, menuIDs[menuOrder[i]]);
+
+      // a1 and a2 are in every menu
+      bool const inMenu = std::find(menu.begin(), menu.end(), pass) != menu.end();
+      bool const answerA = pass == "a1" || pass == "a2";
+      bool const answerB = pass != "a1";
+      bool const answerC = inMenu && pass[0] == 'a';
+
+      // a selector which only ever sees this menu
+      EventSelector freshC(patternC);
+
+      bool const a = selectA.acceptEvent(results);
+      bool const a2 = selectA2.acceptEvent(results);
+      bool const b = selectB.acceptEvent(results);
+      bool const c = selectC.acceptEvent(results);
+      bool const fc = freshC.acceptEvent(results);
+
+      if (a != answerA || a2 != answerA || b != answerB || c != answerC || fc != answerC)
+        {
+          std::cerr << "failed to select after changing the trigger menu: "
+               << "correct=" << answerA << " " << answerB << " " << answerC << " "
+               << "results=" << a << "  " << a2 << "  " << b << "  " << c << "  " << fc << "\n"
+               << "menu=" << menu << "\n"
+               << "passing=" << pass << "\n";
+          abort();
+        }
+    }
+  }
+}
 
 int main()
 try {
@@ -279,6 +355,7 @@ try {
   // We are ready to run some tests
 
   testall(paths, patterns, testmasks, ans);
+  testmenus();
   return 0;
 } catch(cms::Exception const& e) {
   std::cerr << e.explainSelf() << std::endl;
@@ -43,6 +43,7 @@ CPPUNIT_TEST(resetTest);
 CPPUNIT_TEST(alternateFinderTest);
 CPPUNIT_TEST(invalidRecordTest);
 CPPUNIT_TEST(extendIOVTest);
+CPPUNIT_TEST(presentRecordsValidTest);
 
   
 CPPUNIT_TEST_SUITE_END();
@@ -62,6 +63,7 @@ public:
   void alternateFinderTest();
   void invalidRecordTest();
   void extendIOVTest();
+  void presentRecordsValidTest();
   
 }; //Cppunit class declaration over
 
@@ -927,3 +929,39 @@ void testdependentrecord::extendIOVTest()
    }
 
 }
+
+void testdependentrecord::presentRecordsValidTest()
+{
+   edm::eventsetup::EventSetupProvider provider;
+   boost::shared_ptr<edm::eventsetup::DataProxyProvider> dummyProv{new DummyProxyProvider{}};
+   provider.add(dummyProv);
+
+   boost::shared_ptr<DummyFinder> dummyFinder{new DummyFinder};
+   dummyFinder->setInterval(edm::ValidityInterval{edm::IOVSyncValue{edm::EventID{1, 1, 1}},
+                                                  edm::IOVSyncValue{edm::EventID{1, 1, 10}}});
+   provider.add(boost::shared_ptr<edm::EventSetupRecordIntervalFinder>{dummyFinder});
+
+   boost::shared_ptr<edm::eventsetup::DataProxyProvider> depProv{new DepOn2RecordProxyProvider{}};
+   provider.add(depProv);
+
+   //Dummy2Record only becomes valid at event 4
+   boost::shared_ptr<Dummy2RecordFinder> dummy2Finder{new Dummy2RecordFinder};
+   dummy2Finder->setInterval(edm::ValidityInterval{edm::IOVSyncValue{edm::EventID{1, 1, 4}},
+                                                   edm::IOVSyncValue{edm::EventID{1, 1, 10}}});
+   provider.add(boost::shared_ptr<edm::EventSetupRecordIntervalFinder>{dummy2Finder});
+
+   const edm::EventSetup& eventSetup = provider.eventSetupForInstance(edm::IOVSyncValue(edm::EventID(1, 1, 1)));
+   CPPUNIT_ASSERT(0 != eventSetup.find(DummyRecord::keyForClass()));
+   CPPUNIT_ASSERT(0 == eventSetup.find(Dummy2Record::keyForClass()));
+
+   //records without an IOV must not force the EventSetup to be updated
+   CPPUNIT_ASSERT(provider.presentRecordsAreValidFor(edm::IOVSyncValue(edm::EventID(1, 1, 2))));
+   CPPUNIT_ASSERT(provider.presentRecordsAreValidFor(edm::IOVSyncValue(edm::EventID(1, 1, 3))));
+   //an absent record whose finder now has an IOV does
+   CPPUNIT_ASSERT(!provider.presentRecordsAreValidFor(edm::IOVSyncValue(edm::EventID(1, 1, 4))));
+
+   provider.eventSetupForInstance(edm::IOVSyncValue(edm::EventID(1, 1, 4)));
+   CPPUNIT_ASSERT(provider.presentRecordsAreValidFor(edm::IOVSyncValue(edm::EventID(1, 1, 5))));
+   //a present record whose IOV ended
+   CPPUNIT_ASSERT(!provider.presentRecordsAreValidFor(edm::IOVSyncValue(edm::EventID(1, 1, 11))));
+}
@@ -0,0 +1,147 @@
+// Compares the time to get data from an EventSetupRecord by label and by ESGetTokenT with
+// the time taken to find the Proxy the way the Record used to, in a std::map keyed by
+// DataKey. The Record holds about as many Proxies as the large Records of a reconstruction job.
+// $Id$
+
+#include "FWCore/Framework/interface/DataKey.h"
+#include "FWCore/Framework/interface/DataProxyTemplate.h"
+#include "FWCore/Framework/interface/ESGetToken.h"
+#include "FWCore/Framework/interface/ESHandle.h"
+#include "FWCore/Framework/interface/EventSetupRecordImplementation.h"
+#include "FWCore/Framework/interface/HCTypeTag.h"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace esget_benchmark_t {
+  class BenchmarkRecord : public edm::eventsetup::EventSetupRecordImplementation<BenchmarkRecord> {};
+
+  template<int N> struct Product {
+    int value_;
+  };
+}
+using esget_benchmark_t::BenchmarkRecord;
+using esget_benchmark_t::Product;
+
+HCTYPETAG_HELPER_METHODS(BenchmarkRecord)
+HCTYPETAG_HELPER_METHODS(Product<0>)
+HCTYPETAG_HELPER_METHODS(Product<1>)
+HCTYPETAG_HELPER_METHODS(Product<2>)
+HCTYPETAG_HELPER_METHODS(Product<3>)
+HCTYPETAG_HELPER_METHODS(Product<4>)
+HCTYPETAG_HELPER_METHODS(Product<5>)
+HCTYPETAG_HELPER_METHODS(Product<6>)
+HCTYPETAG_HELPER_METHODS(Product<7>)
+
+namespace {
+  using edm::eventsetup::DataKey;
+  using edm::eventsetup::DataProxy;
+
+  template<int N>
+  class ProductProxy : public edm::eventsetup::DataProxyTemplate<BenchmarkRecord, Product<N> > {
+  protected:
+    Product<N> const* make(BenchmarkRecord const&, DataKey const&) { return &data_; }
+    void invalidateCache() {}
+  private:
+    Product<N> data_;
+  };
+
+  unsigned int const kNLabelsPerType = 16;
+  unsigned int const kNGets = 1000000;
+  unsigned int const kNRepeats = 5;
+
+  //the fastest of several tries, which is the least disturbed by other processes
+  template<typename F>
+  double bestTime(F iGet) {
+    double best = 0.;
+    for(unsigned int repeat = 0; repeat != kNRepeats; ++repeat) {
+      auto begin = std::chrono::steady_clock::now();
+      for(unsigned int i = 0; i != kNGets; ++i) {
+        iGet(i);
+      }
+      std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - begin;
+      double time = elapsed.count() / kNGets;
+      if(repeat == 0 || time < best) {
+        best = time;
+      }
+    }
+    return best;
+  }
+
+  std::vector<std::string> makeLabels() {
+    std::vector<std::string> labels;
+    labels.push_back(std::string());
+    for(unsigned int i = 1; i != kNLabelsPerType; ++i) {
+      labels.push_back("label" + std::to_string(i));
+    }
+    return labels;
+  }
+
+  template<int N>
+  void addProxies(BenchmarkRecord& iRecord,
+                  std::vector<std::string> const& iLabels,
+                  std::deque<ProductProxy<N> >& iProxies,
+                  std::map<DataKey, DataProxy const*>& iOldProxies) {
+    for(auto const& label : iLabels) {
+      iProxies.emplace_back();
+      DataKey key(DataKey::makeTypeTag<Product<N> >(), label.c_str());
+      iRecord.add(key, &iProxies.back());
+      iOldProxies.insert(std::make_pair(key, &iProxies.back()));
+    }
+  }
+}
+
+int main() {
+  std::vector<std::string> const labels = makeLabels();
+  BenchmarkRecord record;
+  std::map<DataKey, DataProxy const*> oldProxies;
+  std::deque<ProductProxy<0> > proxies0;
+  std::deque<ProductProxy<1> > proxies1;
+  std::deque<ProductProxy<2> > proxies2;
+  std::deque<ProductProxy<3> > proxies3;
+  std::deque<ProductProxy<4> > proxies4;
+  std::deque<ProductProxy<5> > proxies5;
+  std::deque<ProductProxy<6> > proxies6;
+  std::deque<ProductProxy<7> > proxies7;
+  addProxies(record, labels, proxies0, oldProxies);
+  addProxies(record, labels, proxies1, oldProxies);
+  addProxies(record, labels, proxies2, oldProxies);
+  addProxies(record, labels, proxies3, oldProxies);
+  addProxies(record, labels, proxies4, oldProxies);
+  addProxies(record, labels, proxies5, oldProxies);
+  addProxies(record, labels, proxies6, oldProxies);
+  addProxies(record, labels, proxies7, oldProxies);
+
+  //what a module asks for, the same item on every event
+  std::string const& label = labels[kNLabelsPerType / 2];
+  DataKey const key(DataKey::makeTypeTag<Product<5> >(), label.c_str(), DataKey::kDoNotCopyMemory);
+  edm::ESGetTokenT<Product<5> > token(label);
+
+  double oldTime = bestTime([&](unsigned int) {
+    DataProxy const* proxy = oldProxies.find(key)->second;
+    proxy->get(record, key, false);
+  });
+  double labelTime = bestTime([&](unsigned int) {
+    edm::ESHandle<Product<5> > handle;
+    record.get(label, handle);
+    assert(handle.isValid());
+  });
+  double tokenTime = bestTime([&](unsigned int) {
+    edm::ESHandle<Product<5> > handle;
+    record.get(token, handle);
+    assert(handle.isValid());
+  });
+
+  std::cout << "get from a Record with " << oldProxies.size() << " Proxies:\n"
+            << "  std::map lookup " << oldTime << " ns\n"
+            << "  get by label    " << labelTime << " ns\n"
+            << "  get by token    " << tokenTime << " ns" << std::endl;
+  return 0;
+}
@@ -10,10 +10,14 @@
 #include "FWCore/Framework/test/DummyData.h"
 #include "FWCore/Framework/test/DummyRecord.h"
 #include "FWCore/Framework/test/DummyFinder.h"
+#include "FWCore/Framework/test/DummyProxyProvider.h"
 #include "FWCore/Framework/test/DepRecord.h"
 #include "FWCore/Framework/interface/EventSetupProvider.h"
 #include "FWCore/Framework/interface/ESHandle.h"
 #include "FWCore/Framework/interface/ESProducts.h"
+#include "FWCore/Utilities/interface/typelookup.h"
+#include "FWCore/RootAutoLibraryLoader/interface/RootAutoLibraryLoader.h"
+#include "DataFormats/TestObjects/interface/ToyProducts.h"
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "FWCore/Utilities/interface/Exception.h"
@@ -22,6 +26,8 @@ using namespace edm::eventsetup;
 using edm::ESProducer;
 using edm::EventSetupRecordIntervalFinder;
 
+TYPELOOKUP_DATA_REG(edmtest::IntProduct);
+
 class testEsproducer: public CppUnit::TestFixture 
 {
 CPPUNIT_TEST_SUITE(testEsproducer);
@@ -34,6 +40,10 @@ CPPUNIT_TEST(dependsOnTest);
 CPPUNIT_TEST(labelTest);
 CPPUNIT_TEST_EXCEPTION(failMultipleRegistration,cms::Exception);
 CPPUNIT_TEST(forceCacheClearTest);
+CPPUNIT_TEST(reuseResultsTest);
+CPPUNIT_TEST(reuseResultsChangedInputTest);
+CPPUNIT_TEST(reuseResultsWithoutInputsTest);
+CPPUNIT_TEST(reuseResultsSamePayloadTest);
    
 CPPUNIT_TEST_SUITE_END();
 public:
@@ -48,6 +58,10 @@ public:
   void labelTest();
   void failMultipleRegistration();
   void forceCacheClearTest();
+  void reuseResultsTest();
+  void reuseResultsChangedInputTest();
+  void reuseResultsWithoutInputsTest();
+  void reuseResultsSamePayloadTest();
 
 private:
 class Test1Producer : public ESProducer {
@@ -126,6 +140,68 @@ private:
    boost::shared_ptr<DummyData> fi_;
 };
 
+class ReusedProducer : public ESProducer {
+public:
+   ReusedProducer(): ptr_(new DummyData){
+      ptr_->value_ = 0;
+      reuseResultsIfInputsUnchanged();
+      setWhatProduced(this);
+   }
+   boost::shared_ptr<DummyData> produce(const DummyRecord& /*iRecord*/) {
+      ++ptr_->value_;
+      return ptr_;
+   }
+private:
+   boost::shared_ptr<DummyData> ptr_;
+};
+
+class ReusingDepProducer : public ESProducer {
+public:
+   ReusingDepProducer(): calls_(0) {
+      reuseResultsIfInputsUnchanged();
+      setWhatProduced(this);
+   }
+   boost::shared_ptr<DummyData> produce(const DepRecord& iRecord) {
+      ++calls_;
+      edm::ESHandle<DummyData> pDummy;
+      iRecord.getRecord<DummyRecord>().get(pDummy);
+      boost::shared_ptr<DummyData> returnValue(new DummyData);
+      returnValue->value_ = 10*pDummy->value_;
+      return returnValue;
+   }
+   int calls_;
+};
+
+//like an ESSource, issues a new payload for each IOV
+class PayloadSource : public ESProducer {
+public:
+   PayloadSource(): value_(1), calls_(0) {
+      reuseResultsIfInputsUnchanged();
+      setWhatProduced(this);
+   }
+   boost::shared_ptr<edmtest::IntProduct> produce(const DummyRecord& /*iRecord*/) {
+      ++calls_;
+      return boost::shared_ptr<edmtest::IntProduct>(new edmtest::IntProduct(value_));
+   }
+   int value_;
+   int calls_;
+};
+
+class PayloadReader : public ESProducer {
+public:
+   PayloadReader(): calls_(0) {
+      reuseResultsIfInputsUnchanged();
+      setWhatProduced(this);
+   }
+   boost::shared_ptr<DummyData> produce(const DepRecord& iRecord) {
+      ++calls_;
+      edm::ESHandle<edmtest::IntProduct> pPayload;
+      iRecord.getRecord<DummyRecord>().get(pPayload);
+      return boost::shared_ptr<DummyData>(new DummyData(10*pPayload->value));
+   }
+   int calls_;
+};
+
 };
 
 ///registration of the test so that the runner can find it
@@ -368,3 +444,108 @@ void testEsproducer::forceCacheClearTest()
    }
 }
 
+void testEsproducer::reuseResultsTest()
+{
+   EventSetupProvider provider;
+   
+   ReusingDepProducer* pDepProd = new ReusingDepProducer;
+   DummyData dummy;
+   dummy.value_ = 1;
+   provider.add(boost::shared_ptr<DataProxyProvider>(new edm::eventsetup::test::DummyProxyProvider(dummy)));
+   provider.add(boost::shared_ptr<DataProxyProvider>(pDepProd));
+   
+   boost::shared_ptr<DummyFinder> pFinder(new DummyFinder);
+   provider.add(boost::shared_ptr<EventSetupRecordIntervalFinder>(pFinder));
+   
+   //the source tells through its fingerprint that it delivers the same data for each IOV
+   for(int iTime=1; iTime != 6; ++iTime) {
+      const edm::Timestamp time(iTime);
+      pFinder->setInterval(edm::ValidityInterval(edm::IOVSyncValue(time), edm::IOVSyncValue(time)));
+      const edm::EventSetup& eventSetup = provider.eventSetupForInstance(edm::IOVSyncValue(time));
+      edm::ESHandle<DummyData> pDummy;
+      eventSetup.get<DepRecord>().get(pDummy);
+      CPPUNIT_ASSERT(0 != &(*pDummy));
+      CPPUNIT_ASSERT(10 == pDummy->value_);
+      CPPUNIT_ASSERT(1 == pDepProd->calls_);
+
+      eventSetup.get<DummyRecord>().get(pDummy);
+      CPPUNIT_ASSERT(1 == pDummy->value_);
+   }
+}
+
+void testEsproducer::reuseResultsChangedInputTest()
+{
+   EventSetupProvider provider;
+   
+   ReusingDepProducer* pDepProd = new ReusingDepProducer;
+   provider.add(boost::shared_ptr<DataProxyProvider>(new Test1Producer));
+   provider.add(boost::shared_ptr<DataProxyProvider>(pDepProd));
+   
+   boost::shared_ptr<DummyFinder> pFinder(new DummyFinder);
+   provider.add(boost::shared_ptr<EventSetupRecordIntervalFinder>(pFinder));
+   
+   //Test1Producer makes new data for each IOV
+   for(int iTime=1; iTime != 6; ++iTime) {
+      const edm::Timestamp time(iTime);
+      pFinder->setInterval(edm::ValidityInterval(edm::IOVSyncValue(time), edm::IOVSyncValue(time)));
+      const edm::EventSetup& eventSetup = provider.eventSetupForInstance(edm::IOVSyncValue(time));
+      edm::ESHandle<DummyData> pDummy;
+      eventSetup.get<DepRecord>().get(pDummy);
+      CPPUNIT_ASSERT(0 != &(*pDummy));
+      CPPUNIT_ASSERT(10*iTime == pDummy->value_);
+      CPPUNIT_ASSERT(iTime == pDepProd->calls_);
+   }
+}
+
+void testEsproducer::reuseResultsWithoutInputsTest()
+{
+   EventSetupProvider provider;
+   
+   provider.add(boost::shared_ptr<DataProxyProvider>(new ReusedProducer));
+   
+   boost::shared_ptr<DummyFinder> pFinder(new DummyFinder);
+   provider.add(boost::shared_ptr<EventSetupRecordIntervalFinder>(pFinder));
+   
+   //nothing tells that the results are still valid so the producer is called for each IOV
+   for(int iTime=1; iTime != 6; ++iTime) {
+      const edm::Timestamp time(iTime);
+      pFinder->setInterval(edm::ValidityInterval(edm::IOVSyncValue(time), edm::IOVSyncValue(time)));
+      const edm::EventSetup& eventSetup = provider.eventSetupForInstance(edm::IOVSyncValue(time));
+      edm::ESHandle<DummyData> pDummy;
+      eventSetup.get<DummyRecord>().get(pDummy);
+      CPPUNIT_ASSERT(0 != &(*pDummy));
+      CPPUNIT_ASSERT(iTime == pDummy->value_);
+   }
+}
+
+void testEsproducer::reuseResultsSamePayloadTest()
+{
+   //the fingerprint of the payload is made by ROOT from its dictionary
+   edm::RootAutoLibraryLoader::enable();
+
+   EventSetupProvider provider;
+   
+   PayloadSource* pSource = new PayloadSource;
+   PayloadReader* pReader = new PayloadReader;
+   provider.add(boost::shared_ptr<DataProxyProvider>(pSource));
+   provider.add(boost::shared_ptr<DataProxyProvider>(pReader));
+   
+   boost::shared_ptr<DummyFinder> pFinder(new DummyFinder);
+   provider.add(boost::shared_ptr<EventSetupRecordIntervalFinder>(pFinder));
+   
+   //the source issues a new copy of the same payload for each IOV, until the payload changes at time 4
+   for(int iTime=1; iTime != 6; ++iTime) {
+      if(4 == iTime) {
+         pSource->value_ = 2;
+      }
+      const edm::Timestamp time(iTime);
+      pFinder->setInterval(edm::ValidityInterval(edm::IOVSyncValue(time), edm::IOVSyncValue(time)));
+      const edm::EventSetup& eventSetup = provider.eventSetupForInstance(edm::IOVSyncValue(time));
+      edm::ESHandle<DummyData> pDummy;
+      eventSetup.get<DepRecord>().get(pDummy);
+      CPPUNIT_ASSERT(0 != &(*pDummy));
+      CPPUNIT_ASSERT(iTime == pSource->calls_);
+      CPPUNIT_ASSERT((iTime < 4 ? 10 : 20) == pDummy->value_);
+      CPPUNIT_ASSERT((iTime < 4 ? 1 : 2) == pReader->calls_);
+   }
+}
@@ -0,0 +1,190 @@
+// -*- C++ -*-
+//
+// Package:     Framework
+// Class  :     eventblockscheduler_t_cppunit
+//
+// Implementation:
+//     The children are simulated: each processes its events at its own speed and the events
+//     at the end of the job take longer than the ones at the beginning.
+//
+// $Id$
+//
+
+// system include files
+#include <algorithm>
+#include <queue>
+#include <vector>
+
+// user include files
+#include "FWCore/Framework/src/EventBlockScheduler.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+using namespace edm::multicore;
+
+class testEventBlockScheduler: public CppUnit::TestFixture
+{
+   CPPUNIT_TEST_SUITE(testEventBlockScheduler);
+
+   CPPUNIT_TEST(fixedBlocksTest);
+   CPPUNIT_TEST(adaptiveBlocksTest);
+   CPPUNIT_TEST(unknownNumberOfEventsTest);
+   CPPUNIT_TEST(makespanTest);
+
+   CPPUNIT_TEST_SUITE_END();
+public:
+
+   void setUp(){}
+   void tearDown(){}
+
+   void fixedBlocksTest();
+   void adaptiveBlocksTest();
+   void unknownNumberOfEventsTest();
+   void makespanTest();
+
+}; //Cppunit class declaration over
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testEventBlockScheduler);
+
+namespace {
+   unsigned int const kNEvents = 10000;
+
+   double eventCost(unsigned long iIndex) {
+      return iIndex < kNEvents / 2 ? 1. : 3.;
+   }
+
+   struct Request {
+      double time_;
+      int child_;
+      unsigned long nEvents_;
+      double seconds_;
+      bool operator<(Request const& iOther) const { return time_ > iOther.time_; }
+   };
+
+   //returns when the last child finished and checks every event was given out once
+   double simulate(EventBlockScheduler& iScheduler, std::vector<double> const& iSpeeds) {
+      std::vector<unsigned int> timesGiven(kNEvents, 0);
+      std::priority_queue<Request> requests;
+      for(unsigned int child = 0; child != iSpeeds.size(); ++child) {
+         Request request = {0., static_cast<int>(child), 0, 0.};
+         requests.push(request);
+      }
+      double makespan = 0.;
+      while(!requests.empty()) {
+         Request request = requests.top();
+         requests.pop();
+         MessageForSource block = iScheduler.nextBlock(request.child_, request.nEvents_, request.seconds_);
+         //like a source, the child stops once there is nothing left to read
+         if(0 == block.nIndices || block.startIndex >= kNEvents) {
+            makespan = std::max(makespan, request.time_);
+            continue;
+         }
+         unsigned long end = std::min(block.startIndex + block.nIndices, static_cast<unsigned long>(kNEvents));
+         double seconds = 0.;
+         for(unsigned long index = block.startIndex; index != end; ++index) {
+            ++timesGiven[index];
+            seconds += eventCost(index) / iSpeeds[request.child_];
+         }
+         if(end != block.startIndex + block.nIndices) {
+            makespan = std::max(makespan, request.time_ + seconds);
+            continue;
+         }
+         Request next = {request.time_ + seconds, request.child_, block.nIndices, seconds};
+         requests.push(next);
+      }
+      CPPUNIT_ASSERT(std::count(timesGiven.begin(), timesGiven.end(), 1U) == static_cast<long>(kNEvents));
+      return makespan;
+   }
+
+   std::vector<double> speeds() {
+      std::vector<double> speeds(4, 1.);
+      speeds[3] = 0.25;
+      return speeds;
+   }
+
+   double idealMakespan(std::vector<double> const& iSpeeds) {
+      double work = 0.;
+      for(unsigned long index = 0; index != kNEvents; ++index) {
+         work += eventCost(index);
+      }
+      double speed = 0.;
+      for(unsigned int child = 0; child != iSpeeds.size(); ++child) {
+         speed += iSpeeds[child];
+      }
+      return work / speed;
+   }
+}
+
+void testEventBlockScheduler::fixedBlocksTest()
+{
+   EventBlockScheduler scheduler(4, 10, kNEvents, false);
+   MessageForSource block = scheduler.nextBlock(5, 0, 0.);
+   CPPUNIT_ASSERT(block.startIndex == 0 && block.nIndices == 10);
+   block = scheduler.nextBlock(6, 0, 0.);
+   CPPUNIT_ASSERT(block.startIndex == 10 && block.nIndices == 10);
+   block = scheduler.nextBlock(5, 10, 100.);
+   CPPUNIT_ASSERT(block.startIndex == 20 && block.nIndices == 10);
+}
+
+void testEventBlockScheduler::adaptiveBlocksTest()
+{
+   EventBlockScheduler scheduler(2, 1000, 100, true);
+   //the first blocks hold a quarter of what is left
+   MessageForSource block = scheduler.nextBlock(5, 0, 0.);
+   CPPUNIT_ASSERT(block.startIndex == 0 && block.nIndices == 25);
+   block = scheduler.nextBlock(6, 0, 0.);
+   CPPUNIT_ASSERT(block.startIndex == 25 && block.nIndices == 19);
+
+   //5 is as fast as the average, 6 is three times faster than 5
+   block = scheduler.nextBlock(5, 25, 1.);
+   CPPUNIT_ASSERT(block.startIndex == 44 && block.nIndices == 14);
+   block = scheduler.nextBlock(6, 19, 0.76 / 3.);
+   CPPUNIT_ASSERT(block.startIndex == 58 && block.nIndices == 16);
+
+   //the blocks never go past the end
+   unsigned long end = 74;
+   for(unsigned int i = 0; i != 100; ++i) {
+      block = scheduler.nextBlock(5, 1, 1.);
+      CPPUNIT_ASSERT(block.startIndex == end);
+      CPPUNIT_ASSERT(block.nIndices >= 1 || end == 100);
+      end += block.nIndices;
+      CPPUNIT_ASSERT(end <= 100);
+   }
+   CPPUNIT_ASSERT(0 == scheduler.nextBlock(6, 1, 1.).nIndices);
+   CPPUNIT_ASSERT(scheduler.nextIndex() == 100);
+
+   //never larger than the maximum
+   EventBlockScheduler limited(2, 10, 100, true);
+   CPPUNIT_ASSERT(limited.nextBlock(5, 0, 0.).nIndices == 10);
+}
+
+void testEventBlockScheduler::unknownNumberOfEventsTest()
+{
+   EventBlockScheduler scheduler(2, 100, -1, true);
+   CPPUNIT_ASSERT(scheduler.nextBlock(5, 0, 0.).nIndices == 100);
+   CPPUNIT_ASSERT(scheduler.nextBlock(6, 0, 0.).nIndices == 100);
+   //the slower child gets the smaller block
+   CPPUNIT_ASSERT(scheduler.nextBlock(5, 100, 3.).nIndices == 100);
+   CPPUNIT_ASSERT(scheduler.nextBlock(6, 100, 1.).nIndices == 100);
+   MessageForSource block = scheduler.nextBlock(5, 100, 3.);
+   CPPUNIT_ASSERT(block.startIndex == 400 && block.nIndices == 50);
+}
+
+void testEventBlockScheduler::makespanTest()
+{
+   std::vector<double> const childSpeeds = speeds();
+   double const ideal = idealMakespan(childSpeeds);
+
+   EventBlockScheduler fixed(childSpeeds.size(), 500, kNEvents, false);
+   double const fixedMakespan = simulate(fixed, childSpeeds);
+
+   EventBlockScheduler adaptive(childSpeeds.size(), 500, kNEvents, true);
+   double const adaptiveMakespan = simulate(adaptive, childSpeeds);
+
+   EventBlockScheduler adaptiveUnknown(childSpeeds.size(), 500, -1, true);
+   double const adaptiveUnknownMakespan = simulate(adaptiveUnknown, childSpeeds);
+
+   CPPUNIT_ASSERT(adaptiveMakespan < 1.02 * ideal);
+   CPPUNIT_ASSERT(adaptiveMakespan < fixedMakespan);
+   CPPUNIT_ASSERT(adaptiveUnknownMakespan < fixedMakespan);
+}
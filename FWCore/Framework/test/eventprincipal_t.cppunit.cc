@@ -20,6 +20,7 @@ Test of the EventPrincipal class.
 #include "DataFormats/Provenance/interface/ProductProvenance.h"
 #include "DataFormats/Provenance/interface/RunAuxiliary.h"
 #include "DataFormats/TestObjects/interface/ToyProducts.h"
+#include "FWCore/Framework/interface/DelayedReader.h"
 #include "FWCore/Framework/interface/EventPrincipal.h"
 #include "FWCore/Framework/interface/LuminosityBlockPrincipal.h"
 #include "FWCore/Framework/interface/RunPrincipal.h"
@@ -36,12 +37,57 @@ Test of the EventPrincipal class.
 
 #include "boost/shared_ptr.hpp"
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <future>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
 #include <typeinfo>
 
+namespace {
+  // Reads a DummyProduct once it is told to, so a test can act while a read is going on
+  class WaitingReader : public edm::DelayedReader {
+  public:
+    WaitingReader() : started_(false), release_(false), nReads_(0) {}
+
+    void waitUntilStarted() {
+      std::unique_lock<std::mutex> lock(mutex_);
+      changed_.wait(lock, [this]() {return started_;});
+    }
+
+    void release() {
+      std::lock_guard<std::mutex> guard(mutex_);
+      release_ = true;
+      changed_.notify_all();
+    }
+
+    unsigned int nReads() const {return nReads_;}
+
+  private:
+    virtual edm::WrapperOwningHolder getProduct_(edm::BranchKey const&, edm::WrapperInterfaceBase const*, edm::EDProductGetter const*) const {
+      ++nReads_;
+      std::unique_lock<std::mutex> lock(mutex_);
+      started_ = true;
+      changed_.notify_all();
+      changed_.wait(lock, [this]() {return release_;});
+      typedef edm::Wrapper<edmtest::DummyProduct> WDP;
+      return edm::WrapperOwningHolder(new WDP(std::auto_ptr<edmtest::DummyProduct>(new edmtest::DummyProduct)), WDP::getInterface());
+    }
+    virtual void mergeReaders_(edm::DelayedReader*) {}
+    virtual void reset_() {}
+
+    mutable std::mutex mutex_;
+    mutable std::condition_variable changed_;
+    mutable bool started_;
+    bool release_;
+    mutable std::atomic<unsigned int> nReads_;
+  };
+}
+
 class test_ep: public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(test_ep);
   CPPUNIT_TEST(failgetbyIdTest);
@@ -49,6 +95,7 @@ class test_ep: public CppUnit::TestFixture {
   CPPUNIT_TEST(failgetManybyTypeTest);
   CPPUNIT_TEST(failgetbyInvalidIdTest);
   CPPUNIT_TEST(failgetProvenanceTest);
+  CPPUNIT_TEST(getAndPutWhileReadingTest);
   CPPUNIT_TEST_SUITE_END();
 public:
   void setUp();
@@ -58,6 +105,7 @@ public:
   void failgetManybyTypeTest();
   void failgetbyInvalidIdTest();
   void failgetProvenanceTest();
+  void getAndPutWhileReadingTest();
 
 private:
 
@@ -70,7 +118,8 @@ private:
   boost::shared_ptr<edm::BranchDescription>
   fake_single_process_branch(std::string const& tag,
                              std::string const& processName,
-                             std::string const& productInstanceName = std::string());
+                             std::string const& productInstanceName = std::string(),
+                             bool produced = true);
 
   std::map<std::string, boost::shared_ptr<edm::BranchDescription> >    branchDescriptions_;
   std::map<std::string, boost::shared_ptr<edm::ProcessConfiguration> > processConfigurations_;
@@ -109,7 +158,8 @@ test_ep::fake_single_module_process(std::string const& tag,
 boost::shared_ptr<edm::BranchDescription>
 test_ep::fake_single_process_branch(std::string const& tag,
                                     std::string const& processName,
-                                    std::string const& productInstanceName) {
+                                    std::string const& productInstanceName,
+                                    bool produced) {
   std::string moduleLabel = processName + "dummyMod";
   std::string moduleClass("DummyModule");
   edm::TypeWithDict dummyType(typeid(edmtest::DummyProduct));
@@ -130,7 +180,8 @@ test_ep::fake_single_process_branch(std::string const& tag,
                                productInstanceName,
                                moduleClass,
                                modParams.id(),
-                               dummyType));
+                               dummyType,
+                               produced));
   branchDescriptions_[tag] = result;
   return result;
 }
@@ -257,3 +308,58 @@ void test_ep::failgetProvenanceTest() {
   edm::BranchID id;
   CPPUNIT_ASSERT_THROW(pEvent_->getProvenance(id), edm::Exception);
 }
+
+void test_ep::getAndPutWhileReadingTest() {
+  typedef edmtest::DummyProduct PRODUCT_TYPE;
+  typedef edm::Wrapper<PRODUCT_TYPE> WDP;
+
+  // One product comes from the input, the other one is put by a module
+  boost::shared_ptr<edm::ProductRegistry> preg(new edm::ProductRegistry);
+  preg->copyProduct(*fake_single_process_branch("input", "INPUT", std::string(), false));
+  preg->addProduct(*fake_single_process_branch("produced", "PRODUCED"));
+  preg->setFrozen();
+  boost::shared_ptr<edm::BranchIDListHelper> branchIDListHelper(new edm::BranchIDListHelper());
+  branchIDListHelper->updateRegistries(*preg);
+
+  edm::ProductRegistry::ProductList const& pl = preg->productList();
+  edm::ConstBranchDescription const inputBranch(pl.find(edm::BranchKey(*branchDescriptions_["input"]))->second);
+  edm::ConstBranchDescription const producedBranch(pl.find(edm::BranchKey(*branchDescriptions_["produced"]))->second);
+
+  WaitingReader reader;
+  edm::EventPrincipal ep(preg, branchIDListHelper, *processConfigurations_["produced"]);
+  edm::EventAuxiliary eventAux(eventID_, edm::createGlobalIdentifier(), edm::Timestamp(1234567UL), true);
+  ep.fillEventPrincipal(eventAux,
+                        boost::shared_ptr<edm::EventSelectionIDVector>(),
+                        boost::shared_ptr<edm::BranchListIndexes>(),
+                        boost::shared_ptr<edm::BranchMapper>(new edm::BranchMapper),
+                        &reader);
+
+  // as the prefetching of products does
+  auto firstRead = std::async(std::launch::async, [&]() {
+    return ep.getProductHolder(inputBranch.branchID(), true, false)->product();
+  });
+  reader.waitUntilStarted();
+
+  // as a module does while the product is being read
+  auto putAndGet = std::async(std::launch::async, [&]() {
+    edm::WrapperOwningHolder product(new WDP(std::auto_ptr<PRODUCT_TYPE>(new PRODUCT_TYPE)), WDP::getInterface());
+    boost::shared_ptr<edm::Parentage> parentage(new edm::Parentage);
+    edm::ProductProvenance prov(producedBranch.branchID(), parentage);
+    ep.put(producedBranch, product, prov);
+    return ep.getProductHolder(producedBranch.branchID(), true, false)->product();
+  });
+  CPPUNIT_ASSERT(std::future_status::ready == putAndGet.wait_for(std::chrono::seconds(10)));
+  CPPUNIT_ASSERT(putAndGet.get());
+
+  // a second request for the product being read waits for the first read
+  auto secondRead = std::async(std::launch::async, [&]() {
+    return ep.getProductHolder(inputBranch.branchID(), true, false)->product();
+  });
+  CPPUNIT_ASSERT(std::future_status::timeout == secondRead.wait_for(std::chrono::milliseconds(100)));
+
+  reader.release();
+  boost::shared_ptr<void const> first = firstRead.get();
+  CPPUNIT_ASSERT(first);
+  CPPUNIT_ASSERT(first == secondRead.get());
+  CPPUNIT_ASSERT(1U == reader.nReads());
+}
@@ -53,6 +53,7 @@ CPPUNIT_TEST_SUITE(testEventsetupRecord);
 CPPUNIT_TEST(factoryTest);
 CPPUNIT_TEST(proxyTest);
 CPPUNIT_TEST(getTest);
+CPPUNIT_TEST(getByTokenTest);
 CPPUNIT_TEST(doGetTest);
 CPPUNIT_TEST(proxyResetTest);
 CPPUNIT_TEST(introspectionTest);
@@ -70,6 +71,7 @@ public:
   void factoryTest();
   void proxyTest();
   void getTest();
+  void getByTokenTest();
   void doGetTest();
   void proxyResetTest();
   void introspectionTest();
@@ -252,6 +254,48 @@ void testEventsetupRecord::getTest()
    
 }
 
+void testEventsetupRecord::getByTokenTest()
+{
+   DummyRecord dummyRecord;
+   ESGetTokenT<Dummy> workingToken("working");
+   ESHandle<Dummy> dummyPtr;
+   CPPUNIT_ASSERT_THROW(dummyRecord.get(workingToken, dummyPtr), NoDataExceptionType);
+
+   Dummy myDummy;
+   WorkingDummyProxy workingProxy(&myDummy);
+   const DataKey workingDataKey(DataKey::makeTypeTag<WorkingDummyProxy::value_type>(),
+                                "working");
+   dummyRecord.add(workingDataKey,
+                   &workingProxy);
+
+   //the token must not keep the Proxy it did not find before the Proxy was added
+   dummyRecord.get(workingToken, dummyPtr);
+   CPPUNIT_ASSERT(&(*dummyPtr) == &myDummy);
+   dummyRecord.get(workingToken, dummyPtr);
+   CPPUNIT_ASSERT(&(*dummyPtr) == &myDummy);
+
+   //a Looper replacing the Proxy
+   Dummy otherDummy;
+   WorkingDummyProxy otherProxy(&otherDummy);
+   ComponentDescription cd;
+   cd.isLooper_ = true;
+   otherProxy.setProviderDescription(&cd);
+   dummyRecord.add(workingDataKey,
+                   &otherProxy);
+   dummyRecord.get(workingToken, dummyPtr);
+   CPPUNIT_ASSERT(&(*dummyPtr) == &otherDummy);
+
+   //the token is looked up again in a different Record
+   DummyRecord otherRecord;
+   otherRecord.add(workingDataKey,
+                   &workingProxy);
+   otherRecord.get(workingToken, dummyPtr);
+   CPPUNIT_ASSERT(&(*dummyPtr) == &myDummy);
+
+   dummyRecord.clearProxies();
+   CPPUNIT_ASSERT_THROW(dummyRecord.get(workingToken, dummyPtr), NoDataExceptionType);
+}
+
 void testEventsetupRecord::getNodataExpTest()
 {
    DummyRecord dummyRecord;
@@ -11,6 +11,7 @@
 //
 
 // system include files
+#include <algorithm>
 
 // user include files
 #include "FWCore/Framework/src/IntersectingIOVRecordIntervalFinder.h"
@@ -26,6 +27,7 @@ class testintersectingiovrecordintervalfinder: public CppUnit::TestFixture
    
    CPPUNIT_TEST(constructorTest);
    CPPUNIT_TEST(intersectionTest);
+   CPPUNIT_TEST(fixedIntervalsTest);
    
    CPPUNIT_TEST_SUITE_END();
 public:
@@ -35,6 +37,7 @@ public:
    
    void constructorTest();
    void intersectionTest();
+   void fixedIntervalsTest();
    
 }; //Cppunit class declaration over
 
@@ -69,6 +72,30 @@ namespace  {
    private:
       edm::ValidityInterval interval_;   
    };   
+
+   //each run is an interval of the given number of lumis starting at iOffset
+   class FixedFinder : public edm::EventSetupRecordIntervalFinder {
+   public:
+      FixedFinder(unsigned int iLumisPerInterval, unsigned int iOffset) :edm::EventSetupRecordIntervalFinder(),
+      calls_(0), lumisPerInterval_(iLumisPerInterval), offset_(iOffset) {
+         this->findingRecord<DummyRecord>();
+         this->setHasFixedIntervals();
+      }
+      unsigned int calls_;
+   protected:
+      virtual void setIntervalFor(const edm::eventsetup::EventSetupRecordKey&,
+                                  const edm::IOVSyncValue& iTime, 
+                                  edm::ValidityInterval& iInterval) {
+         ++calls_;
+         unsigned int first = iTime.luminosityBlockNumber() - (iTime.luminosityBlockNumber() - offset_) % lumisPerInterval_;
+         edm::RunNumber_t run = iTime.eventID().run();
+         iInterval = edm::ValidityInterval(edm::IOVSyncValue(edm::EventID(run, first, 1)),
+                                           edm::IOVSyncValue(edm::EventID(run, first + lumisPerInterval_ - 1, edm::EventID::maxEventNumber())));
+      }
+   private:
+      unsigned int lumisPerInterval_;
+      unsigned int offset_;
+   };
 }
 
 void 
@@ -221,3 +248,38 @@ testintersectingiovrecordintervalfinder::intersectionTest()
    }
    
 }
+
+
+void 
+testintersectingiovrecordintervalfinder::fixedIntervalsTest()
+{
+   const EventSetupRecordKey dummyRecordKey = DummyRecord::keyForClass();
+
+   std::vector<boost::shared_ptr<edm::EventSetupRecordIntervalFinder> > finders;
+   boost::shared_ptr<FixedFinder> twoLumis(new FixedFinder(2, 1));
+   boost::shared_ptr<FixedFinder> threeLumis(new FixedFinder(3, 1));
+   finders.push_back(twoLumis);
+   finders.push_back(threeLumis);
+   IntersectingIOVRecordIntervalFinder intFinder(dummyRecordKey);
+   intFinder.swapFinders(finders);
+   CPPUNIT_ASSERT(intFinder.hasFixedIntervals());
+
+   //going through lumis 1 to 6 twice only finds each interval once
+   for(unsigned int pass = 0; pass != 2; ++pass) {
+      for(unsigned int lumi = 1; lumi != 7; ++lumi) {
+         edm::ValidityInterval found = intFinder.findIntervalFor(dummyRecordKey, edm::IOVSyncValue(edm::EventID(1, lumi, 1)));
+         unsigned int first = std::max(lumi - (lumi - 1) % 2, lumi - (lumi - 1) % 3);
+         unsigned int last = std::min(lumi - (lumi - 1) % 2 + 1, lumi - (lumi - 1) % 3 + 2);
+         CPPUNIT_ASSERT(edm::ValidityInterval(edm::IOVSyncValue(edm::EventID(1, first, 1)),
+                                              edm::IOVSyncValue(edm::EventID(1, last, edm::EventID::maxEventNumber()))) == found);
+      }
+      CPPUNIT_ASSERT(3 == twoLumis->calls_);
+      CPPUNIT_ASSERT(2 == threeLumis->calls_);
+   }
+
+   boost::shared_ptr<DummyFinder> dummyFinder(new DummyFinder);
+   finders.push_back(dummyFinder);
+   IntersectingIOVRecordIntervalFinder notFixed(dummyRecordKey);
+   notFixed.swapFinders(finders);
+   CPPUNIT_ASSERT(!notFixed.hasFixedIntervals());
+}
@@ -6,9 +6,15 @@ function die { echo $1: status $2 ;  exit $2; }
 F1=${LOCAL_TEST_DIR}/test_tbb_threads_cfg.py
 F2="-n 8 ${LOCAL_TEST_DIR}/test_tbb_threads_from_commandline_cfg.py"
 F3="--numThreads 8 ${LOCAL_TEST_DIR}/test_tbb_threads_from_commandline_cfg.py"
+F4="-n 4 ${LOCAL_TEST_DIR}/test_event_streams_cfg.py"
+F5="-n 2 ${LOCAL_TEST_DIR}/test_event_read_ahead_cfg.py"
+F6="-n 2 ${LOCAL_TEST_DIR}/test_concurrent_subprocesses_cfg.py"
 
 (cmsRun $F1 ) || die "Failure using cmsRun $F1" $?
 (cmsRun $F2 ) || die "Failure using cmsRun $F2" $?
 (cmsRun $F3 ) || die "Failure using cmsRun $F3" $?
+(cmsRun $F4 ) || die "Failure using cmsRun $F4" $?
+(cmsRun $F5 ) || die "Failure using cmsRun $F5" $?
+(cmsRun $F6 ) || die "Failure using cmsRun $F6" $?
 
 
@@ -9,6 +9,9 @@ F3=${LOCAL_TEST_DIR}/testBitsMove_cfg.py
 F4=${LOCAL_TEST_DIR}/testBitsCount_cfg.py
 F5=${LOCAL_TEST_DIR}/testFilterIgnore_cfg.py
 F6=${LOCAL_TEST_DIR}/testFilterOnEndPath_cfg.py
+F7=${LOCAL_TEST_DIR}/testBitsConcurrent_cfg.py
+F8=${LOCAL_TEST_DIR}/testBitsException_cfg.py
+F9=${LOCAL_TEST_DIR}/testBitsConcurrentException_cfg.py
 
 (cmsRun $F1 ) || die "Failure using $F1" $?
 (cmsRun $F2 ) || die "Failure using $F2" $?
@@ -16,5 +19,11 @@ F6=${LOCAL_TEST_DIR}/testFilterOnEndPath_cfg.py
 (cmsRun $F4 ) || die "Failure using $F4" $?
 (cmsRun $F5 ) || die "Failure using $F5" $?
 (cmsRun $F6 ) || die "Failure using $F6" $?
+(cmsRun -n 4 $F7 ) || die "Failure using $F7" $?
+(cmsRun $F8 > testBitsException.log 2>&1 ) || die "Failure using $F8" $?
+(cmsRun -n 4 $F9 > testBitsConcurrentException.log 2>&1 ) || die "Failure using $F9" $?
+grep '^TrigReport' testBitsException.log > testBitsException.txt
+grep '^TrigReport' testBitsConcurrentException.log > testBitsConcurrentException.txt
+diff testBitsException.txt testBitsConcurrentException.txt || die "TrigReport differs when the trigger paths are run concurrently" $?
 
 
@@ -11,6 +11,7 @@ F5=${LOCAL_TEST_DIR}/test_onPath_allowUnscheduled_false_cfg.py
 F6=${LOCAL_TEST_DIR}/test_onPath_allowUnscheduled_true_cfg.py
 F7=${LOCAL_TEST_DIR}/test_onPath_wrongOrder_allowUnscheduled_false_fail_cfg.py
 F8=${LOCAL_TEST_DIR}/test_onPath_wrongOrder_allowUnscheduled_true_fail_cfg.py
+F9=${LOCAL_TEST_DIR}/test_deepCall_allowUnscheduled_true_mightGet_cfg.py
 
 (cmsRun $F1 ) || die "Failure using $F1" $?
 !(cmsRun $F2 ) || die "Failure using $F2" $?
@@ -20,5 +21,8 @@ F8=${LOCAL_TEST_DIR}/test_onPath_wrongOrder_allowUnscheduled_true_fail_cfg.py
 (cmsRun $F6 ) || die "Failure using $F6" $?
 !(cmsRun $F7 ) || die "Failure using $F7" $?
 !(cmsRun $F8 ) || die "Failure using $F8" $?
+(cmsRun $F9 ) > mightGet.log 2>&1 || die "Failure using $F9" $?
+# Visited Run Passed Failed Error Name
+grep -E -q '^TrigReport +[0-9]+ +0 +0 +0 +0 unused$' mightGet.log || die "'unused' was run by $F9" 1
 
 
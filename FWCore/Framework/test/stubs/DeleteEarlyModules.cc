@@ -16,6 +16,8 @@
 #include <memory>
 
 // user include files
+#include "DataFormats/Common/interface/Handle.h"
+#include "DataFormats/Common/interface/RefVector.h"
 #include "DataFormats/TestObjects/interface/DeleteEarly.h"
 #include "FWCore/Framework/interface/EDProducer.h"
 #include "FWCore/Framework/interface/EDAnalyzer.h"
@@ -49,6 +51,28 @@ namespace edmtest {
     virtual void analyze(edm::Event const& e, edm::EventSetup const& ) {
       edm::Handle<DeleteEarly> h;
       e.getByLabel(m_tag,h);
+      //throws if the product is missing
+      h.product();
+    }
+  private:
+    edm::InputTag m_tag;
+  };
+  
+  class DeleteEarlyRefReader: public edm::EDAnalyzer {
+  public:
+    DeleteEarlyRefReader(edm::ParameterSet const& pset):
+    m_tag(pset.getUntrackedParameter<edm::InputTag>("tag"))
+    {}
+    
+    virtual void analyze(edm::Event const& e, edm::EventSetup const& ) {
+      edm::Handle<edm::RefVector<std::vector<int> > > h;
+      e.getByLabel(m_tag,h);
+      //throws if the product the Refs point to was deleted
+      for(auto const& ref : *h) {
+        if(*ref == 0) {
+          throw cms::Exception("DeleteEarlyError")<<"Ref to "<<ref.id()<<" points to an unexpected value";
+        }
+      }
     }
   private:
     edm::InputTag m_tag;
@@ -76,5 +100,6 @@ namespace edmtest {
 using namespace edmtest;
 DEFINE_FWK_MODULE(DeleteEarlyProducer);
 DEFINE_FWK_MODULE(DeleteEarlyReader);
+DEFINE_FWK_MODULE(DeleteEarlyRefReader);
 DEFINE_FWK_MODULE(DeleteEarlyCheckDeleteAnalyzer);
 
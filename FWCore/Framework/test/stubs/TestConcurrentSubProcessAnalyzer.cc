@@ -0,0 +1,119 @@
+// -*- C++ -*-
+//
+// Package:    Framework
+// Class:      TestConcurrentSubProcessAnalyzer
+//
+/**\class TestConcurrentSubProcessAnalyzer TestConcurrentSubProcessAnalyzer.cc FWCore/Framework/test/stubs/TestConcurrentSubProcessAnalyzer.cc
+
+ Description: Checks that SubProcesses run concurrently and do not share a BranchMapper
+
+ Implementation:
+     Every instance, whichever SubProcess it is in, registers the BranchMapper of the
+     product it reads while it runs. Two instances running at the same time must see
+     different BranchMappers.
+*/
+//
+// $Id$
+//
+//
+
+
+// system include files
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unistd.h>
+
+// user include files
+#include "DataFormats/Provenance/interface/BranchMapper.h"
+#include "DataFormats/Provenance/interface/Provenance.h"
+#include "DataFormats/TestObjects/interface/ToyProducts.h"
+#include "FWCore/Framework/interface/EDAnalyzer.h"
+#include "FWCore/Framework/interface/Event.h"
+
+#include "FWCore/Framework/interface/MakerMacros.h"
+
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+
+#include "FWCore/Utilities/interface/Exception.h"
+
+//
+// class decleration
+//
+
+class TestConcurrentSubProcessAnalyzer : public edm::EDAnalyzer {
+   public:
+      explicit TestConcurrentSubProcessAnalyzer(const edm::ParameterSet&);
+      ~TestConcurrentSubProcessAnalyzer();
+
+
+      virtual void analyze(const edm::Event&, const edm::EventSetup&);
+   private:
+         virtual void endJob();
+         std::string m_moduleLabel;
+         unsigned int m_expectedNumberOfSimultaneous;
+         unsigned int m_usecondsToSleep;
+      // ----------member data ---------------------------
+};
+
+namespace {
+   //shared by the instances in all the SubProcesses
+   std::mutex s_mutex;
+   std::multiset<edm::BranchMapper const*> s_runningMappers;
+   unsigned int s_maxRunning = 0;
+}
+
+//
+// constructors and destructor
+//
+TestConcurrentSubProcessAnalyzer::TestConcurrentSubProcessAnalyzer(const edm::ParameterSet& iConfig) :
+m_moduleLabel(iConfig.getUntrackedParameter<std::string>("moduleLabel")),
+m_expectedNumberOfSimultaneous(iConfig.getUntrackedParameter<unsigned int>("nExpectedSimultaneous")),
+m_usecondsToSleep(iConfig.getUntrackedParameter<unsigned int>("usecondsToSleep",20000) )
+{
+}
+
+
+TestConcurrentSubProcessAnalyzer::~TestConcurrentSubProcessAnalyzer()
+{
+}
+
+
+//
+// member functions
+//
+
+// ------------ method called to produce the data  ------------
+void
+TestConcurrentSubProcessAnalyzer::analyze(const edm::Event& iEvent, const edm::EventSetup&)
+{
+   edm::Handle<edmtest::IntProduct> handle;
+   iEvent.getByLabel(m_moduleLabel,handle);
+   edm::BranchMapper const* mapper = handle.provenance()->store().get();
+   {
+      std::lock_guard<std::mutex> guard(s_mutex);
+      if(s_runningMappers.count(mapper) != 0) {
+         throw cms::Exception("SharedBranchMapper")<<"two SubProcesses running at the same time use the same BranchMapper\n";
+      }
+      s_runningMappers.insert(mapper);
+      if(s_runningMappers.size() > s_maxRunning) {
+         s_maxRunning = s_runningMappers.size();
+      }
+   }
+   usleep(m_usecondsToSleep);
+   std::lock_guard<std::mutex> guard(s_mutex);
+   s_runningMappers.erase(s_runningMappers.find(mapper));
+}
+
+void
+TestConcurrentSubProcessAnalyzer::endJob()
+{
+  std::lock_guard<std::mutex> guard(s_mutex);
+  if (s_maxRunning != m_expectedNumberOfSimultaneous) {
+    throw cms::Exception("WrongNumberOfSimultaneous")<<"expected "<<m_expectedNumberOfSimultaneous<<" SubProcesses running at the same time but instead saw "<<s_maxRunning
+					       <<"\n";
+  }
+}
+//define this as a plug-in
+DEFINE_FWK_MODULE(TestConcurrentSubProcessAnalyzer);
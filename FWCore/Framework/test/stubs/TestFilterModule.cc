@@ -55,6 +55,7 @@ namespace edmtest
     int count_;
     int accept_rate_; // how many out of 100 will be accepted?
     bool onlyOne_;
+    bool useEventNumber_; // decide on the event number instead of the number of calls
   };
 
   // -------
@@ -141,7 +142,8 @@ namespace edmtest
   TestFilterModule::TestFilterModule(edm::ParameterSet const& ps):
     count_(),
     accept_rate_(ps.getUntrackedParameter<int>("acceptValue",1)),
-    onlyOne_(ps.getUntrackedParameter<bool>("onlyOne",false))
+    onlyOne_(ps.getUntrackedParameter<bool>("onlyOne",false)),
+    useEventNumber_(ps.getUntrackedParameter<bool>("useEventNumber",false))
   {
   }
     
@@ -149,9 +151,10 @@ namespace edmtest
   {
   }
 
-  bool TestFilterModule::filter(edm::Event&, edm::EventSetup const&)
+  bool TestFilterModule::filter(edm::Event& e, edm::EventSetup const&)
   {
     ++count_;
+    if(useEventNumber_) count_ = e.id().event();
     assert( currentContext() != 0 );
     if(onlyOne_)
       return count_ % accept_rate_ ==0;
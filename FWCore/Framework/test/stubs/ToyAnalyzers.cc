@@ -67,6 +67,47 @@ namespace edmtest {
     edm::InputTag moduleLabel_;
   };
 
+  //--------------------------------------------------------------------
+  //
+  // Gets the same product with getByToken and getByLabel, which must agree
+  class ConsumingIntAnalyzer : public edm::EDAnalyzer {
+  public:
+    ConsumingIntAnalyzer(edm::ParameterSet const& iPSet) :
+      value_(iPSet.getUntrackedParameter<int>("valueMustMatch")),
+      moduleLabel_(iPSet.getUntrackedParameter<std::string>("moduleLabel"), ""),
+      missingLabel_(iPSet.getUntrackedParameter<std::string>("missingLabel"), ""),
+      token_(consumes<IntProduct>(moduleLabel_)),
+      missingToken_(consumes<IntProduct>(missingLabel_)) {
+    }
+
+    void analyze(edm::Event const& iEvent, edm::EventSetup const&) {
+      edm::Handle<IntProduct> handle;
+      iEvent.getByToken(token_, handle);
+      if(handle->value != value_) {
+        throw cms::Exception("ValueMissMatch")
+          << "The value for \"" << moduleLabel_ << "\" is "
+          << handle->value << " but it was supposed to be " << value_;
+      }
+      edm::Handle<IntProduct> labelHandle;
+      iEvent.getByLabel(moduleLabel_, labelHandle);
+      if(handle.id() != labelHandle.id()) {
+        throw cms::Exception("ProductMissMatch")
+          << "getByToken and getByLabel found different products for \"" << moduleLabel_ << "\"";
+      }
+      edm::Handle<IntProduct> missing;
+      if(iEvent.getByToken(missingToken_, missing) || missing.isValid()) {
+        throw cms::Exception("UnexpectedProduct")
+          << "getByToken found a product for \"" << missingLabel_ << "\"";
+      }
+    }
+  private:
+    int value_;
+    edm::InputTag moduleLabel_;
+    edm::InputTag missingLabel_;
+    edm::EDGetTokenT<IntProduct> token_;
+    edm::EDGetTokenT<IntProduct> missingToken_;
+  };
+
   //--------------------------------------------------------------------
   //
   class SCSimpleAnalyzer : public edm::EDAnalyzer {
@@ -172,10 +213,12 @@ namespace edmtest {
 
 using edmtest::NonAnalyzer;
 using edmtest::IntTestAnalyzer;
+using edmtest::ConsumingIntAnalyzer;
 using edmtest::SCSimpleAnalyzer;
 using edmtest::DSVAnalyzer;
 DEFINE_FWK_MODULE(NonAnalyzer);
 DEFINE_FWK_MODULE(IntTestAnalyzer);
+DEFINE_FWK_MODULE(ConsumingIntAnalyzer);
 DEFINE_FWK_MODULE(SCSimpleAnalyzer);
 DEFINE_FWK_MODULE(DSVAnalyzer);
 
@@ -0,0 +1,9 @@
+
+# Same as testBitsException_cfg.py but with the trigger paths run concurrently.
+# The TrigReport must be the same as when run serially.
+
+import FWCore.ParameterSet.Config as cms
+
+from FWCore.Framework.test.testBitsException_cfg import process
+
+process.options.concurrentTriggerPaths = cms.untracked.bool(True)
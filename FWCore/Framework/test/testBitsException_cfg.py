@@ -0,0 +1,60 @@
+
+# A trigger path throws for the second event and the event is skipped.
+# The filters decide on the event number so they make the same decisions
+# whichever paths were run for the skipped event.
+# testBitsConcurrentException_cfg.py runs the same with the trigger paths
+# run concurrently and run_trigbit.sh checks both give the same TrigReport.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("PROD")
+
+process.options = cms.untracked.PSet(
+    wantSummary = cms.untracked.bool(True),
+    SkipEvent = cms.untracked.vstring('EventCorruption')
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.source = cms.Source("EmptySource")
+
+process.f1 = cms.EDFilter("TestFilterModule",
+    acceptValue = cms.untracked.int32(2),
+    onlyOne = cms.untracked.bool(True),
+    useEventNumber = cms.untracked.bool(True)
+)
+
+process.f2 = cms.EDFilter("TestFilterModule",
+    acceptValue = cms.untracked.int32(3),
+    onlyOne = cms.untracked.bool(True),
+    useEventNumber = cms.untracked.bool(True)
+)
+
+process.f3 = cms.EDFilter("TestFilterModule",
+    acceptValue = cms.untracked.int32(5),
+    onlyOne = cms.untracked.bool(True),
+    useEventNumber = cms.untracked.bool(True)
+)
+
+process.testThrow = cms.EDAnalyzer("TestFailuresAnalyzer",
+    whichFailure = cms.int32(5),
+    eventToThrow = cms.untracked.uint32(2),
+    mightGet = cms.untracked.vstring()
+)
+
+process.a1 = cms.EDAnalyzer("TestResultAnalyzer",
+    name = cms.untracked.string('a1'),
+    dump = cms.untracked.bool(True),
+    numbits = cms.untracked.int32(5)
+)
+
+# p1 and p4 share f1 so they are in the same group, p2 throws, and the
+# paths after p2 must not be counted for the skipped event
+process.p1 = cms.Path(process.f1)
+process.p2 = cms.Path(process.testThrow*process.f3)
+process.p3 = cms.Path(process.f2)
+process.p4 = cms.Path(process.f1*process.f3)
+process.p5 = cms.Path(~process.f2)
+process.e1 = cms.EndPath(process.a1)
@@ -0,0 +1,39 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.source = cms.Source("EmptySource")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(3))
+
+process.options = cms.untracked.PSet(
+        deleteEarlyAutomatically = cms.untracked.bool(True))
+
+
+process.maker = cms.EDProducer("DeleteEarlyProducer",
+                               mightGet = cms.untracked.vstring())
+
+process.reader = cms.EDAnalyzer("DeleteEarlyReader",
+                                tag = cms.untracked.InputTag("maker"),
+                                mightGet = cms.untracked.vstring("edmtestDeleteEarly_maker__TEST"))
+
+# 'refReader' reads 'intvec' only through the Refs made by 'refs' so
+# 'intvec' must not be deleted once 'refs' has run
+process.intvec = cms.EDProducer("IntVectorProducer",
+                                ivalue = cms.int32(11),
+                                count = cms.int32(3),
+                                mightGet = cms.untracked.vstring())
+
+process.refs = cms.EDProducer("IntVecRefVectorProducer",
+                              target = cms.string("intvec"),
+                              mightGet = cms.untracked.vstring("ints_intvec__TEST"))
+
+process.refReader = cms.EDAnalyzer("DeleteEarlyRefReader",
+                                   tag = cms.untracked.InputTag("refs"),
+                                   mightGet = cms.untracked.vstring("intsRefs_refs__TEST"))
+
+process.tester = cms.EDAnalyzer("DeleteEarlyCheckDeleteAnalyzer",
+                                expectedValues = cms.untracked.vuint32(2,4,6),
+                                mightGet = cms.untracked.vstring())
+
+process.p = cms.Path(process.maker+process.reader+process.intvec+process.refs+process.refReader+process.tester)
@@ -0,0 +1,35 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.source = cms.Source("EmptySource")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(20))
+
+process.options = cms.untracked.PSet(concurrentSubProcesses = cms.untracked.bool(True))
+
+process.one = cms.EDProducer("IntProducer", ivalue = cms.int32(1))
+process.two = cms.EDProducer("IntProducer", ivalue = cms.int32(2))
+
+process.p = cms.Path(process.one+process.two)
+
+# each SubProcess only keeps one of the parent's products and adds its own
+def makeSubProcess(name, keep, value):
+    child = cms.Process(name)
+    child.add = cms.EDProducer("AddIntsProducer", labels = cms.vstring(keep, keep))
+    child.check = cms.EDAnalyzer("IntTestAnalyzer",
+                                 moduleLabel = cms.untracked.string("add"),
+                                 valueMustMatch = cms.untracked.int32(2*value))
+    child.checkParent = cms.EDAnalyzer("IntTestAnalyzer",
+                                       moduleLabel = cms.untracked.string(keep),
+                                       valueMustMatch = cms.untracked.int32(value))
+    # fails unless both SubProcesses run at the same time, each with its own BranchMapper
+    child.overlap = cms.EDAnalyzer("TestConcurrentSubProcessAnalyzer",
+                                   moduleLabel = cms.untracked.string("add"),
+                                   nExpectedSimultaneous = cms.untracked.uint32(2))
+    child.p = cms.Path(child.add+child.check+child.checkParent+child.overlap)
+    return cms.SubProcess(child,
+                          outputCommands = cms.untracked.vstring("drop *", "keep *_"+keep+"_*_*"))
+
+process.subProcess = makeSubProcess("SUBONE", "one", 1)
+process.addSubProcess(makeSubProcess("SUBTWO", "two", 2))
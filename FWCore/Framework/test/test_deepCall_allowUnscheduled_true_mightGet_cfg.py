@@ -0,0 +1,54 @@
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+import FWCore.Framework.test.cmsExceptionsFatalOption_cff
+process.options = cms.untracked.PSet(
+    allowUnscheduled = cms.untracked.bool(True),
+    numberOfThreads = cms.untracked.uint32(2),
+    wantSummary = cms.untracked.bool(True),
+    Rethrow = FWCore.Framework.test.cmsExceptionsFatalOption_cff.Rethrow
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(3)
+)
+process.source = cms.Source("EmptySource",
+    timeBetweenEvents = cms.untracked.uint64(10),
+    firstTime = cms.untracked.uint64(1000000)
+)
+
+process.one = cms.EDProducer("IntProducer",
+    ivalue = cms.int32(1)
+)
+
+process.two = cms.EDProducer("IntProducer",
+    ivalue = cms.int32(2)
+)
+
+# nothing reads from this one so it is never run, run_unscheduled.sh
+# checks the module summary and running it would make the job fail
+process.unused = cms.EDProducer("FailingProducer")
+
+process.result3 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('one',
+        'two'),
+    mightGet = cms.untracked.vstring('edmtestIntProduct_one__TEST',
+        'edmtestIntProduct_two__TEST')
+)
+
+process.result5 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('result3',
+        'two'),
+    mightGet = cms.untracked.vstring('edmtestIntProduct_result3__TEST',
+        'edmtestIntProduct_two__TEST')
+)
+
+process.get = cms.EDAnalyzer("IntTestAnalyzer",
+    valueMustMatch = cms.untracked.int32(5),
+    moduleLabel = cms.untracked.string('result5'),
+    mightGet = cms.untracked.vstring('edmtestIntProduct_result5__TEST')
+)
+
+process.p = cms.Path(process.get)
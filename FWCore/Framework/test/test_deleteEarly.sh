@@ -9,6 +9,8 @@ F3=${LOCAL_TEST_DIR}/test_readAfterEarlyDelete_fail_cfg.py
 F4=${LOCAL_TEST_DIR}/test_multiPathEarlyDelete_cfg.py
 F5=${LOCAL_TEST_DIR}/test_multiPathMultiModuleEarlyDelete_cfg.py
 F6=${LOCAL_TEST_DIR}/test_subProcessDeleteEarly_cfg.py
+F7=${LOCAL_TEST_DIR}/test_automaticDeleteEarly_cfg.py
+F8=${LOCAL_TEST_DIR}/test_automaticDeleteEarlyRef_cfg.py
 
 (cmsRun $F1 ) || die "Failure using $F1" $?
 (cmsRun $F2 ) || die "Failure using $F2" $?
@@ -16,5 +18,7 @@ F6=${LOCAL_TEST_DIR}/test_subProcessDeleteEarly_cfg.py
 (cmsRun $F4 ) || die "Failure using $F4" $?
 (cmsRun $F5 ) || die "Failure using $F5" $?
 (cmsRun $F6 ) || die "Failure using $F6" $?
+(cmsRun $F7 ) || die "Failure using $F7" $?
+(cmsRun $F8 ) || die "Failure using $F8" $?
 
 
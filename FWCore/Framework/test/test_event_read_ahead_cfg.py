@@ -0,0 +1,45 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("READAHEAD")
+
+import FWCore.Framework.test.cmsExceptionsFatalOption_cff
+process.options = cms.untracked.PSet(
+    wantSummary = cms.untracked.bool(True),
+    eventReadAhead = cms.untracked.uint32(3),
+    Rethrow = FWCore.Framework.test.cmsExceptionsFatalOption_cff.Rethrow
+)
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(50))
+
+process.source = cms.Source("EmptySource",
+    numberEventsInLuminosityBlock = cms.untracked.uint32(10),
+    numberEventsInRun = cms.untracked.uint32(20)
+)
+
+process.m1 = cms.EDProducer("IntProducer",
+    ivalue = cms.int32(1)
+)
+
+process.m2 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('m1', 'm1')
+)
+
+process.checkOnPath = cms.EDAnalyzer("IntTestAnalyzer",
+    valueMustMatch = cms.untracked.int32(2),
+    moduleLabel = cms.untracked.string('m2')
+)
+
+# events read ahead must still be processed in the order they were read
+ids = cms.VEventID()
+numberOfEventsPerRun = process.source.numberEventsInRun.value()
+for i in xrange(process.maxEvents.input.value()):
+    ids.append(cms.EventID(1 + i/numberOfEventsPerRun, 1 + i%numberOfEventsPerRun))
+process.checkOrder = cms.EDAnalyzer("EventIDChecker", eventSequence = cms.untracked(ids))
+
+process.out = cms.OutputModule("SewerModule",
+    shouldPass = cms.int32(50),
+    name = cms.string('all_events')
+)
+
+process.p = cms.Path(process.m1*process.m2*process.checkOnPath)
+process.e = cms.EndPath(process.checkOrder*process.out)
@@ -0,0 +1,44 @@
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("STREAMS")
+
+import FWCore.Framework.test.cmsExceptionsFatalOption_cff
+process.options = cms.untracked.PSet(
+    wantSummary = cms.untracked.bool(True),
+    numberOfStreams = cms.untracked.uint32(3),
+    Rethrow = FWCore.Framework.test.cmsExceptionsFatalOption_cff.Rethrow
+)
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(50))
+
+process.source = cms.Source("EmptySource",
+    numberEventsInLuminosityBlock = cms.untracked.uint32(10),
+    numberEventsInRun = cms.untracked.uint32(20)
+)
+
+process.m1 = cms.EDProducer("IntProducer",
+    ivalue = cms.int32(1)
+)
+
+process.m2 = cms.EDProducer("AddIntsProducer",
+    labels = cms.vstring('m1', 'm1')
+)
+
+process.checkOnPath = cms.EDAnalyzer("IntTestAnalyzer",
+    valueMustMatch = cms.untracked.int32(2),
+    moduleLabel = cms.untracked.string('m2')
+)
+
+process.checkOnEndPath = cms.EDAnalyzer("IntTestAnalyzer",
+    valueMustMatch = cms.untracked.int32(2),
+    moduleLabel = cms.untracked.string('m2')
+)
+
+# the end path sees every event, whichever stream processed it
+process.out = cms.OutputModule("SewerModule",
+    shouldPass = cms.int32(50),
+    name = cms.string('all_events')
+)
+
+process.p = cms.Path(process.m1*process.m2*process.checkOnPath)
+process.e = cms.EndPath(process.checkOnEndPath*process.out)
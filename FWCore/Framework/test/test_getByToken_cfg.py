@@ -0,0 +1,28 @@
+import FWCore.ParameterSet.Config as cms
+process = cms.Process("Test")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(3)
+)
+process.source = cms.Source("EmptySource")
+
+process.one = cms.EDProducer("IntProducer", ivalue=cms.int32(1))
+
+#produced on demand the first time the token is used
+process.two = cms.EDProducer("IntProducer", ivalue=cms.int32(2))
+
+process.options = cms.untracked.PSet(allowUnscheduled = cms.untracked.bool(True))
+
+process.getOne = cms.EDAnalyzer("ConsumingIntAnalyzer",
+    valueMustMatch = cms.untracked.int32(1),
+    moduleLabel = cms.untracked.string('one'),
+    missingLabel = cms.untracked.string('three')
+)
+
+process.getTwo = cms.EDAnalyzer("ConsumingIntAnalyzer",
+    valueMustMatch = cms.untracked.int32(2),
+    moduleLabel = cms.untracked.string('two'),
+    missingLabel = cms.untracked.string('three')
+)
+
+process.p = cms.Path(process.one+process.getOne+process.getTwo)
@@ -110,5 +110,14 @@ namespace edmtest {
   private:
     int value_;
   };
+
+  // Plain old data, so forked children can share it
+  class ESTestDataShared {
+  public:
+    int & value() { return value_; }
+    int const& value() const { return value_; }
+  private:
+    int value_;
+  };
 }
 #endif
@@ -0,0 +1,13 @@
+# Reads back the file written by deleteEarlyOutput_cfg.py, every event
+# must contain the product.
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("READ")
+
+process.source = cms.Source("PoolSource",
+                            fileNames = cms.untracked.vstring("file:deleteEarlyOutput.root"))
+
+process.reader = cms.EDAnalyzer("DeleteEarlyReader",
+                                tag = cms.untracked.InputTag("maker"))
+
+process.p = cms.Path(process.reader)
@@ -0,0 +1,32 @@
+# A product which is kept by an OutputModule must not be deleted early,
+# even when every module declares what it reads.
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.source = cms.Source("EmptySource")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(3))
+
+process.options = cms.untracked.PSet(
+        deleteEarlyAutomatically = cms.untracked.bool(True))
+
+process.maker = cms.EDProducer("DeleteEarlyProducer",
+                               mightGet = cms.untracked.vstring())
+
+process.reader = cms.EDAnalyzer("DeleteEarlyReader",
+                                tag = cms.untracked.InputTag("maker"),
+                                mightGet = cms.untracked.vstring("edmtestDeleteEarly_maker__TEST"))
+
+# the same number of deletes as without early deletion
+process.tester = cms.EDAnalyzer("DeleteEarlyCheckDeleteAnalyzer",
+                                expectedValues = cms.untracked.vuint32(1,3,5),
+                                mightGet = cms.untracked.vstring())
+
+process.out = cms.OutputModule("PoolOutputModule",
+                               fileName = cms.untracked.string("deleteEarlyOutput.root"),
+                               outputCommands = cms.untracked.vstring("drop *",
+                                                                      "keep *_maker_*_*"))
+
+process.p = cms.Path(process.maker+process.reader+process.tester)
+process.e = cms.EndPath(process.out)
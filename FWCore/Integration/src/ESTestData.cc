@@ -36,3 +36,6 @@ TYPELOOKUP_DATA_REG(ESTestDataK);
 
 using edmtest::ESTestDataZ;
 TYPELOOKUP_DATA_REG(ESTestDataZ);
+
+using edmtest::ESTestDataShared;
+TYPELOOKUP_DATA_REG(ESTestDataShared);
@@ -7,6 +7,8 @@
 #include "FWCore/Integration/interface/ESTestRecords.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Framework/interface/MakerMacros.h"
+#include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/SharedMemoryArena.h"
 
 #include <algorithm>
 #include <vector>
@@ -108,9 +110,37 @@ namespace edmtest {
       edm::LogAbsolute("ESTestAnalyzerAZ") << "ESTestAnalyzerAZ: process = " << currentContext()->moduleDescription()->processName() << ": Data values = " << dataA->value() << "  " << dataZ->value();
     }
   }
+
+  class ESTestAnalyzerShared : public edm::EDAnalyzer {
+  public:
+    explicit ESTestAnalyzerShared(edm::ParameterSet const&);
+    virtual void analyze(const edm::Event&, const edm::EventSetup&);
+
+  private:
+    bool expectShared_;
+  };
+
+  ESTestAnalyzerShared::ESTestAnalyzerShared(edm::ParameterSet const& pset) :
+    expectShared_(pset.getUntrackedParameter<bool>("expectShared", true)) {
+  }
+
+  void ESTestAnalyzerShared::analyze(edm::Event const& ev, edm::EventSetup const& es) {
+    ESTestRecordA const& rec = es.get<ESTestRecordA>();
+    edm::ESHandle<ESTestDataShared> data;
+    rec.get(data);
+    if(data->value() != static_cast<int>(ev.run())) {
+      throw cms::Exception("WrongValue") << "ESTestDataShared has value " << data->value() << " in run " << ev.run() << "\n";
+    }
+    edm::SharedMemoryArena const* arena = edm::SharedMemoryArena::forkShared();
+    bool const shared = arena != 0 && arena->contains(data.product());
+    if(shared != expectShared_) {
+      throw cms::Exception("WrongSharing") << "ESTestDataShared is " << (shared ? "" : "not ") << "in the shared memory of the forked children\n";
+    }
+  }
 }
 using namespace edmtest;
 DEFINE_FWK_MODULE(ESTestAnalyzerA);
 DEFINE_FWK_MODULE(ESTestAnalyzerB);
 DEFINE_FWK_MODULE(ESTestAnalyzerK);
 DEFINE_FWK_MODULE(ESTestAnalyzerAZ);
+DEFINE_FWK_MODULE(ESTestAnalyzerShared);
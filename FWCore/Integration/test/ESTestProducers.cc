@@ -4,6 +4,7 @@
 #include "FWCore/Integration/interface/ESTestRecords.h"
 #include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Framework/interface/ModuleFactory.h"
+#include "FWCore/Framework/interface/ForkSharedESData.h"
 
 #include "boost/shared_ptr.hpp"
 
@@ -245,6 +246,25 @@ namespace edmtest {
     return dataZ_;
   }
 
+
+  // ---------------------------------------------------------------------
+
+  // The data is shared between the forked children and holds the run the IOV starts in
+  class ESTestProducerShared : public edm::ESProducer {
+  public:
+    ESTestProducerShared(edm::ParameterSet const&);
+    boost::shared_ptr<ESTestDataShared> produce(ESTestRecordA const&);
+  };
+
+  ESTestProducerShared::ESTestProducerShared(edm::ParameterSet const&) {
+    setWhatProduced(this);
+  }
+
+  boost::shared_ptr<ESTestDataShared> ESTestProducerShared::produce(ESTestRecordA const& rec) {
+    return edm::eventsetup::makeForkSharedESData<ESTestDataShared>(rec, "", [&rec](ESTestDataShared& data) {
+      data.value() = rec.validityInterval().first().eventID().run();
+    });
+  }
 }
 
 using namespace edmtest;
@@ -260,3 +280,4 @@ DEFINE_FWK_EVENTSETUP_MODULE(ESTestProducerI);
 DEFINE_FWK_EVENTSETUP_MODULE(ESTestProducerJ);
 DEFINE_FWK_EVENTSETUP_MODULE(ESTestProducerK);
 DEFINE_FWK_EVENTSETUP_MODULE(ESTestProducerAZ);
+DEFINE_FWK_EVENTSETUP_MODULE(ESTestProducerShared);
@@ -0,0 +1,36 @@
+# The forked children share the data ESTestProducerShared makes through
+# makeForkSharedESData. The parent fills it for the first run before forking
+# and afterwards one child fills it for each new run. The analyzer checks in
+# every event that the data it gets lies in the shared memory and holds the
+# run of its IOV.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.options = cms.untracked.PSet(multiProcesses=cms.untracked.PSet(
+        maxChildProcesses=cms.untracked.int32(3),
+        maxSequentialEventsPerChild=cms.untracked.uint32(2),
+        eventSetupSharedMemorySize=cms.untracked.uint32(1)))
+
+process.source = cms.Source("EmptySource",
+    numberEventsInRun = cms.untracked.uint32(5)
+)
+
+process.emptyESSourceA = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordA"),
+    firstValid = cms.vuint32(1,2,3,4),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.esTestProducerShared = cms.ESProducer("ESTestProducerShared")
+
+process.esTestAnalyzerShared = cms.EDAnalyzer("ESTestAnalyzerShared")
+
+process.p = cms.Path(process.esTestAnalyzerShared)
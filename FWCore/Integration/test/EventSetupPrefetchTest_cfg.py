@@ -0,0 +1,79 @@
+# Makes the EventSetup data as soon as a Record gets a new IOV. ESTestRecordB
+# depends on ESTestRecordC, D and E, and ESTestRecordD on F, G and H, so the
+# Records are prefetched in three waves. The data of ESTestRecordB is only
+# gotten in some runs but its value shows it was made in every run.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.MessageLogger.MessageLogger_cfi")
+
+process.options = cms.untracked.PSet(
+    prefetchEventSetupOnNewIOV = cms.untracked.bool(True)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(10)
+)
+
+process.source = cms.Source("EmptySource",
+    numberEventsInLuminosityBlock = cms.untracked.uint32(1),
+    numberEventsInRun = cms.untracked.uint32(1)
+)
+
+process.emptyESSourceB = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordB"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.emptyESSourceC = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordC"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.emptyESSourceD = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordD"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.emptyESSourceE = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordE"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.emptyESSourceF = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordF"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.emptyESSourceG = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordG"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.emptyESSourceH = cms.ESSource("EmptyESSource",
+    recordName = cms.string("ESTestRecordH"),
+    firstValid = cms.vuint32(1,2,3,4,5,6,7,8,9),
+    iovIsRunNotTime = cms.bool(True)
+)
+
+process.esTestProducerB = cms.ESProducer("ESTestProducerB")
+process.esTestProducerC = cms.ESProducer("ESTestProducerC")
+process.esTestProducerD = cms.ESProducer("ESTestProducerD")
+process.esTestProducerE = cms.ESProducer("ESTestProducerE")
+process.esTestProducerF = cms.ESProducer("ESTestProducerF")
+process.esTestProducerG = cms.ESProducer("ESTestProducerG")
+process.esTestProducerH = cms.ESProducer("ESTestProducerH")
+
+process.esTestAnalyzerB = cms.EDAnalyzer("ESTestAnalyzerB",
+    runsToGetDataFor = cms.vint32(1,3,6,10)
+)
+
+process.p = cms.Path(process.esTestAnalyzerB)
@@ -0,0 +1,14 @@
+#!/bin/bash
+
+CFG_DIR=${LOCAL_TEST_DIR}/../python/test
+
+function die { echo Failure $1: status $2 ; exit $2 ; }
+
+pushd ${LOCAL_TMP_DIR}
+
+  cmsRun ${CFG_DIR}/deleteEarlyOutput_cfg.py || die "cmsRun deleteEarlyOutput_cfg.py" $?
+  cmsRun ${CFG_DIR}/deleteEarlyOutputRead_cfg.py || die "cmsRun deleteEarlyOutputRead_cfg.py" $?
+
+popd
+
+exit 0
@@ -7,3 +7,6 @@ cmsRun --parameter-set ${LOCAL_TEST_DIR}/EventSetupAppendLabelTest_cfg.py || die
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/EventSetupTest2_cfg.py || die 'Failed in EventSetupTest2_cfg.py' $?
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/EventSetupTest2_cfg.py || die 'Failed in EventSetupAppendLabelTest2_cfg.py' $?
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/EventSetupForceCacheClearTest_cfg.py || die 'Failed in EventSetupForceCacheClearTest_cfg.py' $?
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/EventSetupPrefetchTest_cfg.py > ${LOCAL_TMP_DIR}/EventSetupPrefetchTest.log 2>&1 || die 'Failed in EventSetupPrefetchTest_cfg.py' $?
+grep "ESTestAnalyzerB: p" ${LOCAL_TMP_DIR}/EventSetupPrefetchTest.log | diff ${LOCAL_TEST_DIR}/unit_test_outputs/EventSetupPrefetchTest.grep.txt - || die 'comparing EventSetupPrefetchTest.grep.txt' $?
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/EventSetupForkSharedTest_cfg.py || die 'Failed in EventSetupForkSharedTest_cfg.py' $?
@@ -228,6 +228,7 @@ namespace edm {
         std::map<std::string, long long> readBranches_;
         std::set<std::string>* fastClonedBranches_;
         std::ostream* ost_;
+        std::string parentJobReportFile_; // closed at the fork
       };
 
       JobReport();
@@ -243,6 +244,10 @@ namespace edm {
 
       void parentAfterFork(std::string const& jobReportFile);
 
+      /// Adds to the report of the parent, closed at the fork, what another job run
+      /// by the parent wrote in its own report, e.g. the merge of the children's files.
+      void parentAddReport(std::string const& report);
+
       /// Report that an input file has been opened.
       /// The returned Token should be used for later identification
       /// of this file.
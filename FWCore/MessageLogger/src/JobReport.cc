@@ -480,10 +480,26 @@ namespace edm {
         std::ofstream* p = dynamic_cast<std::ofstream *>(impl_->ost_);
         if(p) {
           p->close();
+          impl_->parentJobReportFile_ = jobReportFile;
         }
       }
     }
 
+    void
+    JobReport::parentAddReport(std::string const& report) {
+      if(impl_->parentJobReportFile_.empty()) return;
+      std::string const begin("<FrameworkJobReport>\n");
+      std::string const end("</FrameworkJobReport>\n");
+      std::string::size_type first = report.find(begin);
+      std::string::size_type last = report.rfind(end);
+      if(first == std::string::npos || last == std::string::npos || last < first + begin.size()) return;
+      first += begin.size();
+      // The report of the parent ends with the end tag, the records go before it.
+      std::fstream file(impl_->parentJobReportFile_.c_str(), std::ios::in | std::ios::out);
+      file.seekp(-static_cast<std::streamoff>(end.size()), std::ios::end);
+      file << report.substr(first, last - first) << end << std::flush;
+    }
+
     void
     JobReport::parentAfterFork(std::string const& /*jobReportFile*/) {
     }
@@ -49,6 +49,7 @@ EmptyESSource::EmptyESSource(ParameterSet const& pset) :
       }
    }
    //copy_all(temp, inserter(setOfIOV_ , setOfIOV_.end()));
+   setHasFixedIntervals();
 }
   
    
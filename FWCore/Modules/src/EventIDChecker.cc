@@ -135,6 +135,10 @@ EventIDChecker::beginJob() {
 // ------------ method called once each job just after ending the event loop  ------------
 void
 EventIDChecker::endJob() {
+   //a forked child only sees some of the events
+   if(!mustSearch_ && index_ != ids_.size()) {
+      throw cms::Exception("MissedEvent") << "Was passed " << ids_.size() << " EventIDs but only processed " << index_ << " events\n";
+   }
 }
 
 // ------------ method called once each job for validation
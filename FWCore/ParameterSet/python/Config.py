@@ -108,7 +108,7 @@ class Process(object):
         self.__dict__['_Process__producers'] = {}
         self.__dict__['_Process__source'] = None
         self.__dict__['_Process__looper'] = None
-        self.__dict__['_Process__subProcess'] = None
+        self.__dict__['_Process__subProcesses'] = []
         self.__dict__['_Process__schedule'] = None
         self.__dict__['_Process__analyzers'] = {}
         self.__dict__['_Process__outputmodules'] = {}
@@ -191,11 +191,21 @@ class Process(object):
         self._placeLooper('looper',lpr)
     looper = property(looper_,setLooper_,doc='the main looper or None if not set')
     def subProcess_(self):
-        """returns the sub-process which has been added to the Process or None if none have been added"""
-        return self.__subProcess
+        """returns the first sub-process which has been added to the Process or None if none have been added"""
+        if self.__subProcesses:
+            return self.__subProcesses[0]
+        return None
     def setSubProcess_(self,lpr):
         self._placeSubProcess('subProcess',lpr)
     subProcess = property(subProcess_,setSubProcess_,doc='the SubProcess or None if not set')
+    def subProcesses_(self):
+        """returns a list of the sub-processes which have been added to the Process"""
+        return list(self.__subProcesses)
+    def addSubProcess(self,mod):
+        """adds a sub-process which runs next to those already added, each reading the products of this Process"""
+        if not isinstance(mod,SubProcess):
+            raise TypeError("addSubProcess only takes a cms.SubProcess")
+        self.__subProcesses.append(mod)
     def analyzers_(self):
         """returns a dict of the analyzers which have been added to the Process"""
         return DictTypes.FixedKeysDict(self.__analyzers)
@@ -470,7 +480,9 @@ class Process(object):
     def _placeSubProcess(self,name,mod):
         if name != 'subProcess':
             raise ValueError("The label '"+name+"' can not be used for a SubProcess.  Only 'subProcess' is allowed.")
-        self.__dict__['_Process__subProcess'] = mod
+        if self.__subProcesses and self.__subProcesses[0] is not mod:
+            raise ValueError("The 'subProcess' has already been set.  Use addSubProcess to add another SubProcess.")
+        self.__dict__['_Process__subProcesses'] = [mod]
         self.__dict__[mod.type_()] = mod
     def _placeService(self,typeName,mod):
         self._place(typeName, mod, self.__services)
@@ -547,8 +559,11 @@ class Process(object):
             config += options.indentation()+"source = "+self.source_().dumpConfig(options)
         if self.looper_():
             config += options.indentation()+"looper = "+self.looper_().dumpConfig(options)
-        if self.subProcess_():
-            config += options.indentation()+"subProcess = "+self.subProcess_().dumpConfig(options)
+        for i,subProcess in enumerate(self.subProcesses_()):
+            label = "subProcess"
+            if i != 0:
+                label += str(i)
+            config += options.indentation()+label+" = "+subProcess.dumpConfig(options)
 
         config+=self._dumpConfigNamedList(self.producers_().iteritems(),
                                   'module',
@@ -667,8 +682,8 @@ class Process(object):
             result += "process.source = "+self.source_().dumpPython(options)
         if self.looper_():
             result += "process.looper = "+self.looper_().dumpPython()
-        if self.subProcess_():
-            result += self.subProcess_().dumpPython(options)
+        for i,subProcess in enumerate(self.subProcesses_()):
+            result += subProcess.dumpPython(options, i != 0)
         result+=self._dumpPythonList(self.producers_(), options)
         result+=self._dumpPythonList(self.filters_() , options)
         result+=self._dumpPythonList(self.analyzers_(), options)
@@ -713,6 +728,15 @@ class Process(object):
             vitems = [newlabel]
             item.insertInto(parameterSet, newlabel)
         parameterSet.addVString(tracked, label, vitems)
+    def _insertSubProcessesInto(self, parameterSet):
+        l = []
+        for i,subProcess in enumerate(self.subProcesses_()):
+            newLabel = subProcess.nameInProcessDesc_('subProcess')
+            if i != 0:
+                newLabel += str(i)
+            l.append(newLabel)
+            subProcess.insertInto(parameterSet, newLabel)
+        parameterSet.addVString(False, "@all_subprocesses", l)
     def _insertManyInto(self, parameterSet, label, itemDict, tracked):
         l = []
         for name,value in itemDict.iteritems():
@@ -844,7 +868,7 @@ class Process(object):
         self._insertManyInto(processPSet, "@all_modules", all_modules, True)
         self._insertOneInto(processPSet,  "@all_sources", self.source_(), True)
         self._insertOneInto(processPSet,  "@all_loopers", self.looper_(), True)
-        self._insertOneInto(processPSet,  "@all_subprocesses", self.subProcess_(), False)
+        self._insertSubProcessesInto(processPSet)
         self._insertManyInto(processPSet, "@all_esmodules", self.es_producers_(), True)
         self._insertManyInto(processPSet, "@all_essources", self.es_sources_(), True)
         self._insertManyInto(processPSet, "@all_esprefers", self.es_prefers_(), True)
@@ -962,13 +986,26 @@ class SubProcess(_ConfigureComponent,_Unlabelable):
       self.__process = process
       self.__SelectEvents = SelectEvents
       self.__outputCommands = outputCommands
-   def dumpPython(self,options):
+   def dumpPython(self,options,added=False):
       out = "parentProcess"+str(hash(self))+" = process\n"
       out += self.__process.dumpPython()
       out += "childProcess = process\n"
       out += "process = parentProcess"+str(hash(self))+"\n"
-      out += "process.subProcess = cms.SubProcess( process = childProcess, SelectEvents = "+self.__SelectEvents.dumpPython(options) +", outputCommands = "+self.__outputCommands.dumpPython(options) +")\n"
+      subProcess = "cms.SubProcess( process = childProcess, SelectEvents = "+self.__SelectEvents.dumpPython(options) +", outputCommands = "+self.__outputCommands.dumpPython(options) +")"
+      if added:
+         out += "process.addSubProcess( "+subProcess+" )\n"
+      else:
+         out += "process.subProcess = "+subProcess+"\n"
       return out
+   def dumpConfig(self,options):
+      config = "{\n"
+      options.indent()
+      config += options.indentation()+self.__SelectEvents.configTypeName()+" SelectEvents = "+self.__SelectEvents.configValue(options)+"\n"
+      config += options.indentation()+self.__outputCommands.configTypeName()+" outputCommands = "+self.__outputCommands.configValue(options)+"\n"
+      config += options.indentation()+self.__process.dumpConfig(options)
+      options.unindent()
+      config += options.indentation()+"}\n"
+      return config
    def type_(self):
       return 'subProcess'
    def nameInProcessDesc_(self,label):
@@ -982,7 +1019,7 @@ class SubProcess(_ConfigureComponent,_Unlabelable):
       self.__SelectEvents.insertInto(subProcessPSet,"SelectEvents")
       self.__outputCommands.insertInto(subProcessPSet,"outputCommands")
       subProcessPSet.addPSet(False,"process",topPSet)
-      parameterSet.addPSet(False,self.nameInProcessDesc_("subProcess"), subProcessPSet)
+      parameterSet.addPSet(False,newlabel, subProcessPSet)
 
 if __name__=="__main__":
     import unittest
@@ -1543,10 +1580,36 @@ process.subProcess = cms.SubProcess( process = childProcess, SelectEvents = cms.
             equalD = equalD.replace("parentProcess","parentProcess"+str(hash(process.subProcess)))
             self.assertEqual(d,equalD)
             p = TestMakePSet()
-            process.subProcess.insertInto(p,"dummy")
+            process.subProcess.insertInto(p,"@sub_process")
             self.assertEqual((True,['a']),p.values["@sub_process"][1].values["process"][1].values['@all_modules'])
             self.assertEqual((True,['p']),p.values["@sub_process"][1].values["process"][1].values['@paths'])
             self.assertEqual({'@service_type':(True,'Foo')}, p.values["@sub_process"][1].values["process"][1].values["services"][1][0].values)
+        def testSubProcesses(self):
+            process = Process("Parent")
+            subProcess1 = Process("Child1")
+            subProcess1.a = EDProducer("A")
+            subProcess2 = Process("Child2")
+            subProcess2.b = EDProducer("B")
+            process.subProcess = SubProcess(subProcess1)
+            process.addSubProcess(SubProcess(subProcess2))
+            self.assertEqual(len(process.subProcesses_()),2)
+            self.assertRaises(TypeError,process.addSubProcess,EDProducer("C"))
+            self.assertRaises(ValueError,setattr,process,"subProcess",SubProcess(Process("Child3")))
+            self.assertEqual(len(process.subProcesses_()),2)
+            d = process.dumpPython()
+            self.assert_("process.subProcess = cms.SubProcess(" in d)
+            self.assert_("process.addSubProcess( cms.SubProcess(" in d)
+            namespace = {}
+            exec d in namespace
+            self.assertEqual([s._SubProcess__process.name_() for s in namespace["process"].subProcesses_()],["Child1","Child2"])
+            c = process.dumpConfig()
+            self.assert_("subProcess = {" in c)
+            self.assert_("subProcess1 = {" in c)
+            p = TestMakePSet()
+            process.fillProcessDesc(p)
+            self.assertEqual((False,['@sub_process','@sub_process1']),p.values["@all_subprocesses"])
+            self.assertEqual((True,['a']),p.values["@sub_process"][1].values["process"][1].values['@all_modules'])
+            self.assertEqual((True,['b']),p.values["@sub_process1"][1].values["process"][1].values['@all_modules'])
         def testPrune(self):
             p = Process("test")
             p.a = EDAnalyzer("MyAnalyzer")
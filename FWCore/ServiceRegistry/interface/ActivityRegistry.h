@@ -30,6 +30,7 @@
 #define AR_WATCH_USING_METHOD_0(method) template<class TClass, class TMethod> void method (TClass* iObject, TMethod iMethod) { method (boost::bind(boost::mem_fn(iMethod), iObject)); }
 #define AR_WATCH_USING_METHOD_1(method) template<class TClass, class TMethod> void method (TClass* iObject, TMethod iMethod) { method (boost::bind(boost::mem_fn(iMethod), iObject, _1)); }
 #define AR_WATCH_USING_METHOD_2(method) template<class TClass, class TMethod> void method (TClass* iObject, TMethod iMethod) { method (boost::bind(boost::mem_fn(iMethod), iObject, _1, _2)); }
+#define AR_WATCH_USING_METHOD_3(method) template<class TClass, class TMethod> void method (TClass* iObject, TMethod iMethod) { method (boost::bind(boost::mem_fn(iMethod), iObject, _1, _2, _3)); }
 // forward declarations
 namespace edm {
    class EventID;
@@ -494,6 +495,16 @@ namespace edm {
          postForkReacquireResourcesSignal_.connect_front(iSlot);
       }
       AR_WATCH_USING_METHOD_2(watchPostForkReacquireResources)
+
+      /// signal is emitted by the TaskScheduler at the end of each luminosity block and of the job,
+      /// once for each thread which ran tasks. The arguments are the index of the thread, the seconds
+      /// it spent running tasks and the seconds of wall clock time since the previous emission.
+      typedef signalslot::Signal<void(unsigned int, double, double)> ThreadUtilisation;
+      ThreadUtilisation threadUtilisationSignal_;
+      void watchThreadUtilisation(ThreadUtilisation::slot_type const& iSlot) {
+         threadUtilisationSignal_.connect(iSlot);
+      }
+      AR_WATCH_USING_METHOD_3(watchThreadUtilisation)
       
       // ---------- member functions ---------------------------
       
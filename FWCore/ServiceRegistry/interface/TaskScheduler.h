@@ -0,0 +1,159 @@
+#ifndef FWCore_ServiceRegistry_TaskScheduler_h
+#define FWCore_ServiceRegistry_TaskScheduler_h
+// -*- C++ -*-
+//
+// Package:     ServiceRegistry
+// Class  :     TaskScheduler
+//
+/**\class TaskScheduler TaskScheduler.h FWCore/ServiceRegistry/interface/TaskScheduler.h
+
+ Description: Work-stealing task scheduler shared by the framework, Services and modules
+
+ Usage:
+    The framework makes this Service available in every job. All work which is to be done
+    in parallel, whether it is the framework running modules or a module splitting up its
+    own work, should go through it. Nested parallelism then shares one pool of threads
+    instead of oversubscribing the cores.
+
+    A module can run a loop in parallel
+    \code
+       edm::Service<edm::TaskScheduler> scheduler;
+       scheduler->parallelFor(0, hits.size(), [&](unsigned int i) { fit(hits[i]); });
+    \endcode
+    or run independent pieces of work as a group
+    \code
+       edm::TaskScheduler::TaskGroup group(*scheduler);
+       group.run([&]() { fitTracks(); });
+       group.run([&]() { fitVertices(); });
+       group.wait();
+    \endcode
+
+    A thread which waits for a group or a parallelFor runs other queued tasks while it waits.
+    Tasks see the same Services as the thread which started them. An exception thrown by a
+    task is rethrown from wait or parallelFor.
+
+    The time each thread spends running tasks is reported through the ActivityRegistry's
+    threadUtilisation signal at the end of each luminosity block and at the end of the job.
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <atomic>
+#include <chrono>
+#include <vector>
+
+#include "boost/thread/mutex.hpp"
+#include "boost/utility.hpp"
+#include "tbb/blocked_range.h"
+#include "tbb/enumerable_thread_specific.h"
+#include "tbb/parallel_for.h"
+#include "tbb/task_arena.h"
+#include "tbb/task_group.h"
+
+// user include files
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
+#include "FWCore/ServiceRegistry/interface/ServiceToken.h"
+
+// forward declarations
+namespace edm {
+  class ActivityRegistry;
+  class EventSetup;
+  class LuminosityBlock;
+
+  class TaskScheduler : private boost::noncopyable {
+    struct ThreadStats;
+
+    // Makes the Services of the starting thread available and times the task
+    class TaskSentry : private boost::noncopyable {
+    public:
+      TaskSentry(TaskScheduler& iScheduler, ServiceToken const& iToken);
+      ~TaskSentry();
+    private:
+      ServiceRegistry::Operate operate_;
+      TaskScheduler* scheduler_;
+      ThreadStats* stats_;
+    };
+
+  public:
+    class TaskGroup : private boost::noncopyable {
+    public:
+      explicit TaskGroup(TaskScheduler& iScheduler) : scheduler_(&iScheduler), group_() {}
+      ~TaskGroup();
+
+      ///runs iFunc asynchronously
+      template <typename F>
+      void run(F const& iFunc) {
+        TaskScheduler* scheduler = scheduler_;
+        ServiceToken token = ServiceRegistry::instance().presentToken();
+        group_.run([scheduler, token, iFunc]() {
+          TaskSentry sentry(*scheduler, token);
+          iFunc();
+        });
+      }
+
+      ///returns once all tasks given to run have finished, rethrows the exception of a failed task
+      void wait() { group_.wait(); }
+
+    private:
+      TaskScheduler* scheduler_;
+      tbb::task_group group_;
+    };
+
+    explicit TaskScheduler(ActivityRegistry& iRegistry);
+    ~TaskScheduler();
+
+    // ---------- member functions ---------------------------
+    ///calls iFunc(i) for every i in [iBegin, iEnd) and returns once all calls have finished
+    template <typename F>
+    void parallelFor(unsigned int iBegin, unsigned int iEnd, F const& iFunc) {
+      ServiceToken token = ServiceRegistry::instance().presentToken();
+      tbb::parallel_for(tbb::blocked_range<unsigned int>(iBegin, iEnd),
+                        [this, &token, &iFunc](tbb::blocked_range<unsigned int> const& iRange) {
+        TaskSentry sentry(*this, token);
+        for(unsigned int i = iRange.begin(), e = iRange.end(); i != e; ++i) {
+          iFunc(i);
+        }
+      });
+    }
+
+    ///runs iFunc on this thread. While iFunc waits for tasks it started, the thread only runs
+    /// those tasks and takes up no other work, which might need what iFunc is doing.
+    template <typename F>
+    static void isolate(F const& iFunc) {
+      tbb::this_task_arena::isolate(iFunc);
+    }
+
+    ///emits the threadUtilisation signal for the time since the previous call
+    void reportUtilisation();
+
+  private:
+    struct ThreadStats {
+      ThreadStats() : index_(0), depth_(0), busyNanoseconds_(0) {}
+      // set when the thread runs its first task
+      unsigned int index_;
+      // only changed by the thread itself so nested tasks are only timed once
+      unsigned int depth_;
+      std::chrono::steady_clock::time_point start_;
+      std::atomic<unsigned long long> busyNanoseconds_;
+    };
+
+    ThreadStats* startTask();
+    void finishTask(ThreadStats* iStats);
+
+    void postEndLumi(LuminosityBlock const&, EventSetup const&);
+    void postEndJob();
+
+    // ---------- member data --------------------------------
+    ActivityRegistry* registry_;
+    // owned here so no thread is left holding ThreadStats of a deleted TaskScheduler
+    tbb::enumerable_thread_specific<ThreadStats> threadStats_;
+    boost::mutex allStatsMutex_;
+    // the entries of threadStats_ which are completely set up, they do not move once created
+    std::vector<ThreadStats*> allStats_;
+    std::chrono::steady_clock::time_point lastReport_;
+  };
+}
+
+#endif
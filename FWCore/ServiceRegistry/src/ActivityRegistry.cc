@@ -127,6 +127,8 @@ namespace edm {
 
      preForkReleaseResourcesSignal_.connect(std::cref(iOther.preForkReleaseResourcesSignal_));
      postForkReacquireResourcesSignal_.connect(std::cref(iOther.postForkReacquireResourcesSignal_));
+
+     threadUtilisationSignal_.connect(std::cref(iOther.threadUtilisationSignal_));
   }
 
   void
@@ -265,6 +267,8 @@ namespace edm {
 
     copySlotsToFrom(preForkReleaseResourcesSignal_, iOther.preForkReleaseResourcesSignal_);
     copySlotsToFromReverse(postForkReacquireResourcesSignal_, iOther.postForkReacquireResourcesSignal_);
+
+    copySlotsToFrom(threadUtilisationSignal_, iOther.threadUtilisationSignal_);
   }
 
   //
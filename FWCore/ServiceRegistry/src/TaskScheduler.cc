@@ -0,0 +1,111 @@
+// -*- C++ -*-
+//
+// Package:     ServiceRegistry
+// Class  :     TaskScheduler
+//
+// Implementation:
+//     The threads and the work stealing are those of TBB. What is added here is
+//     the passing of the Services to the tasks and the accounting of the time
+//     each thread spends running tasks. The first task a thread runs gives the
+//     thread an index which is kept for the rest of the job.
+//
+// $Id$
+//
+
+// system include files
+
+// user include files
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+
+using namespace edm;
+
+//
+// constructors and destructor
+//
+TaskScheduler::TaskSentry::TaskSentry(TaskScheduler& iScheduler, ServiceToken const& iToken) :
+  operate_(iToken),
+  scheduler_(&iScheduler),
+  stats_(iScheduler.startTask()) {
+}
+
+TaskScheduler::TaskSentry::~TaskSentry() {
+  scheduler_->finishTask(stats_);
+}
+
+TaskScheduler::TaskGroup::~TaskGroup() {
+  //tasks may refer to data owned by the caller so they must be finished before we go away
+  group_.cancel();
+  try {
+    group_.wait();
+  } catch(...) {
+  }
+}
+
+TaskScheduler::TaskScheduler(ActivityRegistry& iRegistry) :
+  registry_(&iRegistry),
+  threadStats_(),
+  allStatsMutex_(),
+  allStats_(),
+  lastReport_(std::chrono::steady_clock::now()) {
+  iRegistry.watchPostEndLumi(this, &TaskScheduler::postEndLumi);
+  iRegistry.watchPostEndJob(this, &TaskScheduler::postEndJob);
+}
+
+TaskScheduler::~TaskScheduler() {
+}
+
+//
+// member functions
+//
+TaskScheduler::ThreadStats*
+TaskScheduler::startTask() {
+  bool exists = false;
+  ThreadStats* stats = &threadStats_.local(exists);
+  if(not exists) {
+    boost::mutex::scoped_lock lock(allStatsMutex_);
+    stats->index_ = allStats_.size();
+    allStats_.push_back(stats);
+  }
+  if(0 == stats->depth_++) {
+    stats->start_ = std::chrono::steady_clock::now();
+  }
+  return stats;
+}
+
+void
+TaskScheduler::finishTask(ThreadStats* iStats) {
+  if(0 == --iStats->depth_) {
+    auto busy = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - iStats->start_);
+    iStats->busyNanoseconds_ += busy.count();
+  }
+}
+
+void
+TaskScheduler::reportUtilisation() {
+  auto now = std::chrono::steady_clock::now();
+  double wallSeconds = std::chrono::duration<double>(now - lastReport_).count();
+  lastReport_ = now;
+
+  std::vector<std::pair<unsigned int, double> > busySeconds;
+  {
+    boost::mutex::scoped_lock lock(allStatsMutex_);
+    busySeconds.reserve(allStats_.size());
+    for(auto stats : allStats_) {
+      busySeconds.emplace_back(stats->index_, stats->busyNanoseconds_.exchange(0) * 1.0e-9);
+    }
+  }
+  for(auto const& threadAndBusy : busySeconds) {
+    registry_->threadUtilisationSignal_(threadAndBusy.first, threadAndBusy.second, wallSeconds);
+  }
+}
+
+void
+TaskScheduler::postEndLumi(LuminosityBlock const&, EventSetup const&) {
+  reportUtilisation();
+}
+
+void
+TaskScheduler::postEndJob() {
+  reportUtilisation();
+}
@@ -0,0 +1,118 @@
+/*
+ *  taskscheduler_t.cppunit.cc
+ *  CMSSW
+ *
+ */
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/TaskScheduler.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+#include <map>
+#include <stdexcept>
+
+class testTaskScheduler: public CppUnit::TestFixture
+{
+   CPPUNIT_TEST_SUITE(testTaskScheduler);
+
+   CPPUNIT_TEST(parallelForTest);
+   CPPUNIT_TEST(taskGroupTest);
+   CPPUNIT_TEST(exceptionTest);
+   CPPUNIT_TEST(utilisationTest);
+
+   CPPUNIT_TEST_SUITE_END();
+public:
+   void setUp(){}
+   void tearDown(){}
+
+   void parallelForTest();
+   void taskGroupTest();
+   void exceptionTest();
+   void utilisationTest();
+};
+
+///registration of the test so that the runner can find it
+CPPUNIT_TEST_SUITE_REGISTRATION(testTaskScheduler);
+
+void
+testTaskScheduler::parallelForTest()
+{
+   edm::ActivityRegistry ar;
+   edm::TaskScheduler scheduler(ar);
+
+   std::vector<int> values(1000, 0);
+   scheduler.parallelFor(0, values.size(), [&values](unsigned int i) { values[i] = i; });
+   for(unsigned int i = 0; i != values.size(); ++i) {
+      CPPUNIT_ASSERT(values[i] == static_cast<int>(i));
+   }
+
+   //nothing to do
+   scheduler.parallelFor(5, 5, [](unsigned int) { CPPUNIT_ASSERT(false); });
+}
+
+void
+testTaskScheduler::taskGroupTest()
+{
+   edm::ActivityRegistry ar;
+   edm::TaskScheduler scheduler(ar);
+
+   std::atomic<unsigned int> count(0);
+   edm::TaskScheduler::TaskGroup group(scheduler);
+   for(unsigned int i = 0; i != 10; ++i) {
+      //nested parallelism uses the same scheduler
+      group.run([&scheduler, &count]() {
+         scheduler.parallelFor(0, 10, [&count](unsigned int) { ++count; });
+      });
+   }
+   group.wait();
+   CPPUNIT_ASSERT(count == 100);
+}
+
+void
+testTaskScheduler::exceptionTest()
+{
+   edm::ActivityRegistry ar;
+   edm::TaskScheduler scheduler(ar);
+
+   edm::TaskScheduler::TaskGroup group(scheduler);
+   group.run([]() { throw std::runtime_error("failed"); });
+   CPPUNIT_ASSERT_THROW(group.wait(), std::runtime_error);
+
+   CPPUNIT_ASSERT_THROW(scheduler.parallelFor(0, 10, [](unsigned int i) { if(i == 3) throw std::runtime_error("failed"); }),
+                        std::runtime_error);
+}
+
+void
+testTaskScheduler::utilisationTest()
+{
+   edm::ActivityRegistry ar;
+   edm::TaskScheduler scheduler(ar);
+
+   std::map<unsigned int, double> busy;
+   double wall = -1.;
+   ar.watchThreadUtilisation([&busy, &wall](unsigned int iThread, double iBusy, double iWall) {
+      busy[iThread] += iBusy;
+      wall = iWall;
+   });
+
+   std::atomic<unsigned long> sum(0);
+   scheduler.parallelFor(0, 100, [&sum](unsigned int i) {
+      for(unsigned long j = 0; j != 10000; ++j) { sum += i*j; }
+   });
+   ar.postEndJobSignal_();
+
+   CPPUNIT_ASSERT(!busy.empty());
+   CPPUNIT_ASSERT(wall > 0.);
+   for(auto const& threadAndBusy : busy) {
+      CPPUNIT_ASSERT(threadAndBusy.second >= 0.);
+      CPPUNIT_ASSERT(threadAndBusy.second <= wall);
+   }
+
+   //the busy time is only reported once
+   busy.clear();
+   scheduler.reportUtilisation();
+   for(auto const& threadAndBusy : busy) {
+      CPPUNIT_ASSERT(threadAndBusy.second == 0.);
+   }
+}
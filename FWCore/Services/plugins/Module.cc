@@ -6,6 +6,7 @@
 #include "FWCore/Services/src/JobReportService.h"
 #include "FWCore/Services/interface/Timing.h"
 #include "FWCore/Services/src/Memory.h"
+#include "FWCore/Services/src/ModuleLatency.h"
 #include "FWCore/Services/src/CPU.h"
 #include "FWCore/Services/src/Profiling.h"
 #include "FWCore/Services/src/LoadAllDictionaries.h"
@@ -19,6 +20,7 @@
 using edm::service::JobReportService;
 using edm::service::Tracer;
 using edm::service::Timing;
+using edm::service::ModuleLatency;
 using edm::service::SimpleMemoryCheck;
 using edm::service::CPU;
 using edm::service::SimpleProfiling;
@@ -32,6 +34,7 @@ using edm::PrintEventSetupDataRetrieval;
 
 DEFINE_FWK_SERVICE(Tracer);
 DEFINE_FWK_SERVICE(Timing);
+DEFINE_FWK_SERVICE(ModuleLatency);
 DEFINE_FWK_SERVICE(UpdaterService);
 DEFINE_FWK_SERVICE(CPU);
 DEFINE_FWK_SERVICE(PrintEventSetupDataRetrieval);
@@ -21,6 +21,10 @@
 //        Added:        - Average rate of growth in RSS and peak value attained.
 //                - Average rate of growth in VSize over time, Peak VSize
 //
+// 4 - With monitorPssAndPrivate a forked child reports at the end of the job
+//        how much of its memory is still shared with the other processes,
+//        compared to what it shared just after the fork.
+//
 //
 
 #include "FWCore/Services/src/Memory.h"
@@ -82,6 +86,8 @@ namespace edm {
       
       /*
        The format of the report is
+       Shared_Clean:         4 kB
+       Shared_Dirty:         0 kB
        Private_Clean:        0 kB
        Private_Dirty:       72 kB
        Swap:                 0 kB
@@ -99,6 +105,10 @@ namespace edm {
             unsigned int value = atoi(smapsLineBuffer_+4);
             //Convert from kB to MB
             ret.pss_ += static_cast<double>(value)/1024.;            
+          } else if(0==strncmp("Shared_",smapsLineBuffer_,7)) {
+            unsigned int value = atoi(smapsLineBuffer_+13);
+            //Convert from kB to MB
+            ret.shared_ += static_cast<double>(value)/1024.;
           }
         }
       }
@@ -126,6 +136,9 @@ namespace edm {
     , smapsFile_(0)
     , smapsLineBuffer_(NULL)
     , smapsLineBufferLen_(0)
+    , forkedChild_(false)
+    , childIndex_(0)
+    , smapsAtFork_()
     , growthRateVsize_()
     , growthRateRss_()
     , moduleSummaryRequested_(iPS.getUntrackedParameter<bool>("moduleMemorySummary")) {
@@ -418,6 +431,10 @@ namespace edm {
       reportSvc->reportPerformanceSummary("SystemMemory", reportMemoryProperties);
 #endif
 
+      if(forkedChild_) {                                        // changelog 4
+        reportForkedChild(fetchSmaps());
+      }
+
 #ifdef SIMPLE_MEMORY_CHECK_DIFFERENT_XML_OUTPUT
       std::vector<std::string> reportData;
 
@@ -518,15 +535,44 @@ namespace edm {
       }
     }
 
-    void SimpleMemoryCheck::postFork(unsigned int, unsigned int) {
+    void SimpleMemoryCheck::postFork(unsigned int iChildIndex, unsigned int) {
 #ifdef LINUX
       if(0 != smapsFile_) {
         fclose(smapsFile_);
       }
       openFiles();
+      if (monitorPssAndPrivate_) {                                  // changelog 4
+        forkedChild_ = true;
+        childIndex_ = iChildIndex;
+        smapsAtFork_ = fetchSmaps();
+      }
 #endif      
     }
 
+    // Pages still shared at the end were not written by the child since the fork.  The
+    // Pss counts each shared page divided by the number of processes sharing it, so the
+    // sum of the Pss of the children and of the parent is what the whole job uses.
+    void SimpleMemoryCheck::reportForkedChild(smapsInfo const& atEnd) const {
+      if(not jobReportOutputOnly_) {
+        LogAbsolute("ForkedChildMemoryReport")
+        << "ForkedChildMemoryReport> Child " << childIndex_ << "\n"
+        << " after fork: private " << smapsAtFork_.private_ << " Mbytes shared " << smapsAtFork_.shared_
+        << " Mbytes PSS " << smapsAtFork_.pss_ << " Mbytes\n"
+        << " end of job: private " << atEnd.private_ << " Mbytes shared " << atEnd.shared_
+        << " Mbytes PSS " << atEnd.pss_ << " Mbytes";
+      }
+      std::map<std::string, std::string> reportData;
+      reportData.insert(std::make_pair("ChildIndex", i2str(childIndex_)));
+      reportData.insert(std::make_pair("PrivateAfterFork", d2str(smapsAtFork_.private_)));
+      reportData.insert(std::make_pair("SharedAfterFork", d2str(smapsAtFork_.shared_)));
+      reportData.insert(std::make_pair("PssAfterFork", d2str(smapsAtFork_.pss_)));
+      reportData.insert(std::make_pair("PrivateAtEnd", d2str(atEnd.private_)));
+      reportData.insert(std::make_pair("SharedAtEnd", d2str(atEnd.shared_)));
+      reportData.insert(std::make_pair("PssAtEnd", d2str(atEnd.pss_)));
+      Service<JobReport> reportSvc;
+      reportSvc->reportPerformanceSummary("ForkedChildMemory", reportData);
+    }
+
     void SimpleMemoryCheck::update() {
       std::swap(current_, previous_);
       *current_ = fetch();
@@ -17,6 +17,9 @@
 // 2 - Jan 14, 2009 Natalia Garcia Nebot
 //      Added:  - Average rate of growth in RSS and peak value attained.
 //              - Average rate of growth in VSize over time, Peak VSize
+//
+// 3 - Memory shared with the other processes, and report of what a forked child
+//      still shares at the end of the job compared to just after the fork
 
 
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
@@ -37,8 +40,8 @@ namespace edm {
   namespace service {
     struct smapsInfo
     {
-      smapsInfo():private_(),pss_() {}
-      smapsInfo(double private_sz, double pss_sz): private_(private_sz),pss_(pss_sz) {}
+      smapsInfo():private_(),pss_(),shared_() {}
+      smapsInfo(double private_sz, double pss_sz): private_(private_sz),pss_(pss_sz),shared_() {}
       
       bool operator==(const smapsInfo& p) const
       { return private_==p.private_ && pss_==p.pss_; }
@@ -48,6 +51,7 @@ namespace edm {
       
       double private_;   // in MB
       double pss_;     // in MB
+      double shared_;  // in MB, resident pages also mapped by other processes
     };
 
     
@@ -90,6 +94,7 @@ namespace edm {
       void updateAndPrint(const std::string& type,
                         const std::string& mdlabel, const std::string& mdname);
       void openFiles();
+      void reportForkedChild(smapsInfo const& atEnd) const;
       
       ProcInfo a_;
       ProcInfo b_;
@@ -114,6 +119,11 @@ namespace edm {
       char* smapsLineBuffer_;
       size_t smapsLineBufferLen_;
 
+      //forked children                                        changeLog 3
+      bool forkedChild_;
+      unsigned int childIndex_;
+      smapsInfo smapsAtFork_;
+
       
       //Rates of growth
       double growthRateVsize_;
@@ -0,0 +1,308 @@
+// -*- C++ -*-
+//
+// Package:     Services
+// Class  :     ModuleLatency
+//
+// Implementation:
+//     Each thread keeps a stack of the modules it is running. When a module
+//     finishes, its times are added to the module which is running it, if any,
+//     so that module can subtract them from its own.
+//
+// $Id$
+//
+
+// system include files
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <time.h>
+#include <vector>
+
+#include "boost/thread/tss.hpp"
+
+// user include files
+#include "FWCore/Services/src/ModuleLatency.h"
+
+#include "DataFormats/Provenance/interface/ModuleDescription.h"
+#include "FWCore/MessageLogger/interface/JobReport.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
+#include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
+#include "FWCore/ParameterSet/interface/ParameterSet.h"
+#include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ServiceRegistry/interface/ActivityRegistry.h"
+#include "FWCore/ServiceRegistry/interface/Service.h"
+
+namespace edm {
+  namespace service {
+
+    namespace {
+      struct RunningModule {
+        LatencyHistogram* wall_;
+        LatencyHistogram* cpu_;
+        unsigned long long wallStart_;
+        unsigned long long cpuStart_;
+        unsigned long long nestedWall_;
+        unsigned long long nestedCpu_;
+      };
+
+      std::vector<RunningModule>& runningModules() {
+        static boost::thread_specific_ptr<std::vector<RunningModule> > s_running;
+        if(0 == s_running.get()) {
+          s_running.reset(new std::vector<RunningModule>);
+        }
+        return *s_running;
+      }
+
+      //CLOCK_MONOTONIC is read from the vDSO without a system call, CLOCK_THREAD_CPUTIME_ID is not
+      unsigned long long nanoseconds(clockid_t iClock) {
+        timespec t;
+        clock_gettime(iClock, &t);
+        return static_cast<unsigned long long>(t.tv_sec) * 1000000000ULL + t.tv_nsec;
+      }
+
+      char const* const kTransitionNames[] = {"Event", "BeginRun", "EndRun", "BeginLumi", "EndLumi"};
+
+      std::string toSeconds(unsigned long long iNanoseconds) {
+        std::ostringstream s;
+        s << iNanoseconds * 1E-9;
+        return s.str();
+      }
+    }
+
+    //
+    // LatencyHistogram
+    //
+    LatencyHistogram::LatencyHistogram() :
+        count_(0),
+        sum_(0),
+        max_(0) {
+      for(auto& bucket : buckets_) {
+        bucket = 0;
+      }
+    }
+
+    unsigned int LatencyHistogram::bucket(unsigned long long iNanoseconds) {
+      if(iNanoseconds < kSubBuckets) {
+        return iNanoseconds;
+      }
+      unsigned int highestBit = 63 - __builtin_clzll(iNanoseconds);
+      if(highestBit >= kMaxBits) {
+        return kNBuckets - 1;
+      }
+      unsigned int shift = highestBit - kSubBucketBits;
+      return (shift + 1) * kSubBuckets + ((iNanoseconds >> shift) & (kSubBuckets - 1));
+    }
+
+    unsigned long long LatencyHistogram::upperEdge(unsigned int iBucket) {
+      if(iBucket < kSubBuckets) {
+        return iBucket;
+      }
+      unsigned int shift = iBucket / kSubBuckets - 1;
+      unsigned long long lowerEdge = static_cast<unsigned long long>(kSubBuckets + iBucket % kSubBuckets) << shift;
+      return lowerEdge + (1ULL << shift) - 1;
+    }
+
+    void LatencyHistogram::fill(unsigned long long iNanoseconds) {
+      buckets_[bucket(iNanoseconds)].fetch_add(1, std::memory_order_relaxed);
+      count_.fetch_add(1, std::memory_order_relaxed);
+      sum_.fetch_add(iNanoseconds, std::memory_order_relaxed);
+      unsigned long long oldMax = max_.load(std::memory_order_relaxed);
+      while(oldMax < iNanoseconds and
+            not max_.compare_exchange_weak(oldMax, iNanoseconds, std::memory_order_relaxed)) {
+      }
+    }
+
+    double LatencyHistogram::mean() const {
+      unsigned long long n = count_;
+      return n == 0 ? 0. : static_cast<double>(sum_) / n;
+    }
+
+    unsigned long long LatencyHistogram::quantile(double iFraction) const {
+      unsigned long long target = static_cast<unsigned long long>(std::ceil(iFraction * count_));
+      unsigned long long seen = 0;
+      for(unsigned int i = 0; i != kNBuckets; ++i) {
+        seen += buckets_[i];
+        if(seen >= target and seen != 0) {
+          return std::min(upperEdge(i), static_cast<unsigned long long>(max_));
+        }
+      }
+      return max_;
+    }
+
+    //
+    // ModuleLatency
+    //
+    ModuleLatency::ModuleLatency(ParameterSet const& iPS, ActivityRegistry& iRegistry) :
+        fileName_(iPS.getUntrackedParameter<std::string>("fileName")),
+        useJobReport_(iPS.getUntrackedParameter<bool>("useJobReport")),
+        measureCPUTime_(iPS.getUntrackedParameter<bool>("measureCPUTime")),
+        labelToHistograms_(),
+        idToHistograms_() {
+      iRegistry.watchPreModuleConstruction(this, &ModuleLatency::preModuleConstruction);
+      iRegistry.watchPostEndJob(this, &ModuleLatency::postEndJob);
+
+      iRegistry.watchPreModule(this, &ModuleLatency::preModule<kEvent>);
+      iRegistry.watchPostModule(this, &ModuleLatency::postModule<kEvent>);
+      iRegistry.watchPreModuleBeginRun(this, &ModuleLatency::preModule<kBeginRun>);
+      iRegistry.watchPostModuleBeginRun(this, &ModuleLatency::postModule<kBeginRun>);
+      iRegistry.watchPreModuleEndRun(this, &ModuleLatency::preModule<kEndRun>);
+      iRegistry.watchPostModuleEndRun(this, &ModuleLatency::postModule<kEndRun>);
+      iRegistry.watchPreModuleBeginLumi(this, &ModuleLatency::preModule<kBeginLumi>);
+      iRegistry.watchPostModuleBeginLumi(this, &ModuleLatency::postModule<kBeginLumi>);
+      iRegistry.watchPreModuleEndLumi(this, &ModuleLatency::preModule<kEndLumi>);
+      iRegistry.watchPostModuleEndLumi(this, &ModuleLatency::postModule<kEndLumi>);
+    }
+
+    ModuleLatency::~ModuleLatency() {
+    }
+
+    void ModuleLatency::fillDescriptions(ConfigurationDescriptions& descriptions) {
+      ParameterSetDescription desc;
+      desc.addUntracked<std::string>("fileName", std::string())->setComment(
+       "JSON file the histogram summaries are written to at the end of the job. If empty, the default, no file is written.");
+      desc.addUntracked<bool>("useJobReport", true)->setComment(
+       "If 'true' write the histogram summaries to the JobReport");
+      desc.addUntracked<bool>("measureCPUTime", false)->setComment(
+       "If 'true' also histogram the CPU time of the thread running the module, which costs two system calls per module call");
+      descriptions.add("ModuleLatency", desc);
+      descriptions.setComment(
+       "This service keeps histograms of the wall clock and, optionally, CPU time each module takes for each transition.");
+    }
+
+    void ModuleLatency::preModuleConstruction(ModuleDescription const& iDesc) {
+      std::unique_ptr<ModuleHistograms>& histograms = labelToHistograms_[iDesc.moduleLabel()];
+      if(not histograms) {
+        histograms.reset(new ModuleHistograms(iDesc.moduleName()));
+      }
+      if(iDesc.id() != ModuleDescription::invalidID()) {
+        if(iDesc.id() >= idToHistograms_.size()) {
+          idToHistograms_.resize(iDesc.id() + 1, 0);
+        }
+        idToHistograms_[iDesc.id()] = histograms.get();
+      }
+    }
+
+    template <ModuleLatency::Transition T>
+    void ModuleLatency::preModule(ModuleDescription const& iDesc) {
+      start(iDesc, T);
+    }
+
+    template <ModuleLatency::Transition T>
+    void ModuleLatency::postModule(ModuleDescription const&) {
+      stop();
+    }
+
+    void ModuleLatency::start(ModuleDescription const& iDesc, Transition iTransition) {
+      RunningModule running = {0, 0, 0, 0, 0, 0};
+      if(iDesc.id() < idToHistograms_.size() and 0 != idToHistograms_[iDesc.id()]) {
+        Histograms& histograms = idToHistograms_[iDesc.id()]->transitions_[iTransition];
+        running.wall_ = &histograms.wall_;
+        running.cpu_ = &histograms.cpu_;
+      }
+      std::vector<RunningModule>& stack = runningModules();
+      stack.push_back(running);
+      //read the clocks last so the bookkeeping is not counted
+      if(measureCPUTime_) {
+        stack.back().cpuStart_ = nanoseconds(CLOCK_THREAD_CPUTIME_ID);
+      }
+      stack.back().wallStart_ = nanoseconds(CLOCK_MONOTONIC);
+    }
+
+    void ModuleLatency::stop() {
+      unsigned long long wallEnd = nanoseconds(CLOCK_MONOTONIC);
+      unsigned long long cpuEnd = measureCPUTime_ ? nanoseconds(CLOCK_THREAD_CPUTIME_ID) : 0;
+      std::vector<RunningModule>& stack = runningModules();
+      if(stack.empty()) {
+        return;
+      }
+      RunningModule const running = stack.back();
+      stack.pop_back();
+
+      unsigned long long wall = wallEnd - running.wallStart_;
+      unsigned long long cpu = cpuEnd > running.cpuStart_ ? cpuEnd - running.cpuStart_ : 0;
+      if(running.wall_) {
+        running.wall_->fill(wall > running.nestedWall_ ? wall - running.nestedWall_ : 0);
+        if(measureCPUTime_) {
+          running.cpu_->fill(cpu > running.nestedCpu_ ? cpu - running.nestedCpu_ : 0);
+        }
+      }
+      if(not stack.empty()) {
+        stack.back().nestedWall_ += wall;
+        stack.back().nestedCpu_ += cpu;
+      }
+    }
+
+    void ModuleLatency::postEndJob() {
+      if(useJobReport_) {
+        Service<JobReport> reportSvc;
+        for(auto const& labelAndHistograms : labelToHistograms_) {
+          std::map<std::string, std::string> reportData;
+          for(unsigned int t = 0; t != kNTransitions; ++t) {
+            Histograms const& histograms = labelAndHistograms.second->transitions_[t];
+            if(histograms.wall_.count() == 0) {
+              continue;
+            }
+            std::string const transition(kTransitionNames[t]);
+            std::ostringstream count;
+            count << histograms.wall_.count();
+            reportData.insert(std::make_pair(transition + "Count", count.str()));
+            reportData.insert(std::make_pair(transition + "WallP50", toSeconds(histograms.wall_.quantile(0.5))));
+            reportData.insert(std::make_pair(transition + "WallP99", toSeconds(histograms.wall_.quantile(0.99))));
+            reportData.insert(std::make_pair(transition + "WallMax", toSeconds(histograms.wall_.max())));
+            if(measureCPUTime_) {
+              reportData.insert(std::make_pair(transition + "CPUP50", toSeconds(histograms.cpu_.quantile(0.5))));
+              reportData.insert(std::make_pair(transition + "CPUP99", toSeconds(histograms.cpu_.quantile(0.99))));
+              reportData.insert(std::make_pair(transition + "CPUMax", toSeconds(histograms.cpu_.max())));
+            }
+          }
+          if(not reportData.empty()) {
+            reportSvc->reportPerformanceForModule("ModuleLatency", labelAndHistograms.first, reportData);
+          }
+        }
+      }
+      if(not fileName_.empty()) {
+        writeFile();
+      }
+    }
+
+    void ModuleLatency::writeFile() const {
+      std::ofstream file(fileName_.c_str());
+      if(not file) {
+        LogError("ModuleLatency") << "Unable to open the file '" << fileName_ << "' to write the module latencies to.";
+        return;
+      }
+      //times are in seconds
+      file << "{\n  \"modules\": [";
+      bool firstModule = true;
+      for(auto const& labelAndHistograms : labelToHistograms_) {
+        file << (firstModule ? "\n" : ",\n")
+             << "    {\"label\": \"" << labelAndHistograms.first
+             << "\", \"type\": \"" << labelAndHistograms.second->moduleName_ << "\", \"transitions\": {";
+        firstModule = false;
+        bool firstTransition = true;
+        for(unsigned int t = 0; t != kNTransitions; ++t) {
+          Histograms const& histograms = labelAndHistograms.second->transitions_[t];
+          if(histograms.wall_.count() == 0) {
+            continue;
+          }
+          file << (firstTransition ? "\n" : ",\n")
+               << "      \"" << kTransitionNames[t] << "\": {\"count\": " << histograms.wall_.count();
+          firstTransition = false;
+          LatencyHistogram const* kinds[] = {&histograms.wall_, &histograms.cpu_};
+          char const* const kindNames[] = {"wall", "cpu"};
+          for(unsigned int k = 0, nKinds = measureCPUTime_ ? 2 : 1; k != nKinds; ++k) {
+            file << ", \"" << kindNames[k] << "\": {"
+                 << "\"mean\": " << kinds[k]->mean() * 1E-9
+                 << ", \"p50\": " << toSeconds(kinds[k]->quantile(0.5))
+                 << ", \"p99\": " << toSeconds(kinds[k]->quantile(0.99))
+                 << ", \"max\": " << toSeconds(kinds[k]->max()) << "}";
+          }
+          file << "}";
+        }
+        file << (firstTransition ? "}}" : "\n    }}");
+      }
+      file << "\n  ]\n}\n";
+    }
+  }
+}
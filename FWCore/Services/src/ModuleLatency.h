@@ -0,0 +1,126 @@
+#ifndef Services_ModuleLatency_h
+#define Services_ModuleLatency_h
+// -*- C++ -*-
+//
+// Package:     Services
+// Class  :     ModuleLatency
+//
+/**\class ModuleLatency ModuleLatency.h FWCore/Services/src/ModuleLatency.h
+
+ Description: Keeps histograms of the wall clock and, optionally, CPU time each module takes for each transition
+
+ Usage:
+    The histograms are filled without taking a lock so the service is cheap enough to leave
+    on in production jobs, also when modules are run concurrently. Times are exclusive: the
+    time spent running other modules from within a module, e.g. unscheduled producers, is
+    not counted for the module. If 'measureCPUTime' is set, the CPU time of the thread
+    running the module is histogrammed as well. Reading it needs a system call at the
+    start and the end of every module, so it is off by default.
+
+    At the end of the job the count, mean, median, 99th percentile and maximum for every
+    module and transition are written to the JobReport and, if 'fileName' is not empty,
+    to a JSON file. 'fileName' is empty by default since the child processes of a forked
+    job would all write the same file; the JobReport of each child is kept apart.
+    Modules with the same label in a SubProcess share their histograms.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <atomic>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// user include files
+
+// forward declarations
+namespace edm {
+  class ActivityRegistry;
+  class ConfigurationDescriptions;
+  class ModuleDescription;
+  class ParameterSet;
+
+  namespace service {
+    ///latency histogram with buckets growing by a factor of two, each split in four
+    class LatencyHistogram {
+    public:
+      LatencyHistogram();
+
+      // ---------- const member functions ---------------------
+      unsigned long long count() const { return count_; }
+      unsigned long long max() const { return max_; }
+      double mean() const;
+      ///an upper bound on the iFraction quantile, in nanoseconds
+      unsigned long long quantile(double iFraction) const;
+
+      // ---------- member functions ---------------------------
+      void fill(unsigned long long iNanoseconds);
+
+    private:
+      static unsigned int const kSubBucketBits = 2;
+      static unsigned int const kSubBuckets = 1 << kSubBucketBits;
+      //longer times are put into the last bucket, about 18 minutes
+      static unsigned int const kMaxBits = 40;
+      static unsigned int const kNBuckets = (kMaxBits - kSubBucketBits + 1) * kSubBuckets;
+
+      static unsigned int bucket(unsigned long long iNanoseconds);
+      static unsigned long long upperEdge(unsigned int iBucket);
+
+      // ---------- member data --------------------------------
+      std::atomic<unsigned int> buckets_[kNBuckets];
+      std::atomic<unsigned long long> count_;
+      std::atomic<unsigned long long> sum_;
+      std::atomic<unsigned long long> max_;
+    };
+
+    class ModuleLatency {
+    public:
+      enum Transition { kEvent, kBeginRun, kEndRun, kBeginLumi, kEndLumi, kNTransitions };
+
+      ModuleLatency(ParameterSet const&, ActivityRegistry&);
+      ~ModuleLatency();
+
+      static void fillDescriptions(ConfigurationDescriptions& descriptions);
+
+    private:
+      struct Histograms {
+        LatencyHistogram wall_;
+        LatencyHistogram cpu_;
+      };
+      struct ModuleHistograms {
+        explicit ModuleHistograms(std::string const& iModuleName) : moduleName_(iModuleName) {}
+        std::string moduleName_;
+        Histograms transitions_[kNTransitions];
+      };
+
+      void preModuleConstruction(ModuleDescription const&);
+      void postEndJob();
+
+      template <Transition T> void preModule(ModuleDescription const&);
+      template <Transition T> void postModule(ModuleDescription const&);
+      void start(ModuleDescription const&, Transition);
+      void stop();
+
+      void writeFile() const;
+
+      std::string fileName_;
+      bool useJobReport_;
+      bool measureCPUTime_;
+      //only changed while modules are constructed, so can be read without a lock
+      std::map<std::string, std::unique_ptr<ModuleHistograms> > labelToHistograms_;
+      //indexed by ModuleDescription::id(), points into labelToHistograms_
+      std::vector<ModuleHistograms*> idToHistograms_;
+    };
+
+    inline
+    bool isProcessWideService(ModuleLatency const*) {
+      return true;
+    }
+  }
+}
+
+#endif
@@ -115,6 +115,7 @@ Tracer::Tracer(ParameterSet const& iPS, ActivityRegistry&iRegistry) :
    iRegistry.watchPreSourceLumi(this, &Tracer::preSourceLumi);
    iRegistry.watchPostSourceLumi(this, &Tracer::postSourceLumi);
 
+   iRegistry.watchThreadUtilisation(this, &Tracer::threadUtilisation);
 }
 
 // Tracer::Tracer(Tracer const& rhs)
@@ -159,6 +160,11 @@ Tracer::postEndJob() {
    std::cout << indention_ << " Job ended" << std::endl;
 }
 
+void
+Tracer::threadUtilisation(unsigned int iThread, double iBusySeconds, double iWallSeconds) {
+   std::cout << indention_ << " thread " << iThread << " busy " << iBusySeconds << "s of " << iWallSeconds << "s" << std::endl;
+}
+
 void
 Tracer::preSourceEvent() {
   std::cout << indention_ << indention_ << "source event" << std::endl;
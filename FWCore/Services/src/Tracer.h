@@ -114,6 +114,8 @@ public:
          void prePathEndRun(std::string const& s);
          void postPathEndRun(std::string const& s, HLTPathStatus const& hlt);
 
+         void threadUtilisation(unsigned int iThread, double iBusySeconds, double iWallSeconds);
+
 private:
          std::string indention_;
          unsigned int depth_;
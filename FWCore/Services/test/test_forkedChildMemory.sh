@@ -0,0 +1,15 @@
+#!/bin/bash
+
+# Pass in name and status
+function die { echo $1: status $2 ;  exit $2; }
+
+F1=${LOCAL_TEST_DIR}/test_forkedChildMemory_cfg.py
+
+rm -f forkedChildMemory*.xml
+(cmsRun -j forkedChildMemory.xml $F1 ) || die "Failure using $F1" $?
+# each child writes its own job report
+for child in forkedChildMemory_0.xml forkedChildMemory_1.xml; do
+  grep -q '<PerformanceSummary Metric="ForkedChildMemory">' $child || die "No ForkedChildMemory summary in $child" 1
+  grep -q '<Metric Name="SharedAfterFork"' $child || die "No shared memory after the fork in $child" 1
+  grep -q '<Metric Name="PssAtEnd"' $child || die "No PSS at the end of the job in $child" 1
+done
@@ -0,0 +1,18 @@
+import FWCore.ParameterSet.Config as cms
+process = cms.Process("TEST")
+
+process.source = cms.Source("EmptySource")
+
+process.options = cms.untracked.PSet(multiProcesses=cms.untracked.PSet(
+        maxChildProcesses=cms.untracked.int32(2),
+        maxSequentialEventsPerChild=cms.untracked.uint32(2),
+        trimHeapBeforeFork=cms.untracked.bool(True)))
+
+process.add_(cms.Service("SimpleMemoryCheck",
+                         monitorPssAndPrivate = cms.untracked.bool(True)))
+
+process.thing = cms.EDProducer("ThingProducer")
+
+process.maxEvents = cms.untracked.PSet(input = cms.untracked.int32(20))
+
+process.p = cms.Path(process.thing)
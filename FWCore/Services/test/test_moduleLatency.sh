@@ -0,0 +1,12 @@
+#!/bin/bash
+
+# Pass in name and status
+function die { echo $1: status $2 ;  exit $2; }
+
+F1=${LOCAL_TEST_DIR}/test_moduleLatency_cfg.py
+
+rm -f moduleLatency_test.json
+(cmsRun $F1 ) || die "Failure using $F1" $?
+grep -q '"label": "print2"' moduleLatency_test.json || die "No latencies for print2 in moduleLatency_test.json" 1
+grep -q '"Event": {"count": 20' moduleLatency_test.json || die "Wrong event count in moduleLatency_test.json" 1
+grep -q '"cpu": {' moduleLatency_test.json || die "No CPU times in moduleLatency_test.json" 1
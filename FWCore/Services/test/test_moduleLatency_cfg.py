@@ -0,0 +1,24 @@
+# Configuration file for the ModuleLatency service
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TEST")
+
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.ModuleLatency = cms.Service("ModuleLatency",
+    fileName = cms.untracked.string("moduleLatency_test.json"),
+    measureCPUTime = cms.untracked.bool(True)
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(20)
+)
+
+process.source = cms.Source("EmptySource")
+
+process.print1 = cms.OutputModule("AsciiOutputModule")
+
+process.print2 = cms.OutputModule("AsciiOutputModule")
+
+process.p = cms.EndPath(process.print1*process.print2)
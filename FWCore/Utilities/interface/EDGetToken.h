@@ -0,0 +1,77 @@
+#ifndef FWCore_Utilities_EDGetToken_h
+#define FWCore_Utilities_EDGetToken_h
+// -*- C++ -*-
+//
+// Package:     FWCore/Utilities
+// Class  :     EDGetToken
+//
+/**\class EDGetToken EDGetToken.h "FWCore/Utilities/interface/EDGetToken.h"
+
+ Description: A handle to a product a module said it reads
+
+ Usage:
+    A module gets an EDGetTokenT<T> by calling 'consumes<T>' with an InputTag in its
+ constructor and passes it to Event::getByToken. The framework finds the product for
+ the token once instead of looking the labels up for every event.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+
+// user include files
+
+// forward declarations
+namespace edm {
+  class EDConsumerBase;
+  template <typename T> class EDGetTokenT;
+
+  class EDGetToken
+  {
+    friend class EDConsumerBase;
+
+  public:
+    EDGetToken() : m_value(s_uninitializedValue) {}
+
+    template<typename T>
+    EDGetToken(EDGetTokenT<T> iOther) : m_value(iOther.m_value) {}
+
+    // ---------- const member functions ---------------------
+    unsigned int index() const { return m_value; }
+    bool isUninitialized() const { return m_value == s_uninitializedValue; }
+
+  private:
+    static const unsigned int s_uninitializedValue = 0xFFFFFFFF;
+
+    explicit EDGetToken(unsigned int iValue) : m_value(iValue) {}
+
+    // ---------- member data --------------------------------
+    unsigned int m_value;
+  };
+
+  template<typename T>
+  class EDGetTokenT
+  {
+    friend class EDConsumerBase;
+    friend class EDGetToken;
+
+  public:
+    EDGetTokenT() : m_value(s_uninitializedValue) {}
+
+    // ---------- const member functions ---------------------
+    unsigned int index() const { return m_value; }
+    bool isUninitialized() const { return m_value == s_uninitializedValue; }
+
+  private:
+    static const unsigned int s_uninitializedValue = 0xFFFFFFFF;
+
+    explicit EDGetTokenT(unsigned int iValue) : m_value(iValue) {}
+
+    // ---------- member data --------------------------------
+    unsigned int m_value;
+  };
+}
+
+#endif
@@ -7,9 +7,16 @@
 // can be removed.  -LSK
 //class boost::mutex;
 #include "boost/thread/mutex.hpp"
+#include "boost/thread/recursive_mutex.hpp"
 namespace edm {
   namespace rootfix {
     boost::mutex* getGlobalMutex();
+
+    // Held by the framework while the input source or a DelayedReader reads
+    // and while an output module writes, since these share ROOT's global
+    // state and may run on different threads. It is recursive because
+    // writing an event reads the products it has not read yet.
+    boost::recursive_mutex* getIOMutex();
   }
 }
 #endif
@@ -0,0 +1,82 @@
+#ifndef FWCore_Utilities_SharedMemoryArena_h
+#define FWCore_Utilities_SharedMemoryArena_h
+// -*- C++ -*-
+//
+// Package:     Utilities
+// Class  :     SharedMemoryArena
+//
+/**\class SharedMemoryArena SharedMemoryArena.h FWCore/Utilities/interface/SharedMemoryArena.h
+
+ Description: Memory shared by a process and the children it forks, holding data made only once
+
+ Usage:
+    The arena is created before forking and is then mapped at the same address in every
+ child. Data is published under a key
+ \code
+    void const* p = arena.findOrMake(key, sizeof(Calibration), [](void* iBuffer) { new(iBuffer) Calibration(...); });
+ \endcode
+ The first process to ask for a key calls the function to fill the memory. Processes asking
+ for the same key meanwhile wait until the memory is filled and then all share it. Nothing
+ is ever removed. The data must not hold pointers to memory outside of the arena.
+
+    findOrMake returns 0 if the arena is full or if the process filling the memory failed.
+ The caller then has to make the data itself.
+
+    Once a process calls makeFilledReadOnly, e.g. a child right after the fork, the data
+ which is filled is read-only in that process, so writing to it by mistake crashes the
+ process instead of silently changing what the other processes see.
+
+*/
+//
+// $Id$
+//
+
+// system include files
+#include <cstddef>
+#include <functional>
+#include <string>
+
+#include "boost/utility.hpp"
+
+// user include files
+
+// forward declarations
+namespace edm {
+  class SharedMemoryArena : private boost::noncopyable {
+  public:
+    ///throws if iBytes of shared memory can not be mapped
+    explicit SharedMemoryArena(std::size_t iBytes);
+    ~SharedMemoryArena();
+
+    // ---------- const member functions ---------------------
+    std::size_t size() const { return size_; }
+    std::size_t bytesUsed() const;
+    ///true if iData points into the arena
+    bool contains(void const* iData) const;
+
+    // ---------- static member functions --------------------
+    ///the arena shared with the forked children, 0 unless a forking job asked for one
+    static SharedMemoryArena* forkShared();
+    static void setForkShared(SharedMemoryArena* iArena);
+
+    // ---------- member functions ---------------------------
+    void const* findOrMake(std::string const& iKey, std::size_t iBytes, std::function<void(void*)> const& iFill);
+
+    ///protects the pages holding only filled data, now and whenever more data is filled
+    void makeFilledReadOnly();
+
+  private:
+    struct Header;
+
+    ///must be called holding the lock
+    void protectFilled();
+
+    // ---------- member data --------------------------------
+    Header* header_;
+    std::size_t size_;
+    //offset up to which the memory is read-only in this process, 0 if nothing is protected
+    std::size_t readOnlyUpTo_;
+  };
+}
+
+#endif
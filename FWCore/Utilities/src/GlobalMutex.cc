@@ -4,3 +4,8 @@ boost::mutex* edm::rootfix::getGlobalMutex() {
     static boost::mutex m_;
     return &m_;
 }
+
+boost::recursive_mutex* edm::rootfix::getIOMutex() {
+    static boost::recursive_mutex m_;
+    return &m_;
+}
@@ -0,0 +1,242 @@
+// -*- C++ -*-
+//
+// Package:     Utilities
+// Class  :     SharedMemoryArena
+//
+// Implementation:
+//     The arena starts with a Header holding a process-shared mutex and condition and a
+//     table of the published entries. The keys and the data follow the Header, allocated
+//     by moving 'used_' forward. A process which dies while filling an entry is noticed by
+//     the processes waiting for it, which then give up on the entry.
+//     The Header takes whole pages so the data after it can be made read-only. As memory
+//     is only ever added at the end, the pages before the first entry still being filled
+//     are never written again.
+//
+// $Id$
+//
+
+// system include files
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <pthread.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+// user include files
+#include "FWCore/Utilities/interface/SharedMemoryArena.h"
+#include "FWCore/Utilities/interface/Exception.h"
+
+namespace edm {
+  namespace {
+    unsigned int const kMaxEntries = 4096;
+    std::size_t const kAlignment = 64;
+
+    std::size_t aligned(std::size_t iBytes) {
+      return (iBytes + kAlignment - 1) & ~(kAlignment - 1);
+    }
+
+    std::size_t pageSize() {
+      static std::size_t const s_pageSize = sysconf(_SC_PAGESIZE);
+      return s_pageSize;
+    }
+
+    std::size_t pageAligned(std::size_t iBytes) {
+      return (iBytes + pageSize() - 1) & ~(pageSize() - 1);
+    }
+
+    enum EntryState { kFilling, kFilled, kFailed };
+
+    struct Entry {
+      std::size_t hash_;
+      std::size_t keyOffset_;
+      std::size_t keySize_;
+      std::size_t dataOffset_;
+      pid_t filler_;
+      EntryState state_;
+    };
+
+    SharedMemoryArena* s_forkShared = 0;
+  }
+
+  struct SharedMemoryArena::Header {
+    pthread_mutex_t mutex_;
+    pthread_cond_t changed_;
+    std::size_t used_;
+    unsigned int nEntries_;
+    Entry entries_[kMaxEntries];
+  };
+
+  namespace {
+    //a process which died while holding the lock can not have changed the table half way
+    // since it only holds the lock while looking entries up or adding them
+    void lock(pthread_mutex_t* iMutex) {
+      if(pthread_mutex_lock(iMutex) == EOWNERDEAD) {
+        pthread_mutex_consistent(iMutex);
+      }
+    }
+
+    class Sentry {
+    public:
+      explicit Sentry(pthread_mutex_t* iMutex) : mutex_(iMutex) { lock(mutex_); }
+      ~Sentry() { pthread_mutex_unlock(mutex_); }
+    private:
+      pthread_mutex_t* mutex_;
+    };
+  }
+
+  SharedMemoryArena::SharedMemoryArena(std::size_t iBytes) :
+    header_(0),
+    size_(pageAligned(sizeof(Header)) + aligned(iBytes)),
+    readOnlyUpTo_(0) {
+    void* memory = mmap(0, size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if(memory == MAP_FAILED) {
+      throw cms::Exception("SharedMemoryArena") << "Could not map " << size_ << " bytes of shared memory, errno " << errno
+                                                << " " << strerror(errno);
+    }
+    header_ = static_cast<Header*>(memory);
+    header_->used_ = pageAligned(sizeof(Header));
+    header_->nEntries_ = 0;
+
+    pthread_mutexattr_t mutexAttributes;
+    pthread_mutexattr_init(&mutexAttributes);
+    pthread_mutexattr_setpshared(&mutexAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_mutexattr_setrobust(&mutexAttributes, PTHREAD_MUTEX_ROBUST);
+    pthread_mutex_init(&header_->mutex_, &mutexAttributes);
+    pthread_mutexattr_destroy(&mutexAttributes);
+
+    pthread_condattr_t condAttributes;
+    pthread_condattr_init(&condAttributes);
+    pthread_condattr_setpshared(&condAttributes, PTHREAD_PROCESS_SHARED);
+    pthread_cond_init(&header_->changed_, &condAttributes);
+    pthread_condattr_destroy(&condAttributes);
+  }
+
+  SharedMemoryArena::~SharedMemoryArena() {
+    if(s_forkShared == this) {
+      s_forkShared = 0;
+    }
+    munmap(header_, size_);
+  }
+
+  SharedMemoryArena*
+  SharedMemoryArena::forkShared() {
+    return s_forkShared;
+  }
+
+  void
+  SharedMemoryArena::setForkShared(SharedMemoryArena* iArena) {
+    s_forkShared = iArena;
+  }
+
+  void
+  SharedMemoryArena::makeFilledReadOnly() {
+    Sentry sentry(&header_->mutex_);
+    if(readOnlyUpTo_ == 0) {
+      readOnlyUpTo_ = pageAligned(sizeof(Header));
+    }
+    protectFilled();
+  }
+
+  void
+  SharedMemoryArena::protectFilled() {
+    if(readOnlyUpTo_ == 0) {
+      return;
+    }
+    //the entries are in the order of their memory
+    std::size_t filledUpTo = header_->used_;
+    for(unsigned int i = 0; i != header_->nEntries_; ++i) {
+      if(header_->entries_[i].state_ == kFilling) {
+        filledUpTo = header_->entries_[i].keyOffset_;
+        break;
+      }
+    }
+    filledUpTo &= ~(pageSize() - 1);
+    if(filledUpTo > readOnlyUpTo_) {
+      char* const base = reinterpret_cast<char*>(header_);
+      if(0 == mprotect(base + readOnlyUpTo_, filledUpTo - readOnlyUpTo_, PROT_READ)) {
+        readOnlyUpTo_ = filledUpTo;
+      }
+    }
+  }
+
+  std::size_t
+  SharedMemoryArena::bytesUsed() const {
+    Sentry sentry(&header_->mutex_);
+    return header_->used_;
+  }
+
+  bool
+  SharedMemoryArena::contains(void const* iData) const {
+    char const* const base = reinterpret_cast<char const*>(header_);
+    char const* const data = static_cast<char const*>(iData);
+    return data >= base && data < base + size_;
+  }
+
+  void const*
+  SharedMemoryArena::findOrMake(std::string const& iKey, std::size_t iBytes, std::function<void(void*)> const& iFill) {
+    char* const base = reinterpret_cast<char*>(header_);
+    std::size_t const hash = std::hash<std::string>()(iKey);
+    Entry* entry = 0;
+    {
+      Sentry sentry(&header_->mutex_);
+      for(unsigned int i = 0; i != header_->nEntries_; ++i) {
+        Entry& candidate = header_->entries_[i];
+        if(candidate.hash_ == hash && candidate.keySize_ == iKey.size() &&
+           0 == iKey.compare(0, iKey.size(), base + candidate.keyOffset_, candidate.keySize_)) {
+          entry = &candidate;
+          break;
+        }
+      }
+      if(entry != 0) {
+        while(entry->state_ == kFilling) {
+          //wake up now and then to see if the process filling the entry is still there
+          timespec until;
+          clock_gettime(CLOCK_REALTIME, &until);
+          until.tv_sec += 1;
+          if(pthread_cond_timedwait(&header_->changed_, &header_->mutex_, &until) == EOWNERDEAD) {
+            pthread_mutex_consistent(&header_->mutex_);
+          }
+          if(entry->state_ == kFilling && kill(entry->filler_, 0) != 0 && errno == ESRCH) {
+            entry->state_ = kFailed;
+          }
+        }
+        protectFilled();
+        return entry->state_ == kFilled ? base + entry->dataOffset_ : 0;
+      }
+
+      std::size_t const needed = aligned(iKey.size()) + aligned(iBytes);
+      if(header_->nEntries_ == kMaxEntries || header_->used_ + needed > size_) {
+        return 0;
+      }
+      entry = &header_->entries_[header_->nEntries_++];
+      entry->hash_ = hash;
+      entry->keyOffset_ = header_->used_;
+      entry->keySize_ = iKey.size();
+      entry->dataOffset_ = header_->used_ + aligned(iKey.size());
+      entry->filler_ = getpid();
+      entry->state_ = kFilling;
+      std::memcpy(base + entry->keyOffset_, iKey.data(), iKey.size());
+      header_->used_ += needed;
+    }
+
+    //the lock is not held while filling so other keys can be found and made meanwhile
+    EntryState state = kFailed;
+    try {
+      iFill(base + entry->dataOffset_);
+      state = kFilled;
+    } catch(...) {
+      Sentry sentry(&header_->mutex_);
+      entry->state_ = state;
+      pthread_cond_broadcast(&header_->changed_);
+      protectFilled();
+      throw;
+    }
+    Sentry sentry(&header_->mutex_);
+    entry->state_ = state;
+    pthread_cond_broadcast(&header_->changed_);
+    protectFilled();
+    return base + entry->dataOffset_;
+  }
+}
@@ -0,0 +1,112 @@
+// Several forked processes ask the arena for the same keys. Each key must be filled once
+// and every process must see the data that was filled.
+// $Id$
+
+#include "FWCore/Utilities/interface/SharedMemoryArena.h"
+
+#include <atomic>
+#include <cassert>
+#include <iostream>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace {
+  unsigned int const kNChildren = 4;
+  unsigned int const kNKeys = 20;
+  unsigned int const kNValues = 1000;
+
+  struct Payload {
+    unsigned int key_;
+    unsigned int values_[kNValues];
+  };
+
+  bool useArena(edm::SharedMemoryArena& iArena, std::atomic<unsigned int>& iFills, std::atomic<unsigned int>& iFailedFills) {
+    for(unsigned int key = 0; key != kNKeys; ++key) {
+      void const* data = iArena.findOrMake("key" + std::to_string(key), sizeof(Payload), [&iFills, key](void* iBuffer) {
+        ++iFills;
+        Payload* payload = new(iBuffer) Payload;
+        payload->key_ = key;
+        for(unsigned int i = 0; i != kNValues; ++i) {
+          payload->values_[i] = key + i;
+        }
+        usleep(1000);
+      });
+      if(data == 0) return false;
+      Payload const* payload = static_cast<Payload const*>(data);
+      if(payload->key_ != key || payload->values_[kNValues - 1] != key + kNValues - 1) return false;
+    }
+
+    //the process which fills the key fails, the others must not wait for ever
+    try {
+      void const* data = iArena.findOrMake("failing", sizeof(Payload), [&iFailedFills](void*) {
+        ++iFailedFills;
+        throw std::runtime_error("failed to fill");
+      });
+      if(data != 0) return false;
+    } catch(std::runtime_error const&) {
+    }
+    return true;
+  }
+}
+
+int main() {
+  edm::SharedMemoryArena arena((kNKeys + 3) * (sizeof(Payload) + 128));
+
+  //the counters are themselves kept in the arena so the children can update them
+  std::atomic<unsigned int>* fills = static_cast<std::atomic<unsigned int>*>(const_cast<void*>(
+    arena.findOrMake("fills", sizeof(std::atomic<unsigned int>), [](void* iBuffer) { new(iBuffer) std::atomic<unsigned int>(0); })));
+  std::atomic<unsigned int>* failedFills = static_cast<std::atomic<unsigned int>*>(const_cast<void*>(
+    arena.findOrMake("failedFills", sizeof(std::atomic<unsigned int>), [](void* iBuffer) { new(iBuffer) std::atomic<unsigned int>(0); })));
+  assert(fills != 0 && failedFills != 0);
+  assert(arena.contains(fills) && !arena.contains(&arena));
+
+  std::vector<pid_t> children;
+  for(unsigned int i = 0; i != kNChildren; ++i) {
+    pid_t pid = fork();
+    assert(pid >= 0);
+    if(pid == 0) {
+      _exit(useArena(arena, *fills, *failedFills) ? 0 : 1);
+    }
+    children.push_back(pid);
+  }
+  bool childrenSucceeded = true;
+  for(auto pid : children) {
+    int status = 0;
+    waitpid(pid, &status, 0);
+    childrenSucceeded = childrenSucceeded && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+  }
+  assert(childrenSucceeded);
+  assert(*fills == kNKeys);
+  assert(*failedFills == 1);
+
+  //once made read-only, a process crashes when it writes to the filled data but can still add more
+  pid_t pid = fork();
+  assert(pid >= 0);
+  if(pid == 0) {
+    arena.makeFilledReadOnly();
+    void const* data = arena.findOrMake("afterReadOnly", sizeof(Payload), [](void* iBuffer) { new(iBuffer) Payload(); });
+    if(data == 0 || static_cast<Payload const*>(data)->key_ != 0) _exit(1);
+    data = arena.findOrMake("key0", sizeof(Payload), [](void*) { assert(false); });
+    const_cast<Payload*>(static_cast<Payload const*>(data))->key_ = 1;
+    _exit(0);
+  }
+  int status = 0;
+  waitpid(pid, &status, 0);
+  assert(WIFSIGNALED(status) && WTERMSIG(status) == SIGSEGV);
+
+  //the parent finds what the children made
+  assert(useArena(arena, *fills, *failedFills));
+  assert(*fills == kNKeys);
+
+  //a full arena does not make anything
+  assert(0 == arena.findOrMake("tooLarge", arena.size(), [](void*) { assert(false); }));
+
+  std::cout << "SharedMemoryArena used " << arena.bytesUsed() << " of " << arena.size() << " bytes" << std::endl;
+  return 0;
+}
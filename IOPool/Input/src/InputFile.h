@@ -44,6 +44,8 @@ namespace edm {
     TObject* Get(char const* name) {return file_->Get(name);}
     TFileCacheRead* GetCacheRead() const {return file_->GetCacheRead();}
     void SetCacheRead(TFileCacheRead* tfcr) {file_->SetCacheRead(tfcr, NULL, TFile::kDoNotDisconnect);}
+    bool ReadBufferAsync(Long64_t offset, Int_t len) {return file_->ReadBufferAsync(offset, len);}
+    std::string const& fileName() const {return fileName_;}
     void logFileAction(char const* msg, char const* fileName) const;
   private:
     std::unique_ptr<TFile> file_;
@@ -0,0 +1,45 @@
+/*----------------------------------------------------------------------
+----------------------------------------------------------------------*/
+
+#include "ProductRecycler.h"
+
+#include "TClass.h"
+
+namespace edm {
+
+  void
+  ProductRecycler::Recycle::operator()(void const* wrapper) const {
+    recycler_->put(const_cast<void*>(wrapper));
+  }
+
+  ProductRecycler::ProductRecycler(TClass* wrapperClass) :
+    wrapperClass_(wrapperClass),
+    mutex_(),
+    wrappers_() {
+  }
+
+  ProductRecycler::~ProductRecycler() {
+    for(auto wrapper : wrappers_) {
+      wrapperClass_->Destructor(wrapper);
+    }
+  }
+
+  void*
+  ProductRecycler::get() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      if(!wrappers_.empty()) {
+        void* wrapper = wrappers_.back();
+        wrappers_.pop_back();
+        return wrapper;
+      }
+    }
+    return wrapperClass_->New();
+  }
+
+  void
+  ProductRecycler::put(void* wrapper) {
+    std::lock_guard<std::mutex> guard(mutex_);
+    wrappers_.push_back(wrapper);
+  }
+}
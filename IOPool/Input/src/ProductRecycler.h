@@ -0,0 +1,52 @@
+#ifndef IOPool_Input_ProductRecycler_h
+#define IOPool_Input_ProductRecycler_h
+
+/*----------------------------------------------------------------------
+
+ProductRecycler.h // used by ROOT input sources
+
+Keeps the wrappers of one branch which are no longer used by any event
+so the next event can be read into them instead of into new ones. Reading
+into a wrapper overwrites what was read before while ROOT keeps the
+capacity of the collections, so a job in a steady state does not allocate
+the products again. Members which are not read are not reset, so this may
+only be used for branches whose products do not have such state.
+
+----------------------------------------------------------------------*/
+
+#include "boost/shared_ptr.hpp"
+
+#include <mutex>
+#include <vector>
+
+class TClass;
+
+namespace edm {
+
+  class ProductRecycler {
+  public:
+    // Hands a wrapper back to its ProductRecycler instead of deleting it.
+    struct Recycle {
+      explicit Recycle(boost::shared_ptr<ProductRecycler> const& recycler) : recycler_(recycler) {}
+      void operator()(void const* wrapper) const;
+      boost::shared_ptr<ProductRecycler> recycler_;
+    };
+
+    explicit ProductRecycler(TClass* wrapperClass);
+    ~ProductRecycler();
+
+    ProductRecycler(ProductRecycler const&) = delete; // Disallow copying and moving
+    ProductRecycler& operator=(ProductRecycler const&) = delete; // Disallow copying and moving
+
+    // A wrapper from a previous event, or a new one if there is none.
+    void* get();
+
+    void put(void* wrapper);
+
+  private:
+    TClass* wrapperClass_;
+    std::mutex mutex_;
+    std::vector<void*> wrappers_;
+  }; // class ProductRecycler
+}
+#endif
@@ -3,6 +3,7 @@
 
 #include "RootDelayedReader.h"
 #include "InputFile.h"
+#include "ProductRecycler.h"
 #include "DataFormats/Common/interface/WrapperOwningHolder.h"
 #include "DataFormats/Common/interface/RefCoreStreamer.h"
 
@@ -48,13 +49,16 @@ namespace edm {
       branchInfo.classCache_ = gROOT->GetClass(branchInfo.branchDescription_.wrappedName().c_str());
       cp = branchInfo.classCache_;
     }
-    void* p = cp->New();
+    void* p = (branchInfo.recycler_ ? branchInfo.recycler_->get() : cp->New());
     br->SetAddress(&p);
     tree_.getEntry(br, entryNumber());
     if(tree_.branchType() == InEvent) {
       InputFile::reportReadBranch(std::string(br->GetName()));
     }
     setRefCoreStreamer(false);
+    if(branchInfo.recycler_) {
+      return WrapperOwningHolder(boost::shared_ptr<void const>(p, ProductRecycler::Recycle(branchInfo.recycler_)), interface);
+    }
     WrapperOwningHolder edp(p, interface);
     return edp;
   }
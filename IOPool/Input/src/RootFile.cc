@@ -133,6 +133,7 @@ namespace edm {
                      RunNumber_t const& forcedRunNumber,
                      bool noEventSort,
                      ProductSelectorRules const& productSelectorRules,
+                     ProductSelectorRules const& recycleSelectorRules,
                      InputType::InputType inputType,
                      boost::shared_ptr<BranchIDListHelper> branchIDListHelper,
                      boost::shared_ptr<DuplicateChecker> duplicateChecker,
@@ -142,7 +143,9 @@ namespace edm {
                      std::vector<ProcessHistoryID>& orderedProcessHistoryIDs,
                      bool labelRawDataLikeMC,
                      bool usingGoToEvent,
-                     bool enablePrefetching) :
+                     bool enablePrefetching,
+                     unsigned int basketReadAheadSize,
+                     bool parallelUnzip) :
       file_(fileName),
       logicalFile_(logicalFileName),
       processConfiguration_(processConfiguration),
@@ -166,9 +169,9 @@ namespace edm {
       hasNewlyDroppedBranch_(),
       branchListIndexesUnchanged_(false),
       eventAux_(),
-      eventTree_(filePtr_, InEvent, treeMaxVirtualSize, treeCacheSize, roottree::defaultLearningEntries, enablePrefetching),
-      lumiTree_(filePtr_, InLumi, treeMaxVirtualSize, roottree::defaultNonEventCacheSize, roottree::defaultNonEventLearningEntries, enablePrefetching),
-      runTree_(filePtr_, InRun, treeMaxVirtualSize, roottree::defaultNonEventCacheSize, roottree::defaultNonEventLearningEntries, enablePrefetching),
+      eventTree_(filePtr_, InEvent, treeMaxVirtualSize, treeCacheSize, roottree::defaultLearningEntries, enablePrefetching, parallelUnzip),
+      lumiTree_(filePtr_, InLumi, treeMaxVirtualSize, roottree::defaultNonEventCacheSize, roottree::defaultNonEventLearningEntries, enablePrefetching, false),
+      runTree_(filePtr_, InRun, treeMaxVirtualSize, roottree::defaultNonEventCacheSize, roottree::defaultNonEventLearningEntries, enablePrefetching, false),
       treePointers_(),
       lastEventEntryNumberRead_(-1LL),
       productRegistry_(),
@@ -384,6 +387,9 @@ namespace edm {
     ProcessConfigurationRegistry::instance()->insertCollection(processConfigurations_);
 
     eventTree_.trainCache(BranchTypeToAuxiliaryBranchName(InEvent).c_str());
+    if(basketReadAheadSize != 0U) {
+      eventTree_.enableReadAhead(basketReadAheadSize);
+    }
 
     validateFile(inputType, usingGoToEvent);
 
@@ -443,11 +449,15 @@ namespace edm {
     provenanceReaderMaker_.reset(makeProvenanceReaderMaker().release());
 
     // Set up information from the product registry.
+    // Only event products are recycled, run and lumi products may be merged.
+    ProductSelector recycleSelector;
+    recycleSelector.initialize(recycleSelectorRules, productRegistry()->allBranchDescriptions());
     ProductRegistry::ProductList const& prodList = productRegistry()->productList();
     for(auto const& product : prodList) {
       BranchDescription const& prod = product.second;
       treePointers_[prod.branchType()]->addBranch(product.first, prod,
-                                                  newBranchToOldBranch(prod.branchName()));
+                                                  newBranchToOldBranch(prod.branchName()),
+                                                  prod.branchType() == InEvent && recycleSelector.selected(prod));
     }
 
     // Event Principal cache for secondary input source
@@ -1351,12 +1361,34 @@ namespace edm {
   // the branch containing this EDProduct. That will be done by the Delayed Reader,
   //  when it is asked to do so.
   //
+  // The entry of the first event which will be read after the current one and is not in the
+  // cluster of the current one, or -1 if there is none. The iteration order of IndexIntoFile need
+  // not be the entry order, so the events are looked at in the order they will be read.
+  IndexIntoFile::EntryNumber_t
+  RootFile::nextEventEntryOutsideCluster() const {
+    // Bounds the time spent on a file read in an order very different from the one it was written in.
+    int const maxEventsLookedAt = 10000;
+    IndexIntoFile::IndexIntoFileItr iter(indexIntoFileIter_);
+    for(int i = 0; i != maxEventsLookedAt && iter != indexIntoFileEnd_; ++iter) {
+      if(iter.getEntryType() == IndexIntoFile::kEvent) {
+        if(!eventTree_.inCurrentCluster(iter.entry())) {
+          return iter.entry();
+        }
+        ++i;
+      }
+    }
+    return -1;
+  }
+
   EventPrincipal*
   RootFile::readEvent(EventPrincipal& cache) {
     assert(indexIntoFileIter_ != indexIntoFileEnd_);
     assert(indexIntoFileIter_.getEntryType() == IndexIntoFile::kEvent);
     // Set the entry in the tree, and read the event at that entry.
     eventTree_.setEntryNumber(indexIntoFileIter_.entry());
+    if(eventTree_.readAheadWanted()) {
+      eventTree_.readAhead(nextEventEntryOutsideCluster());
+    }
     EventPrincipal* ep = readCurrentEvent(cache);
 
     assert(ep != nullptr);
@@ -65,6 +65,7 @@ namespace edm {
              RunNumber_t const& forcedRunNumber,
              bool noEventSort,
              ProductSelectorRules const& productSelectorRules,
+             ProductSelectorRules const& recycleSelectorRules,
              InputType::InputType inputType,
              boost::shared_ptr<BranchIDListHelper> branchIDListHelper,
              boost::shared_ptr<DuplicateChecker> duplicateChecker,
@@ -74,7 +75,9 @@ namespace edm {
              std::vector<ProcessHistoryID>& orderedProcessHistoryIDs,
              bool labelRawDataLikeMC,
              bool usingGoToEvent,
-             bool enablePrefetching);
+             bool enablePrefetching,
+             unsigned int basketReadAheadSize,
+             bool parallelUnzip);
     ~RootFile();
 
     RootFile(RootFile const&) = delete; // Disallow copying and moving
@@ -164,6 +167,7 @@ namespace edm {
     void readEntryDescriptionTree();
     void readEventHistoryTree();
     bool isDuplicateEvent();
+    IndexIntoFile::EntryNumber_t nextEventEntryOutsideCluster() const;
 
     void initializeDuplicateChecker(std::vector<boost::shared_ptr<IndexIntoFile> > const& indexesIntoFiles,
                                     std::vector<boost::shared_ptr<IndexIntoFile> >::size_type currentIndexIntoFile);
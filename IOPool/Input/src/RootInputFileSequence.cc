@@ -25,6 +25,16 @@
 #include "TSystem.h"
 
 namespace edm {
+  namespace {
+    // Unlike 'inputCommands', no branch is selected unless asked for.
+    ParameterSet recycleCommands(ParameterSet const& pset) {
+      ParameterSet result;
+      result.addUntrackedParameter("recycleCommands",
+        pset.getUntrackedParameter<std::vector<std::string> >("recycleCommands", std::vector<std::string>(1U, std::string("drop *"))));
+      return result;
+    }
+  }
+
   RootInputFileSequence::RootInputFileSequence(
                 ParameterSet const& pset,
                 PoolSource const& input,
@@ -59,8 +69,11 @@ namespace edm {
     skipBadFiles_(pset.getUntrackedParameter<bool>("skipBadFiles", false)),
     treeCacheSize_(noEventSort_ ? pset.getUntrackedParameter<unsigned int>("cacheSize", roottree::defaultCacheSize) : 0U),
     treeMaxVirtualSize_(pset.getUntrackedParameter<int>("treeMaxVirtualSize", -1)),
+    basketReadAheadSize_(inputType == InputType::Primary ? pset.getUntrackedParameter<unsigned int>("basketReadAheadSize", 0U) : 0U),
+    parallelUnzip_(inputType == InputType::Primary ? pset.getUntrackedParameter<bool>("parallelUnzip", false) : false),
     setRun_(pset.getUntrackedParameter<unsigned int>("setRunNumber", 0U)),
     productSelectorRules_(pset, "inputCommands", "InputSource"),
+    recycleSelectorRules_(recycleCommands(pset), "recycleCommands", "InputSource"),
     duplicateChecker_(inputType == InputType::Primary ? new DuplicateChecker(pset) : 0),
     dropDescendants_(pset.getUntrackedParameter<bool>("dropDescendantsOfDroppedBranches", inputType != InputType::SecondarySource)),
     labelRawDataLikeMC_(pset.getUntrackedParameter<bool>("labelRawDataLikeMC", true)),
@@ -251,6 +264,7 @@ namespace edm {
           setRun_,
           noEventSort_,
           productSelectorRules_,
+          recycleSelectorRules_,
           inputType_,
           (inputType_ == InputType::SecondarySource ?  boost::shared_ptr<BranchIDListHelper>(new BranchIDListHelper()) :  input_.branchIDListHelper()),
           duplicateChecker_,
@@ -260,7 +274,9 @@ namespace edm {
           orderedProcessHistoryIDs_,
           labelRawDataLikeMC_,
           usingGoToEvent_,
-          enablePrefetching_));
+          enablePrefetching_,
+          basketReadAheadSize_,
+          parallelUnzip_));
 
       fileIterLastOpened_ = fileIter_;
       indexesIntoFiles_[currentIndexIntoFile] = rootFile_->indexIntoFileSharedPtr();
@@ -752,6 +768,13 @@ namespace edm {
         ->setComment("Size of ROOT TTree prefetch cache.  Affects performance.");
     desc.addUntracked<int>("treeMaxVirtualSize", -1)
         ->setComment("Size of ROOT TTree TBasket cache.  Affects performance.");
+    desc.addUntracked<unsigned int>("basketReadAheadSize", 0U)
+        ->setComment("If non-zero, at most this many bytes of the baskets of the next cluster of events\n"
+                     "are prefetched by the storage layer while the current one is processed.\n"
+                     "Only used by the primary source.");
+    desc.addUntracked<bool>("parallelUnzip", false)
+        ->setComment("If True, the baskets of the events in the TTreeCache are unzipped on helper threads\n"
+                     "before the products are read. Uses more memory. Only used by the primary source.");
     desc.addUntracked<unsigned int>("setRunNumber", 0U)
         ->setComment("If non-zero, change number of first run to this number. Apply same offset to all runs.  Allowed only for simulation.");
     desc.addUntracked<bool>("dropDescendantsOfDroppedBranches", true)
@@ -767,6 +790,10 @@ namespace edm {
         ->setComment("If True: replace module label for raw data to match MC. Also use 'LHC' as process.");
 
     ProductSelectorRules::fillDescription(desc, "inputCommands");
+    desc.addUntracked<std::vector<std::string> >("recycleCommands", std::vector<std::string>(1U, std::string("drop *")))
+        ->setComment("Selects, like 'inputCommands', the event branches whose products are read into the products of\n"
+                     "an earlier event once no event uses them anymore, instead of into newly allocated ones.\n"
+                     "Only select branches whose products keep no transient state, e.g. no edm::Ref or edm::Ptr.");
     EventSkipperByID::fillDescription(desc);
     DuplicateChecker::fillDescription(desc);
   }
@@ -107,8 +107,11 @@ namespace edm {
     bool skipBadFiles_;
     unsigned int treeCacheSize_;
     int const treeMaxVirtualSize_;
+    unsigned int const basketReadAheadSize_;
+    bool const parallelUnzip_;
     RunNumber_t setRun_;
     ProductSelectorRules productSelectorRules_;
+    ProductSelectorRules recycleSelectorRules_;
     boost::shared_ptr<DuplicateChecker> duplicateChecker_;
     bool dropDescendants_;
     bool labelRawDataLikeMC_;
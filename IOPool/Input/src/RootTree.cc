@@ -1,13 +1,19 @@
 #include "RootTree.h"
+#include "ProductRecycler.h"
 #include "RootDelayedReader.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/Utilities/interface/EDMException.h"
 #include "FWCore/Utilities/interface/Exception.h"
+#include "FWCore/Utilities/interface/GlobalMutex.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "InputFile.h"
+#include "TROOT.h"
 #include "TTree.h"
 #include "TTreeIndex.h"
 #include "TTreeCache.h"
+#include "TTreeCacheUnzip.h"
 
+#include <algorithm>
 #include <iostream>
 
 namespace edm {
@@ -23,13 +29,34 @@ namespace edm {
       TBranch* branch = tree->GetBranch(BranchTypeToBranchEntryInfoBranchName(branchType).c_str());
       return branch;
     }
+    typedef std::pair<Long64_t, Long64_t> BasketRange; // offset and size in the file
+    // The baskets of a branch and of its sub-branches which hold entries in [begin, end).
+    void addBasketRanges(TBranch* branch, Long64_t begin, Long64_t end, std::vector<BasketRange>& ranges) {
+      Int_t const nBaskets = branch->GetWriteBasket();
+      Long64_t const* basketEntry = branch->GetBasketEntry();
+      Int_t const* basketBytes = branch->GetBasketBytes();
+      if(nBaskets > 0 && basketEntry != 0 && basketBytes != 0) {
+        Int_t basket = std::upper_bound(basketEntry, basketEntry + nBaskets, begin) - basketEntry;
+        for(basket = std::max(basket - 1, 0); basket < nBaskets && basketEntry[basket] < end; ++basket) {
+          Long64_t const seek = branch->GetBasketSeek(basket);
+          if(seek > 0 && basketBytes[basket] > 0) {
+            ranges.push_back(BasketRange(seek, basketBytes[basket]));
+          }
+        }
+      }
+      TObjArray* subBranches = branch->GetListOfBranches();
+      for(Int_t i = 0, n = subBranches->GetEntriesFast(); i < n; ++i) {
+        addBasketRanges(static_cast<TBranch*>(subBranches->UncheckedAt(i)), begin, end, ranges);
+      }
+    }
   }
   RootTree::RootTree(boost::shared_ptr<InputFile> filePtr,
                      BranchType const& branchType,
                      unsigned int maxVirtualSize,
                      unsigned int cacheSize,
                      unsigned int learningEntries,
-                     bool enablePrefetching) :
+                     bool enablePrefetching,
+                     bool enableParallelUnzip) :
     filePtr_(filePtr),
     tree_(dynamic_cast<TTree*>(filePtr_.get() != 0 ? filePtr_->Get(BranchTypeToProductTreeName(branchType).c_str()) : 0)),
     metaTree_(dynamic_cast<TTree*>(filePtr_.get() != 0 ? filePtr_->Get(BranchTypeToMetaDataTreeName(branchType).c_str()) : 0)),
@@ -52,8 +79,14 @@ namespace edm {
     cacheSize_(cacheSize),
     treeAutoFlush_(tree_ ? tree_->GetAutoFlush() : 0),
     enablePrefetching_(enablePrefetching),
+    enableParallelUnzip_(enableParallelUnzip),
     enableTriggerCache_(branchType_ == InEvent),
     rootDelayedReader_(new RootDelayedReader(*this, filePtr)),
+    readAheadSize_(0U),
+    bytesReadAhead_(0),
+    clusterBegin_(-1),
+    clusterEnd_(-1),
+    readAheadFrom_(-1),
     branchEntryInfoBranch_(metaTree_ ? getProductProvenanceBranch(metaTree_, branchType_) : (tree_ ? getProductProvenanceBranch(tree_, branchType_) : 0)),
     infoTree_(dynamic_cast<TTree*>(filePtr_.get() != 0 ? filePtr->Get(BranchTypeToInfoTreeName(branchType).c_str()) : 0)) // backward compatibility
     {
@@ -110,7 +143,8 @@ namespace edm {
   void
   RootTree::addBranch(BranchKey const& key,
                       BranchDescription const& prod,
-                      std::string const& oldBranchName) {
+                      std::string const& oldBranchName,
+                      bool recycleProducts) {
       assert(isValid());
       prod.init();
       //use the translated branch name
@@ -121,6 +155,10 @@ namespace edm {
         info.productBranch_ = branch;
         //we want the new branch name for the JobReport
         branchNames_.push_back(prod.branchName());
+        if (recycleProducts) {
+          info.classCache_ = gROOT->GetClass(prod.wrappedName().c_str());
+          info.recycler_.reset(new ProductRecycler(info.classCache_));
+        }
       }
       TTree* provTree = (metaTree_ != 0 ? metaTree_ : tree_);
       info.provenanceBranch_ = provTree->GetBranch(oldBranchName.c_str());
@@ -156,7 +194,16 @@ namespace edm {
   void
   RootTree::setCacheSize(unsigned int cacheSize) {
     cacheSize_ = cacheSize;
-    tree_->SetCacheSize(static_cast<Long64_t>(cacheSize));
+    // The choice between a TTreeCache and a TTreeCacheUnzip is global in ROOT,
+    // so it is only changed while the cache of this tree is created, and under
+    // the I/O mutex so no other file opened meanwhile sees it.
+    {
+      boost::recursive_mutex::scoped_lock lock(*rootfix::getIOMutex());
+      bool const parallelUnzip = TTreeCacheUnzip::IsParallelUnzip();
+      TTreeCacheUnzip::SetParallelUnzip(enableParallelUnzip_ ? TTreeCacheUnzip::kEnable : TTreeCacheUnzip::kDisable);
+      tree_->SetCacheSize(static_cast<Long64_t>(cacheSize));
+      TTreeCacheUnzip::SetParallelUnzip(parallelUnzip ? TTreeCacheUnzip::kEnable : TTreeCacheUnzip::kDisable);
+    }
     treeCache_.reset(dynamic_cast<TTreeCache*>(filePtr_->GetCacheRead()));
     if(treeCache_) treeCache_->SetEnablePrefetching(enablePrefetching_);
     filePtr_->SetCacheRead(0);
@@ -196,6 +243,61 @@ namespace edm {
     if (treeCache_ && treeCache_->IsLearning() && switchOverEntry_ >= 0 && entryNumber_ >= switchOverEntry_) {
       stopTraining();
     }
+    if (readAheadSize_ != 0U && entryNumber_ >= 0 && !inCurrentCluster(entryNumber_)) {
+      setCluster();
+    }
+  }
+
+  void
+  RootTree::setCluster() {
+    TTree::TClusterIterator clusterIter = tree_->GetClusterIterator(entryNumber_);
+    clusterBegin_ = clusterIter();
+    clusterEnd_ = clusterIter.GetNextEntry();
+  }
+
+  void
+  RootTree::readAhead(EntryNumber entry) {
+    readAheadFrom_ = clusterBegin_;
+    if (entry < 0 || entry >= entries_) {
+      return;
+    }
+    TTree::TClusterIterator clusterIter = tree_->GetClusterIterator(entry);
+    EntryNumber const begin = clusterIter();
+    EntryNumber const end = clusterIter.GetNextEntry();
+    std::vector<BasketRange> ranges;
+    addBasketRanges(auxBranch_, begin, end, ranges);
+    for (std::unordered_set<TBranch*>::const_iterator it = trainedSet_.begin(), itEnd = trainedSet_.end(); it != itEnd; ++it) {
+      addBasketRanges(*it, begin, end, ranges);
+    }
+    // Merge adjacent baskets, and keep to the bytes allowed in file order.
+    std::sort(ranges.begin(), ranges.end());
+    std::vector<BasketRange> merged;
+    merged.reserve(ranges.size());
+    Long64_t bytes = 0;
+    for (std::vector<BasketRange>::const_iterator it = ranges.begin(), itEnd = ranges.end(); it != itEnd && bytes < readAheadSize_; ++it) {
+      bool const adjacent = !merged.empty() && merged.back().first + merged.back().second >= it->first;
+      Long64_t const rangeBegin = adjacent ? merged.back().first + merged.back().second : it->first;
+      Long64_t const rangeEnd = std::min(it->first + it->second, rangeBegin + readAheadSize_ - bytes);
+      if (rangeEnd <= rangeBegin) {
+        continue;
+      }
+      bytes += rangeEnd - rangeBegin;
+      if (adjacent) {
+        merged.back().second = rangeEnd - merged.back().first;
+      } else {
+        merged.push_back(BasketRange(rangeBegin, rangeEnd - rangeBegin));
+      }
+    }
+    // The storage layer reads the ranges in the background, or has the system do so for a
+    // local file, while the current cluster is processed. The source holds the I/O mutex.
+    for (std::vector<BasketRange>::const_iterator it = merged.begin(), itEnd = merged.end(); it != itEnd; ++it) {
+      if (filePtr_->ReadBufferAsync(it->first, it->second)) {
+        LogInfo("BasketReadAhead") << "Not reading ahead in file " << filePtr_->fileName() << " since its storage does not prefetch";
+        readAheadSize_ = 0U;
+        return;
+      }
+      bytesReadAhead_ += it->second;
+    }
   }
 
   // The actual implementation is done below; it's split in this strange
@@ -388,6 +490,13 @@ namespace edm {
 
   void
   RootTree::close () {
+    if (bytesReadAhead_ != 0) {
+      LogInfo("BasketReadAhead") << "Prefetched " << bytesReadAhead_ << " bytes ahead in file " << filePtr_->fileName();
+    }
+    TTreeCacheUnzip* unzipCache = dynamic_cast<TTreeCacheUnzip*>(treeCache_.get());
+    if (unzipCache != 0) {
+      LogInfo("ParallelUnzip") << "Unzipped " << unzipCache->GetNUnzip() << " baskets on helper threads in file " << filePtr_->fileName();
+    }
     // The TFile is about to be closed, and destructed.
     // Just to play it safe, zero all pointers to quantities that are owned by the TFile.
     auxBranch_  = branchEntryInfoBranch_ = 0;
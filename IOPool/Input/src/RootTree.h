@@ -14,6 +14,8 @@ RootTree.h // used by ROOT input sources
 #include "Rtypes.h"
 #include "TBranch.h"
 
+#include "boost/shared_ptr.hpp"
+
 #include <map>
 #include <memory>
 #include <string>
@@ -29,6 +31,7 @@ namespace edm {
   struct BranchKey;
   class DelayedReader;
   class InputFile;
+  class ProductRecycler;
   class RootTree;
 
   namespace roottree {
@@ -42,11 +45,13 @@ namespace edm {
         branchDescription_(prod),
         productBranch_(0),
         provenanceBranch_(0),
-        classCache_(0) {}
+        classCache_(0),
+        recycler_() {}
       ConstBranchDescription branchDescription_;
       TBranch* productBranch_;
       TBranch* provenanceBranch_; // For backward compatibility
       mutable TClass* classCache_;
+      boost::shared_ptr<ProductRecycler> recycler_; // null unless the products are recycled
     };
     typedef std::map<BranchKey const, BranchInfo> BranchMap;
     Int_t getEntry(TBranch* branch, EntryNumber entryNumber);
@@ -63,7 +68,8 @@ namespace edm {
              unsigned int maxVirtualSize,
              unsigned int cacheSize,
              unsigned int learningEntries,
-             bool enablePrefetching);
+             bool enablePrefetching,
+             bool enableParallelUnzip);
     ~RootTree();
 
     RootTree(RootTree const&) = delete; // Disallow copying and moving
@@ -72,7 +78,8 @@ namespace edm {
     bool isValid() const;
     void addBranch(BranchKey const& key,
                    BranchDescription const& prod,
-                   std::string const& oldBranchName);
+                   std::string const& oldBranchName,
+                   bool recycleProducts = false);
     void dropBranch(std::string const& oldBranchName);
     void getEntry(TBranch *branch, EntryNumber entry) const;
     void setPresence(BranchDescription const& prod,
@@ -124,12 +131,22 @@ namespace edm {
     void trainCache(char const* branchNames);
     void resetTraining() {trainNow_ = true;}
 
+    // Has the storage layer prefetch at most maxSize bytes of the baskets of the next cluster.
+    void enableReadAhead(unsigned int maxSize) {readAheadSize_ = maxSize;}
+    // True if reading ahead and nothing was read ahead since the current cluster was entered.
+    bool readAheadWanted() const {return readAheadSize_ != 0U && readAheadFrom_ != clusterBegin_;}
+    bool inCurrentCluster(EntryNumber entry) const {return entry >= clusterBegin_ && entry < clusterEnd_;}
+    // Prefetches the baskets of the trained branches in the cluster holding entry, which
+    // is the next one to be read outside of the current cluster, or -1 if there is none.
+    void readAhead(EntryNumber entry);
+
     BranchType branchType() const {return branchType_;}
   private:
     void setCacheSize(unsigned int cacheSize);
     void setTreeMaxVirtualSize(int treeMaxVirtualSize);
     void startTraining();
     void stopTraining();
+    void setCluster();
 
     boost::shared_ptr<InputFile> filePtr_;
 // We use bare pointers for pointers to some ROOT entities.
@@ -162,8 +179,16 @@ namespace edm {
 // Enable asynchronous I/O in ROOT (done in a separate thread).  Only takes
 // effect on the primary treeCache_; all other caches have this explicitly disabled.
     bool enablePrefetching_;
+// Let ROOT unzip the baskets of the cluster held by the primary treeCache_ on helper threads,
+// so that GetEntry only has to deserialize. The other caches never do this.
+    bool enableParallelUnzip_;
     bool enableTriggerCache_;
     std::unique_ptr<DelayedReader> rootDelayedReader_;
+    unsigned int readAheadSize_; // 0 if not reading ahead
+    Long64_t bytesReadAhead_;
+    EntryNumber clusterBegin_;
+    EntryNumber clusterEnd_;
+    EntryNumber readAheadFrom_; // first entry of the cluster from which the last read ahead was requested
 
     TBranch* branchEntryInfoBranch_; //backwards compatibility
     // below for backward compatibility
@@ -0,0 +1,39 @@
+# Configuration file for PoolInputParallelUnzipTest
+# Reads the file of PrePoolInputReadAheadTest, which has many clusters,
+# with the baskets in the TTreeCache unzipped on helper threads. The number
+# of baskets unzipped is written to PoolInputParallelUnzipTest.log, which
+# TestPoolInput.sh checks.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring('PoolInputParallelUnzipTest'),
+    categories = cms.untracked.vstring('ParallelUnzip'),
+    PoolInputParallelUnzipTest = cms.untracked.PSet(
+        threshold = cms.untracked.string('INFO'),
+        noTimeStamps = cms.untracked.bool(True),
+        default = cms.untracked.PSet(limit = cms.untracked.int32(0)),
+        ParallelUnzip = cms.untracked.PSet(limit = cms.untracked.int32(-1))
+    )
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring('file:PoolInputReadAheadTest.root'),
+    parallelUnzip = cms.untracked.bool(True)
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
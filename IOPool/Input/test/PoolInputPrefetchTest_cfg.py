@@ -0,0 +1,31 @@
+# Configuration file for PoolInputPrefetchTest
+# Same as PoolInputTest but the products read by OtherThing are read
+# ahead in the background
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.options.numberOfThreads = cms.untracked.uint32(2)
+process.options.prefetchProducts = cms.untracked.bool(True)
+
+process.OtherThing = cms.EDProducer("OtherThingProducer",
+    debugLevel = cms.untracked.int32(1),
+    mightGet = cms.untracked.vstring('edmtestThings_Thing__TESTPROD')
+)
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    setRunNumber = cms.untracked.uint32(621),
+    fileNames = cms.untracked.vstring('file:PoolInputTest.root', 
+        'file:PoolInputOther.root')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
@@ -0,0 +1,38 @@
+# Configuration file for PoolInputReadAheadTest
+# Reads the file of PrePoolInputReadAheadTest with the baskets of the
+# next cluster prefetched by the storage layer. The number of bytes read ahead
+# is written to PoolInputReadAheadTest.log, which TestPoolInput.sh checks.
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.MessageLogger = cms.Service("MessageLogger",
+    destinations = cms.untracked.vstring('PoolInputReadAheadTest'),
+    categories = cms.untracked.vstring('BasketReadAhead'),
+    PoolInputReadAheadTest = cms.untracked.PSet(
+        threshold = cms.untracked.string('INFO'),
+        noTimeStamps = cms.untracked.bool(True),
+        default = cms.untracked.PSet(limit = cms.untracked.int32(0)),
+        BasketReadAhead = cms.untracked.PSet(limit = cms.untracked.int32(-1))
+    )
+)
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring('file:PoolInputReadAheadTest.root'),
+    basketReadAheadSize = cms.untracked.uint32(1024*1024)
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
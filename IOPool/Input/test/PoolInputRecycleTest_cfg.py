@@ -0,0 +1,28 @@
+# Configuration file for PoolInputRecycleTest
+# Same as PoolInputTest but each event's Things are read into
+# the Things of an earlier event
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTRECO")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.OtherThing = cms.EDProducer("OtherThingProducer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.Analysis = cms.EDAnalyzer("OtherThingAnalyzer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.source = cms.Source("PoolSource",
+    setRunNumber = cms.untracked.uint32(621),
+    fileNames = cms.untracked.vstring('file:PoolInputTest.root', 
+        'file:PoolInputOther.root'),
+    recycleCommands = cms.untracked.vstring('drop *', 'keep *_Thing_*_*')
+)
+
+process.p = cms.Path(process.OtherThing*process.Analysis)
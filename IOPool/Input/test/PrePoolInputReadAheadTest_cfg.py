@@ -0,0 +1,25 @@
+# Configuration file for PrePoolInputReadAheadTest
+# Writes a file with many small clusters of events for PoolInputReadAheadTest
+
+import FWCore.ParameterSet.Config as cms
+
+process = cms.Process("TESTPROD")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(1000)
+)
+process.Thing = cms.EDProducer("ThingProducer",
+    debugLevel = cms.untracked.int32(1)
+)
+
+process.output = cms.OutputModule("PoolOutputModule",
+    fileName = cms.untracked.string('PoolInputReadAheadTest.root'),
+    basketSize = cms.untracked.int32(1024),
+    eventAutoFlushCompressedSize = cms.untracked.int32(1024)
+)
+
+process.source = cms.Source("EmptySource")
+
+process.p = cms.Path(process.Thing)
+process.ep = cms.EndPath(process.output)
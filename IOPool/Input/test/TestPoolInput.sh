@@ -10,6 +10,18 @@ cp PoolInputTest.root PoolInputOther.root
 
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputTest_cfg.py || die 'Failure using PoolInputTest_cfg.py' $?
 
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputPrefetchTest_cfg.py || die 'Failure using PoolInputPrefetchTest_cfg.py' $?
+
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputRecycleTest_cfg.py || die 'Failure using PoolInputRecycleTest_cfg.py' $?
+
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PrePoolInputReadAheadTest_cfg.py || die 'Failure using PrePoolInputReadAheadTest_cfg.py' $?
+
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputReadAheadTest_cfg.py || die 'Failure using PoolInputReadAheadTest_cfg.py' $?
+grep -q 'Prefetched [1-9][0-9]* bytes ahead' PoolInputReadAheadTest.log || die 'No bytes read ahead by PoolInputReadAheadTest_cfg.py' 1
+
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolInputParallelUnzipTest_cfg.py || die 'Failure using PoolInputParallelUnzipTest_cfg.py' $?
+grep -q 'Unzipped [1-9][0-9]* baskets on helper threads' PoolInputParallelUnzipTest.log || die 'No baskets unzipped on helper threads by PoolInputParallelUnzipTest_cfg.py' 1
+
 cmsRun ${LOCAL_TEST_DIR}/PrePool2FileInputTest_cfg.py || die 'Failure using PrePool2FileInputTest_cfg.py' $?
 cmsRun ${LOCAL_TEST_DIR}/Pool2FileInputTest_cfg.py || die 'Failure using Pool2FileInputTest_cfg.py' $?
 
@@ -108,6 +108,7 @@ namespace edm {
     virtual void writeLuminosityBlock(LuminosityBlockPrincipal const& lb);
     virtual void writeRun(RunPrincipal const& r);
     virtual void postForkReacquireResources(unsigned int iChildIndex, unsigned int iNumberOfChildren);
+    virtual void mergeForkedChildrenOutputs(unsigned int iNumberOfChildren);
     virtual bool isFileOpen() const;
     virtual void doOpenFile();
     virtual void beginJob();
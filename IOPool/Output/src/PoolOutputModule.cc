@@ -4,16 +4,21 @@
 #include "IOPool/Output/src/RootOutputFile.h"
 
 #include "FWCore/Framework/interface/EventPrincipal.h"
+#include "FWCore/Framework/interface/EventProcessor.h"
 #include "FWCore/Framework/interface/LuminosityBlockPrincipal.h"
 #include "FWCore/Framework/interface/RunPrincipal.h"
 #include "FWCore/Framework/interface/FileBlock.h"
 #include "FWCore/ParameterSet/interface/ParameterSet.h"
 #include "FWCore/ParameterSet/interface/ConfigurationDescriptions.h"
 #include "FWCore/ParameterSet/interface/ParameterSetDescription.h"
+#include "FWCore/ParameterSet/interface/ProcessDesc.h"
+#include "FWCore/MessageLogger/interface/MessageLogger.h"
 #include "FWCore/ServiceRegistry/interface/Service.h"
+#include "FWCore/ServiceRegistry/interface/ServiceRegistry.h"
 #include "DataFormats/Provenance/interface/BranchDescription.h"
 #include "FWCore/Utilities/interface/Algorithms.h"
 #include "FWCore/Utilities/interface/EDMException.h"
+#include "FWCore/Utilities/interface/RootHandlers.h"
 #include "FWCore/Utilities/interface/DictionaryTools.h"
 #include "FWCore/Utilities/interface/TimeOfDay.h"
 #include "FWCore/Utilities/interface/WrappedClassName.h"
@@ -23,11 +28,79 @@
 #include "TObjArray.h"
 #include "RVersion.h"
 
+#include <cstdio>
 #include <fstream>
 #include <iomanip>
 #include <sstream>
 
+#include <sys/stat.h>
+
 namespace edm {
+  namespace {
+    unsigned int numberOfDigitsInChildIndex(unsigned int iNumberOfChildren) {
+      unsigned int numberOfDigits = 0U;
+      while (iNumberOfChildren != 0) {
+        ++numberOfDigits;
+        iNumberOfChildren /= 10;
+      }
+      return numberOfDigits == 0U ? 3U : numberOfDigits; // Protect against zero iNumberOfChildren
+    }
+
+    // The name of the file number iFileCount written by a child process (no child index
+    // if iNumberOfDigitsInIndex is 0), as made from the fileName parameter.
+    std::string outputFileName(std::string const& iFileName, unsigned int iNumberOfDigitsInIndex, unsigned int iChildIndex, int iFileCount) {
+      std::string suffix(".root");
+      std::string::size_type offset = iFileName.rfind(suffix);
+      bool ext = (offset == iFileName.size() - suffix.size());
+      if(!ext) suffix.clear();
+      std::string fileBase(ext ? iFileName.substr(0, offset) : iFileName);
+      std::ostringstream ofilename;
+      ofilename << fileBase;
+      if(iNumberOfDigitsInIndex) {
+        ofilename << '_' << std::setw(iNumberOfDigitsInIndex) << std::setfill('0') << iChildIndex;
+      }
+      if(iFileCount) {
+        ofilename << std::setw(3) << std::setfill('0') << iFileCount;
+      }
+      ofilename << suffix;
+      return ofilename.str();
+    }
+
+    // The path of a local file, or an empty string if the name is for some other protocol.
+    std::string localPath(std::string const& iFileName) {
+      std::string const filePrefix("file:");
+      if(iFileName.compare(0, filePrefix.size(), filePrefix) == 0) {
+        return iFileName.substr(filePrefix.size());
+      }
+      return iFileName.find(':') == std::string::npos ? iFileName : std::string();
+    }
+
+    // The configuration of the output module of the merge job. The children already
+    // selected the events and the products they wrote, so the merge keeps all of them.
+    ParameterSet mergeOutputParameterSet(ParameterSet const& iPSet) {
+      ParameterSet pset;
+      pset.copyForModify(iPSet);
+      pset.addUntrackedParameter<ParameterSet>("SelectEvents", ParameterSet());
+      pset.addUntrackedParameter<std::vector<std::string> >("outputCommands", std::vector<std::string>(1U, std::string("keep *")));
+      // What the children made comes from a prior process in the merge job
+      if(pset.getUntrackedParameter<std::string>("dropMetaData", std::string()) == std::string("PRIOR")) {
+        pset.addUntrackedParameter<std::string>("dropMetaData", std::string("DROPPED"));
+      }
+      return pset;
+    }
+
+    // Lets the merge job use the ROOT error handling of the job without sharing its other services.
+    class ParentRootHandlers : public RootHandlers {
+    public:
+      explicit ParentRootHandlers(RootHandlers& iParent) : parent_(iParent) {}
+    private:
+      virtual void disableErrorHandler_() {parent_.disableErrorHandler();}
+      virtual void enableErrorHandler_() {parent_.enableErrorHandler();}
+      virtual void enableErrorHandlerWithoutWarnings_() {parent_.enableErrorHandlerWithoutWarnings();}
+      RootHandlers& parent_;
+    };
+  }
+
   PoolOutputModule::PoolOutputModule(ParameterSet const& pset) :
     OutputModule(pset),
     rootServiceChecker_(),
@@ -227,12 +300,88 @@ namespace edm {
 
   void PoolOutputModule::postForkReacquireResources(unsigned int iChildIndex, unsigned int iNumberOfChildren) {
     childIndex_ = iChildIndex;
-    while (iNumberOfChildren != 0) {
-      ++numberOfDigitsInIndex_;
-      iNumberOfChildren /= 10;
+    numberOfDigitsInIndex_ = numberOfDigitsInChildIndex(iNumberOfChildren);
+  }
+
+  void PoolOutputModule::mergeForkedChildrenOutputs(unsigned int iNumberOfChildren) {
+    // The children wrote their files in the order they were given the events, so the
+    // files are read back child after child and the file number within a child.
+    unsigned int const numberOfDigits = numberOfDigitsInChildIndex(iNumberOfChildren);
+    std::vector<std::string> childFiles;
+    for(unsigned int child = 0; child != iNumberOfChildren; ++child) {
+      for(int fileCount = 0; ; ++fileCount) {
+        std::string const name = localPath(outputFileName(fileName(), numberOfDigits, child, fileCount));
+        struct stat fileStat;
+        if(name.empty() || 0 != stat(name.c_str(), &fileStat)) break;
+        childFiles.push_back(name);
+      }
     }
-    if (numberOfDigitsInIndex_ == 0) {
-      numberOfDigitsInIndex_ = 3; // Protect against zero iNumberOfChildren
+    if(childFiles.empty()) {
+      LogWarning("PoolOutputModule") << "Module '" << moduleLabel_ << "' found no local output file of the children to merge into "
+                                     << fileName() << ".\n";
+      return;
+    }
+
+    // The merge is a copy job run in this process: the products are fast cloned and the
+    // IndexIntoFile, provenance and registries of the files are combined as in any copy job.
+    std::vector<std::string> const noLabels;
+    boost::shared_ptr<ParameterSet> processPSet(new ParameterSet);
+    // The merge job has the name of this process. It produces nothing, so it adds no
+    // process to the ProcessHistory and the merged file has the history of the children.
+    processPSet->addParameter<std::string>("@process_name", processName());
+
+    std::vector<std::string> fileNames;
+    for(std::vector<std::string>::const_iterator it = childFiles.begin(), itEnd = childFiles.end(); it != itEnd; ++it) {
+      fileNames.push_back("file:" + *it);
+    }
+    ParameterSet source;
+    source.addParameter<std::string>("@module_label", "@main_input");
+    source.addParameter<std::string>("@module_type", "PoolSource");
+    source.addParameter<std::string>("@module_edm_type", "Source");
+    source.addUntrackedParameter<std::vector<std::string> >("fileNames", fileNames);
+    source.addUntrackedParameter<std::string>("duplicateCheckMode", "noDuplicateCheck");
+    processPSet->addParameter<ParameterSet>("@main_input", source);
+    processPSet->addParameter<std::vector<std::string> >("@all_sources", std::vector<std::string>(1U, std::string("@main_input")));
+
+    processPSet->addParameter<ParameterSet>(moduleLabel_, mergeOutputParameterSet(getParameterSet(description().parameterSetID())));
+    processPSet->addParameter<std::vector<std::string> >("@all_modules", std::vector<std::string>(1U, moduleLabel_));
+    processPSet->addParameter<std::vector<std::string> >("e", std::vector<std::string>(1U, moduleLabel_));
+    processPSet->addParameter<std::vector<std::string> >("@paths", std::vector<std::string>(1U, std::string("e")));
+    processPSet->addParameter<std::vector<std::string> >("@end_paths", std::vector<std::string>(1U, std::string("e")));
+    ParameterSet triggerPaths;
+    triggerPaths.addParameter<std::vector<std::string> >("@trigger_paths", noLabels);
+    processPSet->addParameter<ParameterSet>("@trigger_paths", triggerPaths);
+    processPSet->addUntrackedParameter<std::vector<std::string> >("@filters_on_endpaths", noLabels);
+
+    processPSet->addParameter<std::vector<std::string> >("@all_loopers", noLabels);
+    processPSet->addUntrackedParameter<std::vector<std::string> >("@all_subprocesses", noLabels);
+    processPSet->addParameter<std::vector<std::string> >("@all_esmodules", noLabels);
+    processPSet->addParameter<std::vector<std::string> >("@all_essources", noLabels);
+    processPSet->addParameter<std::vector<std::string> >("@all_esprefers", noLabels);
+    processPSet->addParameter<std::vector<std::string> >("@all_aliases", noLabels);
+    processPSet->addUntrackedParameter<std::vector<ParameterSet> >("services", std::vector<ParameterSet>());
+    boost::shared_ptr<ProcessDesc> processDesc(new ProcessDesc(processPSet));
+
+    // The merge job has services of its own, so the services of this job see none of its
+    // transitions. Its job report, which lists the merged file with the files of the children
+    // as inputs, is added to the job report of this job once the merge job is gone.
+    LogSystem("PoolOutputModule") << "Module '" << moduleLabel_ << "' merging " << childFiles.size()
+                                  << " files of the children into " << fileName();
+    Service<JobReport> reportSvc;
+    std::ostringstream mergeReport;
+    {
+      Service<RootHandlers> rootHandlers;
+      ServiceToken token(ServiceRegistry::createContaining(std::auto_ptr<JobReport>(new JobReport(&mergeReport))));
+      token = ServiceRegistry::createContaining(std::auto_ptr<RootHandlers>(new ParentRootHandlers(*rootHandlers)),
+                                                token, serviceregistry::kOverlapIsError);
+      EventProcessor merger(processDesc, token, serviceregistry::kOverlapIsError);
+      merger.beginJob();
+      merger.run();
+      merger.endJob();
+    }
+    reportSvc->parentAddReport(mergeReport.str());
+    for(std::vector<std::string>::const_iterator it = childFiles.begin(), itEnd = childFiles.end(); it != itEnd; ++it) {
+      std::remove(it->c_str());
     }
   }
 
@@ -284,29 +433,17 @@ namespace edm {
           << "Attempt to open output file before input file. "
           << "Please report this to the core framework developers.\n";
       }
-      std::string suffix(".root");
-      std::string::size_type offset = fileName().rfind(suffix);
-      bool ext = (offset == fileName().size() - suffix.size());
-      if(!ext) suffix.clear();
-      std::string fileBase(ext ? fileName().substr(0, offset) : fileName());
-      std::ostringstream ofilename;
       std::ostringstream lfilename;
-      ofilename << fileBase;
       lfilename << logicalFileName();
-      if(numberOfDigitsInIndex_) {
-        ofilename << '_' << std::setw(numberOfDigitsInIndex_) << std::setfill('0') << childIndex_;
-        if(!logicalFileName().empty()) {
+      if(!logicalFileName().empty()) {
+        if(numberOfDigitsInIndex_) {
           lfilename << '_' << std::setw(numberOfDigitsInIndex_) << std::setfill('0') << childIndex_;
         }
-      }
-      if(outputFileCount_) {
-        ofilename << std::setw(3) << std::setfill('0') << outputFileCount_;
-        if(!logicalFileName().empty()) {
+        if(outputFileCount_) {
           lfilename << std::setw(3) << std::setfill('0') << outputFileCount_;
         }
       }
-      ofilename << suffix;
-      rootOutputFile_.reset(new RootOutputFile(this, ofilename.str(), lfilename.str()));
+      rootOutputFile_.reset(new RootOutputFile(this, outputFileName(fileName(), numberOfDigitsInIndex_, childIndex_, outputFileCount_), lfilename.str()));
       ++outputFileCount_;
   }
 
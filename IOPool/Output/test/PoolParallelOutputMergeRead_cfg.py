@@ -0,0 +1,38 @@
+import FWCore.ParameterSet.Config as cms
+import os
+
+process = cms.Process("TESTOUTPUTREAD")
+process.load("FWCore.Framework.test.cmsExceptionsFatal_cff")
+
+process.maxEvents = cms.untracked.PSet(
+    input = cms.untracked.int32(-1)
+)
+process.source = cms.Source("PoolSource",
+    fileNames = cms.untracked.vstring('file:PoolOutputMerged.root')
+)
+
+process.analyzeOther = cms.EDAnalyzer("OtherThingAnalyzer")
+
+# PoolParallelOutputMergeTest_cfg.py gave the 20 events of run 1 in turn to 3 children,
+# 2 at a time, and the files of the children are merged child after child
+numberOfChildren = 3
+numberOfSequentialEvents = 2
+ids = cms.VEventID()
+for child in xrange(numberOfChildren):
+    for i in xrange(20):
+        if (i/numberOfSequentialEvents) % numberOfChildren == child:
+            ids.append(cms.EventID(1, i + 1))
+process.check = cms.EDAnalyzer("EventIDChecker", eventSequence = cms.untracked(ids))
+
+# The merge adds no process to the history, so the one of this process follows the one
+# of the process which wrote the file. Producing something adds this process to it.
+process.Thing = cms.EDProducer("ThingProducer")
+process.testmerge = cms.EDAnalyzer("TestMergeResults",
+    expectedProcessHistoryInRuns = cms.untracked.vstring('TESTOUTPUT', 'TESTOUTPUTREAD')
+)
+
+process.p = cms.Path(process.analyzeOther*process.check*process.Thing*process.testmerge)
+
+# the files of the children are removed once they are merged
+if [x for x in os.listdir('.') if x.startswith('PoolOutputMerged_')]:
+    raise Exception("the output files of the children were not removed after the merge")
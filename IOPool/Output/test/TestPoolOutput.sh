@@ -24,6 +24,14 @@ cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolParallelOutputTest_cfg.py || die 'F
 
 cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolParallelOutputRead_cfg.py || die 'Failure using PoolParallelOutputRead_cfg.py' $?
 
+cmsRun -j PoolParallelOutputMerge.xml --parameter-set ${LOCAL_TEST_DIR}/PoolParallelOutputMergeTest_cfg.py || die 'Failure using PoolParallelOutputMergeTest_cfg.py' $?
+# the job report lists the merged file, its 20 events and the files of the 3 children as its inputs
+grep -q '<PFN>file:PoolOutputMerged.root</PFN>' PoolParallelOutputMerge.xml || die 'Merged file not in the job report of PoolParallelOutputMergeTest_cfg.py' 1
+grep -q '<TotalEvents>20</TotalEvents>' PoolParallelOutputMerge.xml || die 'Wrong number of merged events in the job report of PoolParallelOutputMergeTest_cfg.py' 1
+[ `grep -c '<PFN>file:PoolOutputMerged_[0-9]*.root</PFN>' PoolParallelOutputMerge.xml` -ge 3 ] || die 'Files of the children not in the job report of PoolParallelOutputMergeTest_cfg.py' 1
+
+cmsRun --parameter-set ${LOCAL_TEST_DIR}/PoolParallelOutputMergeRead_cfg.py || die 'Failure using PoolParallelOutputMergeRead_cfg.py' $?
+
 cmsRun ${LOCAL_TEST_DIR}/PoolOutputEmptyEventsTest_cfg.py || die 'Failure using PoolOutputEmptyEventsTest_cfg.py' $?
 #reads file from above and from PoolOutputTest_cfg.py
 cmsRun ${LOCAL_TEST_DIR}/PoolOutputMergeWithEmptyFile_cfg.py || die 'Failure using PoolOutputMergeWithEmptyFile_cfg.py' $? 